@@ -14,12 +14,15 @@
  * CONFIGURACIÓN:
  * - Velocidad: 115200 baudios (debe coincidir con main.cpp)
  * - Formato de salida: "TIPO,ID,VALOR\n"
+ * - Modo binario opcional: el host lo pide con "#BIN 1\n"
+ *   (formato en include/ProtocoloBinario.h del sistema principal)
  * 
  * FUNCIONAMIENTO:
  * 1. setup(): Inicializa comunicación serial
  * 2. loop(): Envía lecturas cada 2 segundos
  *    - 2 sensores de temperatura (T-001, T-002)
  *    - 2 sensores de presión (P-101, P-102)
+ *    En modo binario: una trama con las 4 lecturas cada 100 ms
  */
 
 // Condfiguracion global
@@ -33,6 +36,27 @@ const char* TEMP_SENSOR_2 = "T-002";
 const char* PRES_SENSOR_1 = "P-101";
 const char* PRES_SENSOR_2 = "P-102";
 
+// Protocolo binario (debe coincidir con ProtocoloBinario.h)
+
+#define VERSION_PROTOCOLO 1       // Versión más alta que entiende esta placa
+#define SINCRONIA_TRAMA 0xA5      // Primer byte de toda trama
+#define TRAMA_HOLA 1
+#define TRAMA_TABLA 2
+#define TRAMA_LECTURAS 3
+#define INTERVALO_BINARIO 100     // Milisegundos entre tramas de lecturas
+#define TRAMAS_ENTRE_TABLAS 50    // Cada cuántas tramas se repite la tabla de IDs
+
+bool modoBinario = false;         // true después de recibir "#BIN n"
+uint16_t secuencia = 0;           // Número de la próxima trama
+uint16_t tramasDesdeTabla = 0;
+char comando[16];                 // Línea recibida del host
+uint8_t largoComando = 0;
+
+// Tabla de IDs: el índice de cada sensor es su posición aquí
+const char* const SENSORES[] = {"T-001", "T-002", "P-101", "P-102"};
+const char TIPOS[] = {'T', 'T', 'P', 'P'};
+const uint8_t CANTIDAD_SENSORES = 4;
+
 // Funciones auxiliares
 
 /**
@@ -127,6 +151,149 @@ void enviarPresion(const char* sensorId) {
   Serial.println(" hPa");
 }
 
+// Protocolo binario
+
+/**
+ * @brief CRC-16/CCITT-FALSE, igual al del host
+ * @param datos Bytes a cubrir
+ * @param largo Cantidad de bytes
+ * @return CRC de 16 bits
+ *
+ * RAZÓN del cálculo bit a bit:
+ * Con tramas de menos de 60 bytes cada 100 ms no vale la pena
+ * gastar 512 bytes de RAM en una tabla.
+ */
+uint16_t calcularCrc16(const uint8_t* datos, uint16_t largo) {
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < largo; i++) {
+    crc ^= (uint16_t)datos[i] << 8;
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+/**
+ * @brief Envía una trama: 0xA5, tipo, secuencia, largo, carga y CRC
+ * @param tipo TRAMA_HOLA, TRAMA_TABLA o TRAMA_LECTURAS
+ * @param carga Bytes de la carga
+ * @param largo Bytes de la carga (máximo 255)
+ *
+ * NOTA: Todos los enteros van en little-endian, el orden del ESP32.
+ */
+void enviarTrama(uint8_t tipo, const uint8_t* carga, uint8_t largo) {
+  uint8_t trama[5 + 255 + 2];
+  trama[0] = SINCRONIA_TRAMA;
+  trama[1] = tipo;
+  trama[2] = secuencia & 0xFF;
+  trama[3] = secuencia >> 8;
+  trama[4] = largo;
+  memcpy(trama + 5, carga, largo);
+
+  uint16_t crc = calcularCrc16(trama + 1, 4 + largo);
+  trama[5 + largo] = crc & 0xFF;
+  trama[6 + largo] = crc >> 8;
+
+  Serial.write(trama, 7 + largo);  // Un solo write: sin texto intercalado
+  secuencia++;
+}
+
+/**
+ * @brief Anuncia qué índice corresponde a cada ID
+ *
+ * Se repite cada TRAMAS_ENTRE_TABLAS tramas, por si el host
+ * se conectó tarde o perdió la primera.
+ */
+void enviarTablaIds() {
+  uint8_t carga[255];
+  uint8_t largo = 0;
+  for (uint8_t i = 0; i < CANTIDAD_SENSORES; i++) {
+    uint8_t largoId = strlen(SENSORES[i]);
+    carga[largo++] = i;
+    carga[largo++] = TIPOS[i];
+    carga[largo++] = largoId;
+    memcpy(carga + largo, SENSORES[i], largoId);
+    largo += largoId;
+  }
+  enviarTrama(TRAMA_TABLA, carga, largo);
+  tramasDesdeTabla = 0;
+}
+
+/**
+ * @brief Escribe un valor de 4 bytes en little-endian
+ */
+void escribirU32(uint8_t* p, uint32_t valor) {
+  p[0] = valor & 0xFF;
+  p[1] = (valor >> 8) & 0xFF;
+  p[2] = (valor >> 16) & 0xFF;
+  p[3] = (valor >> 24) & 0xFF;
+}
+
+/**
+ * @brief Envía una lectura de cada sensor en una sola trama
+ *
+ * FORMATO de cada lectura: [índice][valor 4 bytes]
+ * - Temperatura: float IEEE-754 (los bits tal cual)
+ * - Presión: entero con signo
+ *
+ * COMPARACIÓN: "T,T-001,23.5\n" + "[ESP32] Enviado..." son ~50 bytes
+ * por lectura; aquí son 5 bytes más 7 de trama repartidos entre todas.
+ */
+void enviarLecturasBinarias() {
+  uint8_t carga[CANTIDAD_SENSORES * 5];
+  for (uint8_t i = 0; i < CANTIDAD_SENSORES; i++) {
+    uint32_t bits;
+    if (TIPOS[i] == 'T') {
+      float temp = generarTemperatura();
+      memcpy(&bits, &temp, sizeof(bits));
+    } else {
+      bits = (uint32_t)(int32_t)generarPresion();
+    }
+    carga[i * 5] = i;
+    escribirU32(carga + i * 5 + 1, bits);
+  }
+  enviarTrama(TRAMA_LECTURAS, carga, sizeof(carga));
+
+  if (++tramasDesdeTabla >= TRAMAS_ENTRE_TABLAS) {
+    enviarTablaIds();
+  }
+}
+
+/**
+ * @brief Atiende los comandos de texto del host ("#BIN <versión>")
+ *
+ * NEGOCIACIÓN:
+ * Se responde con la menor versión entre la pedida y la propia. Si la
+ * versión es 0 o el comando es otro, se sigue en modo texto.
+ */
+void revisarComandos() {
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (largoComando < sizeof(comando) - 1) {
+        comando[largoComando++] = c;
+      }
+      continue;
+    }
+
+    comando[largoComando] = '\0';
+    largoComando = 0;
+    if (strncmp(comando, "#BIN ", 5) != 0) {
+      continue;
+    }
+
+    int pedida = atoi(comando + 5);
+    if (pedida < 1) {
+      continue;
+    }
+    uint8_t version = pedida < VERSION_PROTOCOLO ? pedida : VERSION_PROTOCOLO;
+    enviarTrama(TRAMA_HOLA, &version, 1);
+    enviarTablaIds();
+    modoBinario = true;
+  }
+}
+
 // Funciones principales de arduino
 
 /**
@@ -188,6 +355,15 @@ void setup() {
  * - Simula lecturas periódicas reales
  */
 void loop() {
+  revisarComandos();
+
+  // Modo binario: sin mensajes de depuración, solo tramas
+  if (modoBinario) {
+    enviarLecturasBinarias();
+    delay(INTERVALO_BINARIO);
+    return;
+  }
+
   // Enviar lecturas de sensores de temperatura
   enviarTemperatura(TEMP_SENSOR_1);
   delay(500);  // Medio segundo entre sensores
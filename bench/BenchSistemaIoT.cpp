@@ -0,0 +1,506 @@
+/**
+ * @file BenchSistemaIoT.cpp
+ * @brief Microbenchmarks de las estructuras y del camino de ingesta
+ * @details Usa Google Benchmark. Cada caso mide lo mismo que corre
+ *          SistemaIoT (mismos headers, sin copias para el benchmark),
+ *          así cada optimización se compara contra una línea base.
+ *
+ * USO:
+ *   $ ./bin/BenchSistemaIoT
+ *   $ ./bin/BenchSistemaIoT --benchmark_filter=Buscar
+ *   $ BENCH_CAPTURA=captura.txt ./bin/BenchSistemaIoT --benchmark_filter=Pty
+ *
+ * BENCH_CAPTURA es un archivo con líneas "TIPO,ID,VALOR" tal como llegan
+ * del ESP32 (ej: guardado con 'cat /dev/ttyUSB0 > captura.txt'). Sin
+ * él se genera una captura parecida a la del SimuladorSensores.
+ */
+
+#include "IngestaSerial.h"
+#include "ListaSensor.h"
+#include "ListaSensorBloques.h"
+#include "HistorialCircular.h"
+#include "ReactorSerial.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// ============================================================================
+// APOYO
+// ============================================================================
+
+/**
+ * @brief Descarta lo que se escribe en std::cout mientras existe
+ *
+ * RAZÓN: Crear y destruir sensores imprime mensajes; escribirlos en la
+ * terminal costaría más que lo que se quiere medir. Google Benchmark
+ * imprime sus resultados después de que el caso termina, ya restaurado.
+ */
+class SilenciarSalida {
+private:
+    std::streambuf* anterior;
+
+public:
+    SilenciarSalida() : anterior(std::cout.rdbuf(nullptr)) {}
+
+    ~SilenciarSalida() {
+        std::cout.rdbuf(anterior);
+        std::cout.clear();
+    }
+};
+
+/**
+ * @brief Generador pseudoaleatorio reproducible (xorshift)
+ */
+class Aleatorio {
+private:
+    unsigned int estado;
+
+public:
+    explicit Aleatorio(unsigned int semilla) : estado(semilla) {}
+
+    unsigned int siguiente() {
+        estado ^= estado << 13;
+        estado ^= estado >> 17;
+        estado ^= estado << 5;
+        return estado;
+    }
+
+    float temperatura() {
+        return 15.0f + static_cast<float>(siguiente() % 2000) / 100.0f;
+    }
+};
+
+/**
+ * @brief Sensor mínimo: solo su ID
+ *
+ * RAZÓN: buscarSensor compara nombres en el índice sin tocar el sensor;
+ * 100000 SensorTemperatura (con sus ventanas) ocuparían ~500 MB sin
+ * cambiar lo que se mide.
+ */
+class SensorVacio : public SensorBase {
+public:
+    explicit SensorVacio(const char* id) : SensorBase(id) {}
+
+    void procesarLectura() override {}
+    void imprimirInfo() const override {}
+
+protected:
+    void guardarLectura(const char*) override {}
+    void guardarLectura(double) override {}
+};
+
+/**
+ * @brief Líneas "TIPO,ID,VALOR" separadas por '\n' en un solo arreglo
+ */
+struct Captura {
+    char* texto;
+    int largo;
+    int lineas;
+
+    Captura() : texto(nullptr), largo(0), lineas(0) {}
+
+    ~Captura() {
+        delete[] texto;
+    }
+
+    Captura(const Captura&) = delete;
+    Captura& operator=(const Captura&) = delete;
+
+    /**
+     * @brief Genera 'cantidad' lecturas de 'sensores' sensores, mitad T y mitad P
+     * @param conMensajes true para intercalar los "[ESP32] Enviado..." del simulador
+     */
+    void generar(int cantidad, int sensores, bool conMensajes) {
+        delete[] texto;
+        int capacidad = cantidad * (conMensajes ? 96 : 32);
+        texto = new char[capacidad];
+        largo = 0;
+        lineas = 0;
+        Aleatorio azar(12345);
+        for (int i = 0; i < cantidad; i++) {
+            int s = static_cast<int>(azar.siguiente() % static_cast<unsigned int>(sensores));
+            if (s % 2 == 0) {
+                float t = azar.temperatura();
+                largo += snprintf(texto + largo, capacidad - largo, "T,T-%03d,%.1f\n", s, t);
+                if (conMensajes) {
+                    largo += snprintf(texto + largo, capacidad - largo,
+                                      "[ESP32] Enviado - Temperatura T-%03d: %.2f °C\n", s, t);
+                    lineas++;
+                }
+            } else {
+                int p = 980 + static_cast<int>(azar.siguiente() % 60);
+                largo += snprintf(texto + largo, capacidad - largo, "P,P-%03d,%d\n", s, p);
+                if (conMensajes) {
+                    largo += snprintf(texto + largo, capacidad - largo,
+                                      "[ESP32] Enviado - Presión P-%03d: %d hPa\n", s, p);
+                    lineas++;
+                }
+            }
+            lineas++;
+        }
+    }
+
+    /**
+     * @brief Carga la captura de BENCH_CAPTURA; si no está, genera una
+     */
+    void cargar() {
+        const char* ruta = getenv("BENCH_CAPTURA");
+        FILE* f = ruta != nullptr ? fopen(ruta, "rb") : nullptr;
+        if (f == nullptr) {
+            generar(20000, 64, true);
+            return;
+        }
+        fseek(f, 0, SEEK_END);
+        long bytes = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        delete[] texto;
+        texto = new char[bytes + 1];
+        largo = static_cast<int>(fread(texto, 1, bytes, f));
+        fclose(f);
+        if (largo > 0 && texto[largo - 1] != '\n') {
+            texto[largo++] = '\n';
+        }
+        lineas = 0;
+        for (int i = 0; i < largo; i++) {
+            if (texto[i] == '\n') {
+                lineas++;
+            }
+        }
+    }
+};
+
+// ============================================================================
+// HISTORIALES: ListaSensor, ListaSensorBloques, HistorialCircular
+// ============================================================================
+
+/**
+ * @brief Inserta N valores en un historial nuevo (incluye destruirlo)
+ *
+ * NOTA: Historial nuevo en cada vuelta para que la memoria no crezca
+ * con las iteraciones; HistorialCircular se crea con capacidad N.
+ */
+template <typename Historial>
+Historial* crearHistorial(int n) {
+    (void)n;
+    return new Historial();
+}
+
+template <>
+HistorialCircular<float>* crearHistorial<HistorialCircular<float> >(int n) {
+    return new HistorialCircular<float>(n);
+}
+
+template <typename Historial>
+static void BM_InsertarAlFinal(benchmark::State& estado) {
+    const int n = static_cast<int>(estado.range(0));
+    Aleatorio azar(7);
+    for (auto _ : estado) {
+        Historial* h = crearHistorial<Historial>(n);
+        for (int i = 0; i < n; i++) {
+            h->insertarAlFinal(azar.temperatura());
+        }
+        benchmark::DoNotOptimize(h);
+        delete h;
+    }
+    estado.SetItemsProcessed(estado.iterations() * n);
+}
+
+/**
+ * @brief Consulta el promedio de un historial de N valores
+ *
+ * NOTA: Los tres historiales mantienen la suma al insertar, así que se
+ * cuenta una consulta por iteración; si alguno deja de hacerlo, el
+ * tiempo crece con N y se nota en la comparación entre argumentos.
+ */
+template <typename Historial>
+static void BM_CalcularPromedio(benchmark::State& estado) {
+    const int n = static_cast<int>(estado.range(0));
+    Aleatorio azar(7);
+    Historial* h = crearHistorial<Historial>(n);
+    for (int i = 0; i < n; i++) {
+        h->insertarAlFinal(azar.temperatura());
+    }
+    for (auto _ : estado) {
+        benchmark::DoNotOptimize(h->calcularPromedio());
+    }
+    estado.SetItemsProcessed(estado.iterations());
+    delete h;
+}
+
+/**
+ * @brief Vacía un historial de N valores al azar con eliminarMinimo
+ *
+ * NOTA: El llenado queda fuera de la medición (PauseTiming); el tiempo
+ * por elemento es el de una extracción promedio mientras la lista baja.
+ */
+template <typename Historial>
+static void BM_EliminarMinimo(benchmark::State& estado) {
+    const int n = static_cast<int>(estado.range(0));
+    Aleatorio azar(7);
+    for (auto _ : estado) {
+        estado.PauseTiming();
+        Historial* h = crearHistorial<Historial>(n);
+        for (int i = 0; i < n; i++) {
+            h->insertarAlFinal(azar.temperatura());
+        }
+        estado.ResumeTiming();
+        for (int i = 0; i < n; i++) {
+            benchmark::DoNotOptimize(h->eliminarMinimo());
+        }
+        estado.PauseTiming();
+        delete h;
+        estado.ResumeTiming();
+    }
+    estado.SetItemsProcessed(estado.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(BM_InsertarAlFinal, ListaSensor<float>)->Arg(1024)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_InsertarAlFinal, ListaSensorBloques<float>)->Arg(1024)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_InsertarAlFinal, HistorialCircular<float>)->Arg(1024)->Arg(65536);
+
+BENCHMARK_TEMPLATE(BM_CalcularPromedio, ListaSensor<float>)->Arg(1000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_CalcularPromedio, ListaSensorBloques<float>)->Arg(1000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_CalcularPromedio, HistorialCircular<float>)->Arg(1000)->Arg(100000);
+
+BENCHMARK_TEMPLATE(BM_EliminarMinimo, ListaSensor<float>)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_EliminarMinimo, ListaSensorBloques<float>)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_EliminarMinimo, HistorialCircular<float>)->Arg(1000)->Arg(10000);
+
+// ============================================================================
+// GESTOR: buscarSensor con 10, 1k y 100k sensores
+// ============================================================================
+
+/**
+ * @brief Busca IDs existentes en orden pseudoaleatorio
+ *
+ * NOTA: Los IDs se buscan como rebanadas (con largo), igual que
+ * procesarLinea; el arreglo de consultas es de 4096 para que el costo
+ * sea el de la tabla y no el de recorrer las consultas.
+ */
+static void BM_BuscarSensor(benchmark::State& estado) {
+    SilenciarSalida silencio;
+    const int n = static_cast<int>(estado.range(0));
+    GestorSensores* gestor = new GestorSensores();
+    char nombre[16];
+    for (int i = 0; i < n; i++) {
+        snprintf(nombre, sizeof(nombre), "S-%06d", i);
+        gestor->agregarSensor(new SensorVacio(nombre));
+    }
+
+    const int CONSULTAS = 4096;
+    char (*consultas)[16] = new char[CONSULTAS][16];
+    Aleatorio azar(99);
+    for (int i = 0; i < CONSULTAS; i++) {
+        snprintf(consultas[i], 16, "S-%06d", static_cast<int>(azar.siguiente() % static_cast<unsigned int>(n)));
+    }
+
+    int i = 0;
+    for (auto _ : estado) {
+        benchmark::DoNotOptimize(gestor->buscarSensor(consultas[i], 8));
+        i = (i + 1) & (CONSULTAS - 1);
+    }
+    estado.SetItemsProcessed(estado.iterations());
+    delete[] consultas;
+    delete gestor;
+}
+
+/**
+ * @brief Búsqueda de un ID que no existe (cada línea de un sensor nuevo)
+ */
+static void BM_BuscarSensorAusente(benchmark::State& estado) {
+    SilenciarSalida silencio;
+    const int n = static_cast<int>(estado.range(0));
+    GestorSensores* gestor = new GestorSensores();
+    char nombre[16];
+    for (int i = 0; i < n; i++) {
+        snprintf(nombre, sizeof(nombre), "S-%06d", i);
+        gestor->agregarSensor(new SensorVacio(nombre));
+    }
+    for (auto _ : estado) {
+        benchmark::DoNotOptimize(gestor->buscarSensor("X-999999", 8));
+    }
+    estado.SetItemsProcessed(estado.iterations());
+    delete gestor;
+}
+
+BENCHMARK(BM_BuscarSensor)->Arg(10)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_BuscarSensorAusente)->Arg(10)->Arg(1000)->Arg(100000);
+
+// ============================================================================
+// INGESTA: procesarLinea
+// ============================================================================
+
+/**
+ * @brief Recorre la captura línea por línea, como lo haría LectorLineas
+ */
+template <typename Visitante>
+void porCadaLinea(const Captura& captura, Visitante f) {
+    const char* p = captura.texto;
+    const char* fin = captura.texto + captura.largo;
+    while (p < fin) {
+        const char* salto = static_cast<const char*>(memchr(p, '\n', fin - p));
+        f(p, static_cast<int>(salto - p));
+        p = salto + 1;
+    }
+}
+
+/**
+ * @brief procesarLinea sobre una captura en memoria, con 'range(0)' sensores
+ *
+ * NOTA: Sin los mensajes "[ESP32] Enviado..." (esos se descartan antes
+ * de llegar al gestor); los sensores se crean en la primera pasada.
+ */
+static void BM_ProcesarLinea(benchmark::State& estado) {
+    SilenciarSalida silencio;
+    Captura captura;
+    captura.generar(16384, static_cast<int>(estado.range(0)), false);
+    GestorSensores* gestor = new GestorSensores();
+    Persistencia* persistencia = new Persistencia();
+    struct Procesar {
+        GestorSensores& gestor;
+        Persistencia& persistencia;
+        void operator()(const char* linea, int largo) const {
+            procesarLinea(linea, largo, gestor, persistencia);
+        }
+    };
+    Procesar procesar = {*gestor, *persistencia};
+    porCadaLinea(captura, procesar);
+
+    for (auto _ : estado) {
+        porCadaLinea(captura, procesar);
+    }
+    estado.SetItemsProcessed(estado.iterations() * captura.lineas);
+    estado.SetBytesProcessed(estado.iterations() * captura.largo);
+    delete persistencia;
+    delete gestor;
+}
+
+/**
+ * @brief procesarLinea con --datos: bitácora y segmentos en un directorio temporal
+ */
+static void BM_ProcesarLineaConDatos(benchmark::State& estado) {
+    SilenciarSalida silencio;
+    char directorio[] = "/tmp/bench-sistemaiot-XXXXXX";
+    if (mkdtemp(directorio) == nullptr) {
+        estado.SkipWithError("No se pudo crear el directorio temporal");
+        return;
+    }
+    Captura captura;
+    captura.generar(16384, 64, false);
+    GestorSensores* gestor = new GestorSensores();
+    Persistencia* persistencia = new Persistencia();
+    persistencia->almacen.abrir(directorio);
+    persistencia->bitacora.abrir(directorio, [](const LecturaParseada*, int, long long) {});
+    struct Procesar {
+        GestorSensores& gestor;
+        Persistencia& persistencia;
+        void operator()(const char* linea, int largo) const {
+            procesarLinea(linea, largo, gestor, persistencia);
+        }
+    };
+    Procesar procesar = {*gestor, *persistencia};
+
+    for (auto _ : estado) {
+        porCadaLinea(captura, procesar);
+    }
+    persistencia->bitacora.confirmar();
+    estado.SetItemsProcessed(estado.iterations() * captura.lineas);
+    delete persistencia;
+    delete gestor;
+
+    char orden[128];
+    snprintf(orden, sizeof(orden), "rm -rf %s", directorio);
+    if (system(orden) != 0) {
+        estado.SkipWithError("No se pudo borrar el directorio temporal");
+    }
+}
+
+BENCHMARK(BM_ProcesarLinea)->Arg(10)->Arg(1000);
+BENCHMARK(BM_ProcesarLineaConDatos)->UseRealTime();
+
+// ============================================================================
+// EXTREMO A EXTREMO: una captura reproducida por una pseudoterminal
+// ============================================================================
+
+/**
+ * @brief Reproduce la captura por una pty y la procesa con ReactorSerial
+ *
+ * PROCESO (por iteración):
+ * 1. Un hilo escribe la captura completa en el lado maestro de la pty
+ * 2. El reactor espera con epoll en el lado esclavo (en modo crudo,
+ *    como configurarSerial deja al puerto real) y pasa cada línea a
+ *    procesarLinea
+ * 3. La iteración termina cuando se procesaron todas las líneas
+ *
+ * RAZÓN: Mide lo que cuesta de verdad cada línea: read(), el reparto
+ * en líneas, el parser y el gestor, sin un ESP32 conectado.
+ */
+static void BM_ReproducirCapturaPty(benchmark::State& estado) {
+    SilenciarSalida silencio;
+    Captura captura;
+    captura.cargar();
+
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0) {
+        estado.SkipWithError("No se pudo abrir una pseudoterminal");
+        return;
+    }
+    int esclavo = open(ptsname(maestro), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (esclavo < 0) {
+        close(maestro);
+        estado.SkipWithError("No se pudo abrir el lado esclavo de la pty");
+        return;
+    }
+    struct termios opciones;
+    tcgetattr(esclavo, &opciones);
+    cfmakeraw(&opciones);
+    tcsetattr(esclavo, TCSANOW, &opciones);
+
+    GestorSensores* gestor = new GestorSensores();
+    Persistencia* persistencia = new Persistencia();
+    ReactorSerial* reactor = new ReactorSerial();
+    reactor->agregarPuerto(esclavo, "pty");  // El reactor cierra el esclavo
+
+    for (auto _ : estado) {
+        std::thread escritor([maestro, &captura]() {
+            int enviados = 0;
+            while (enviados < captura.largo) {
+                ssize_t n = write(maestro, captura.texto + enviados, captura.largo - enviados);
+                if (n <= 0) {
+                    break;
+                }
+                enviados += static_cast<int>(n);
+            }
+        });
+
+        int procesadas = 0;
+        while (procesadas < captura.lineas && reactor->puertosActivos() > 0) {
+            reactor->atender(100, [gestor, persistencia, &procesadas](const char* linea, int largo) {
+                procesarLinea(linea, largo, *gestor, *persistencia);
+                procesadas++;
+            });
+        }
+        escritor.join();
+    }
+    estado.SetItemsProcessed(estado.iterations() * captura.lineas);
+    estado.SetBytesProcessed(estado.iterations() * captura.largo);
+
+    delete reactor;
+    delete persistencia;
+    delete gestor;
+    close(maestro);
+}
+
+BENCHMARK(BM_ReproducirCapturaPty)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,505 @@
+/**
+ * @file GeneradorCarga.cpp
+ * @brief Generador de carga en el host que habla como SimuladorSensores.ino
+ * @details Escribe líneas "TIPO,ID,VALOR\r\n" (igual que Serial.println)
+ *          en una pseudoterminal, un FIFO, un archivo o la salida
+ *          estándar, para probar SistemaIoT con miles de sensores y a
+ *          más de lo que permite un ESP32 a 115200 baudios.
+ *
+ * USO:
+ *   $ ./bin/GeneradorCarga --sensores 10000 --tasa 200000
+ *     [Generador] Puerto: /dev/pts/3   (pasarlo a SistemaIoT)
+ *   $ ./bin/GeneradorCarga --tasa 0 --duracion 30 --lanzar ./bin/SistemaIoT --hilos
+ *     (lanza SistemaIoT con la ruta de la pty como último argumento)
+ *   $ ./bin/GeneradorCarga --lineas 100000 --malformadas 0.01 --salida captura.txt
+ *     (captura para BENCH_CAPTURA, ver bench/BenchSistemaIoT.cpp)
+ *
+ * OPCIONES:
+ *   --sensores N      IDs distintos, mitad T y mitad P (1 a 100000; 4 por defecto)
+ *   --tasa L          Lecturas por segundo en promedio (0 = tan rápido como se lea)
+ *   --rafaga K        Lecturas seguidas antes de cada pausa (1 por defecto)
+ *   --malformadas F   Fracción de líneas inválidas, entre 0 y 1
+ *   --mensajes        Intercala los "[ESP32] Enviado - ..." del simulador
+ *   --duracion S      Segundos de generación (0 = sin límite)
+ *   --lineas N        Lecturas a generar (0 = sin límite)
+ *   --espera S        Segundos antes de empezar, para conectar el lector (1 por defecto)
+ *   --semilla N       Semilla del generador pseudoaleatorio
+ *   --salida RUTA     Archivo o FIFO en lugar de una pty ('-' = salida estándar)
+ *   --lanzar PROG ... Ejecuta PROG con sus argumentos y la ruta de la pty al final
+ *
+ * NOTA: La escritura es bloqueante. Si el lector no da abasto, el
+ * generador se frena con él, y la tasa que se informa es la real.
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+// ============================================================================
+// OPCIONES
+// ============================================================================
+
+const int SENSORES_MAXIMOS = 100000;
+
+/**
+ * @brief Parámetros de una corrida, tal como llegan en la línea de órdenes
+ */
+struct OpcionesCarga {
+    int sensores;
+    double tasa;           ///< Lecturas por segundo (0 = sin pausa)
+    int rafaga;
+    double malformadas;    ///< Fracción entre 0 y 1
+    bool mensajes;
+    double duracion;       ///< Segundos (0 = sin límite)
+    long long lineas;      ///< Lecturas (0 = sin límite)
+    double espera;
+    unsigned int semilla;
+    const char* salida;    ///< nullptr = pty
+    char** lanzar;         ///< argv del programa a lanzar, o nullptr
+    int argumentosLanzar;
+};
+
+/**
+ * @brief Interpreta argv; imprime el error y devuelve false si algo no cuadra
+ */
+bool leerOpciones(int argc, char* argv[], OpcionesCarga& o) {
+    o.sensores = 4;
+    o.tasa = 2.0;
+    o.rafaga = 1;
+    o.malformadas = 0.0;
+    o.mensajes = false;
+    o.duracion = 0.0;
+    o.lineas = 0;
+    o.espera = 1.0;
+    o.semilla = static_cast<unsigned int>(time(nullptr));
+    o.salida = nullptr;
+    o.lanzar = nullptr;
+    o.argumentosLanzar = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        bool conValor = i + 1 < argc;
+        if (strcmp(a, "--lanzar") == 0 && conValor) {
+            o.lanzar = argv + i + 1;
+            o.argumentosLanzar = argc - i - 1;
+            break;
+        } else if (strcmp(a, "--mensajes") == 0) {
+            o.mensajes = true;
+        } else if (strcmp(a, "--sensores") == 0 && conValor) {
+            o.sensores = atoi(argv[++i]);
+        } else if (strcmp(a, "--tasa") == 0 && conValor) {
+            o.tasa = atof(argv[++i]);
+        } else if (strcmp(a, "--rafaga") == 0 && conValor) {
+            o.rafaga = atoi(argv[++i]);
+        } else if (strcmp(a, "--malformadas") == 0 && conValor) {
+            o.malformadas = atof(argv[++i]);
+        } else if (strcmp(a, "--duracion") == 0 && conValor) {
+            o.duracion = atof(argv[++i]);
+        } else if (strcmp(a, "--lineas") == 0 && conValor) {
+            o.lineas = atoll(argv[++i]);
+        } else if (strcmp(a, "--espera") == 0 && conValor) {
+            o.espera = atof(argv[++i]);
+        } else if (strcmp(a, "--semilla") == 0 && conValor) {
+            o.semilla = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(a, "--salida") == 0 && conValor) {
+            o.salida = argv[++i];
+        } else {
+            fprintf(stderr, "[Generador] Opción desconocida o sin valor: %s\n", a);
+            return false;
+        }
+    }
+
+    if (o.sensores < 1 || o.sensores > SENSORES_MAXIMOS) {
+        fprintf(stderr, "[Generador] --sensores debe estar entre 1 y %d\n", SENSORES_MAXIMOS);
+        return false;
+    }
+    if (o.tasa < 0.0 || o.rafaga < 1 || o.malformadas < 0.0 || o.malformadas > 1.0) {
+        fprintf(stderr, "[Generador] --tasa >= 0, --rafaga >= 1 y --malformadas entre 0 y 1\n");
+        return false;
+    }
+    if (o.lanzar != nullptr && o.salida != nullptr) {
+        fprintf(stderr, "[Generador] --lanzar necesita la pty; no se combina con --salida\n");
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// GENERACIÓN DE LÍNEAS
+// ============================================================================
+
+/**
+ * @brief Generador pseudoaleatorio (xorshift): rápido y reproducible con --semilla
+ */
+class Aleatorio {
+private:
+    unsigned int estado;
+
+public:
+    explicit Aleatorio(unsigned int semilla) : estado(semilla != 0 ? semilla : 1u) {}
+
+    unsigned int siguiente() {
+        estado ^= estado << 13;
+        estado ^= estado >> 17;
+        estado ^= estado << 5;
+        return estado;
+    }
+
+    /**
+     * @brief Entero en [minimo, maximo)
+     */
+    int entre(int minimo, int maximo) {
+        return minimo + static_cast<int>(siguiente() % static_cast<unsigned int>(maximo - minimo));
+    }
+
+    /**
+     * @brief true con probabilidad 'p'
+     */
+    bool sorteo(double p) {
+        return static_cast<double>(siguiente()) < p * 4294967296.0;
+    }
+};
+
+/**
+ * @class GeneradorLineas
+ * @brief Arma las líneas que mandaría un ESP32 con muchos sensores
+ *
+ * IDS: Como en el simulador, las temperaturas son T-001, T-002... y las
+ * presiones P-101, P-102...; con --sensores 4 salen exactamente los
+ * cuatro IDs de SimuladorSensores.ino.
+ *
+ * VALORES: Los mismos rangos que generarTemperatura() (15.0 a 35.0) y
+ * generarPresion() (980 a 1050) del simulador.
+ */
+class GeneradorLineas {
+private:
+    Aleatorio azar;
+    int sensores;
+    int temperaturas;          ///< Los primeros 'temperaturas' índices son T
+    double malformadas;
+    bool mensajes;
+
+    /**
+     * @brief Número del ID de un índice: T-001... para temperaturas, P-101... para presiones
+     */
+    int numeroDe(int indice) const {
+        return indice < temperaturas ? indice + 1 : indice - temperaturas + 101;
+    }
+
+    /**
+     * @brief Escribe una de las fallas típicas de un enlace serial
+     *
+     * RAZÓN de variar la falla: Cada una sale del parser por un camino
+     * distinto (campo faltante, número inválido, tipo desconocido,
+     * ID vacío, línea demasiado larga para LectorLineas).
+     */
+    int escribirMalformada(char* destino, int capacidad, int indice) {
+        char tipo = indice < temperaturas ? 'T' : 'P';
+        int numero = numeroDe(indice);
+        switch (azar.entre(0, 6)) {
+            case 0:
+                return snprintf(destino, capacidad, "%c,%c-%03d\r\n", tipo, tipo, numero);
+            case 1:
+                return snprintf(destino, capacidad, "%c,%c-%03d,10%c3\r\n", tipo, tipo, numero,
+                                'a' + azar.entre(0, 26));
+            case 2:
+                return snprintf(destino, capacidad, "X,X-%03d,1\r\n", numero);
+            case 3:
+                return snprintf(destino, capacidad, "T,,%d.%d\r\n", azar.entre(15, 35), azar.entre(0, 10));
+            case 4:
+                return snprintf(destino, capacidad, "%c,%c-%03d,%d.%d,%d\r\n", tipo, tipo, numero,
+                                azar.entre(15, 35), azar.entre(0, 10), azar.entre(0, 10));
+            default: {
+                // Más de 255 bytes: LectorLineas la descarta entera
+                int largo = 300 < capacidad - 2 ? 300 : capacidad - 2;
+                memset(destino, 'Z', largo);
+                destino[largo] = '\r';
+                destino[largo + 1] = '\n';
+                return largo + 2;
+            }
+        }
+    }
+
+public:
+    GeneradorLineas(const OpcionesCarga& o)
+        : azar(o.semilla), sensores(o.sensores), temperaturas((o.sensores + 1) / 2),
+          malformadas(o.malformadas), mensajes(o.mensajes) {}
+
+    /**
+     * @brief Peor caso en bytes de una lectura (con su mensaje y una malformada)
+     */
+    static const int MAXIMO_LINEA = 384;
+
+    /**
+     * @brief Escribe la próxima lectura
+     * @param esMalformada Recibe true si la lectura salió inválida a propósito
+     * @return Bytes escritos en 'destino' (capacidad MAXIMO_LINEA)
+     */
+    int siguiente(char* destino, bool& esMalformada) {
+        int indice = azar.entre(0, sensores);
+        esMalformada = malformadas > 0.0 && azar.sorteo(malformadas);
+        if (esMalformada) {
+            return escribirMalformada(destino, MAXIMO_LINEA, indice);
+        }
+
+        int largo;
+        int numero = numeroDe(indice);
+        if (indice < temperaturas) {
+            int decimas = azar.entre(150, 351);
+            largo = snprintf(destino, MAXIMO_LINEA, "T,T-%03d,%d.%d\r\n", numero, decimas / 10, decimas % 10);
+            if (mensajes) {
+                largo += snprintf(destino + largo, MAXIMO_LINEA - largo,
+                                  "[ESP32] Enviado - Temperatura T-%03d: %d.%d0 °C\r\n",
+                                  numero, decimas / 10, decimas % 10);
+            }
+        } else {
+            int presion = azar.entre(980, 1051);
+            largo = snprintf(destino, MAXIMO_LINEA, "P,P-%03d,%d\r\n", numero, presion);
+            if (mensajes) {
+                largo += snprintf(destino + largo, MAXIMO_LINEA - largo,
+                                  "[ESP32] Enviado - Presión P-%03d: %d hPa\r\n", numero, presion);
+            }
+        }
+        return largo;
+    }
+};
+
+// ============================================================================
+// SALIDA
+// ============================================================================
+
+volatile sig_atomic_t interrumpido = 0;
+
+void alInterrumpir(int) {
+    interrumpido = 1;
+}
+
+double segundosDesde(const struct timespec& inicio) {
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return static_cast<double>(ahora.tv_sec - inicio.tv_sec) +
+           static_cast<double>(ahora.tv_nsec - inicio.tv_nsec) / 1e9;
+}
+
+/**
+ * @brief Duerme hasta 'objetivo' segundos contados desde 'inicio'
+ */
+void dormirHasta(const struct timespec& inicio, double objetivo) {
+    double falta = objetivo - segundosDesde(inicio);
+    if (falta <= 0.0) {
+        return;
+    }
+    struct timespec pausa;
+    pausa.tv_sec = static_cast<time_t>(falta);
+    pausa.tv_nsec = static_cast<long>((falta - static_cast<double>(pausa.tv_sec)) * 1e9);
+    nanosleep(&pausa, nullptr);
+}
+
+/**
+ * @brief Escribe todo el buffer (write puede escribir menos de lo pedido)
+ * @return false si el otro extremo se cerró
+ */
+bool escribirTodo(int fd, const char* datos, int largo) {
+    while (largo > 0) {
+        ssize_t n = write(fd, datos, largo);
+        if (n < 0) {
+            if (errno == EINTR && !interrumpido) {
+                continue;
+            }
+            return false;
+        }
+        datos += n;
+        largo -= static_cast<int>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Abre una pseudoterminal en modo crudo
+ * @param esclavo Recibe el lado esclavo, abierto para que la pty no se cierre
+ *        mientras el lector todavía no llegó
+ * @return Lado maestro (donde se escribe), o -1
+ */
+int abrirPty(int& esclavo, char* ruta, int largoRuta) {
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0) {
+        return -1;
+    }
+    snprintf(ruta, largoRuta, "%s", ptsname(maestro));
+    esclavo = open(ruta, O_RDWR | O_NOCTTY);
+    if (esclavo < 0) {
+        close(maestro);
+        return -1;
+    }
+    // Sin eco ni traducción de fines de línea, como un puerto USB real
+    struct termios opciones;
+    tcgetattr(esclavo, &opciones);
+    cfmakeraw(&opciones);
+    tcsetattr(esclavo, TCSANOW, &opciones);
+    return maestro;
+}
+
+/**
+ * @brief Lanza el programa de --lanzar con la ruta de la pty como último argumento
+ * @return PID del hijo, o -1
+ */
+pid_t lanzarLector(const OpcionesCarga& o, char* ruta) {
+    char** argumentos = new char*[o.argumentosLanzar + 2];
+    for (int i = 0; i < o.argumentosLanzar; i++) {
+        argumentos[i] = o.lanzar[i];
+    }
+    argumentos[o.argumentosLanzar] = ruta;
+    argumentos[o.argumentosLanzar + 1] = nullptr;
+
+    pid_t hijo = fork();
+    if (hijo == 0) {
+        execvp(argumentos[0], argumentos);
+        fprintf(stderr, "[Generador] No se pudo ejecutar %s: %s\n", argumentos[0], strerror(errno));
+        _exit(127);
+    }
+    delete[] argumentos;
+    return hijo;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+/**
+ * @brief Genera carga hasta cumplir --duracion o --lineas, o hasta Ctrl+C
+ *
+ * PROCESO:
+ * 1. Abrir la salida (pty por defecto) y, si se pidió, lanzar el lector
+ * 2. Esperar --espera segundos a que el lector abra el puerto
+ * 3. Por cada ráfaga: armar K lecturas en un buffer, un solo write(),
+ *    y dormir hasta el momento en que la tasa pide la siguiente
+ *    (contado desde el inicio, así las pausas no acumulan desvío)
+ * 4. Informar cada segundo y al final la tasa alcanzada
+ */
+int main(int argc, char* argv[]) {
+    OpcionesCarga o;
+    if (!leerOpciones(argc, argv, o)) {
+        return 2;
+    }
+    signal(SIGINT, alInterrumpir);
+    signal(SIGTERM, alInterrumpir);
+    signal(SIGPIPE, SIG_IGN);
+
+    int fd = -1;
+    int esclavo = -1;
+    char ruta[128] = "";
+    if (o.salida == nullptr) {
+        fd = abrirPty(esclavo, ruta, sizeof(ruta));
+        if (fd < 0) {
+            fprintf(stderr, "[Generador] No se pudo abrir una pseudoterminal\n");
+            return 1;
+        }
+        fprintf(stderr, "[Generador] Puerto: %s\n", ruta);
+    } else if (strcmp(o.salida, "-") == 0) {
+        fd = STDOUT_FILENO;
+    } else {
+        fd = open(o.salida, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "[Generador] No se pudo abrir %s: %s\n", o.salida, strerror(errno));
+            return 1;
+        }
+    }
+
+    pid_t hijo = -1;
+    if (o.lanzar != nullptr) {
+        hijo = lanzarLector(o, ruta);
+    }
+
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    dormirHasta(inicio, o.espera);
+    if (hijo > 0) {
+        // El hijo ya tiene su propio descriptor; sin el nuestro, write()
+        // falla con EIO cuando el hijo termina y el generador se detiene
+        close(esclavo);
+        esclavo = -1;
+    }
+
+    // Buffer de una ráfaga, con tope para que --rafaga grande no pida gigas
+    const int LECTURAS_POR_WRITE = 1024;
+    int porWrite = o.rafaga < LECTURAS_POR_WRITE ? o.rafaga : LECTURAS_POR_WRITE;
+    char* buffer = new char[porWrite * GeneradorLineas::MAXIMO_LINEA];
+    GeneradorLineas generador(o);
+
+    long long enviadas = 0;
+    long long malformadas = 0;
+    long long bytes = 0;
+    long long enviadasAlInformar = 0;
+    double ultimoInforme = 0.0;
+    bool abierto = true;
+
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    while (abierto && !interrumpido) {
+        double transcurrido = segundosDesde(inicio);
+        if (o.duracion > 0.0 && transcurrido >= o.duracion) {
+            break;
+        }
+        if (o.lineas > 0 && enviadas >= o.lineas) {
+            break;
+        }
+
+        // Una ráfaga de K lecturas, en tantos write() como haga falta
+        int enRafaga = 0;
+        while (abierto && enRafaga < o.rafaga && (o.lineas == 0 || enviadas < o.lineas)) {
+            int usados = 0;
+            int lote = 0;
+            while (lote < porWrite && enRafaga < o.rafaga && (o.lineas == 0 || enviadas + lote < o.lineas)) {
+                bool esMalformada;
+                usados += generador.siguiente(buffer + usados, esMalformada);
+                malformadas += esMalformada ? 1 : 0;
+                lote++;
+                enRafaga++;
+            }
+            abierto = escribirTodo(fd, buffer, usados);
+            if (abierto) {
+                enviadas += lote;
+                bytes += usados;
+            }
+        }
+
+        if (o.tasa > 0.0) {
+            dormirHasta(inicio, static_cast<double>(enviadas) / o.tasa);
+        }
+
+        transcurrido = segundosDesde(inicio);
+        if (transcurrido - ultimoInforme >= 1.0) {
+            fprintf(stderr, "[Generador] %.0f s: %.0f lecturas/s\n", transcurrido,
+                    static_cast<double>(enviadas - enviadasAlInformar) / (transcurrido - ultimoInforme));
+            ultimoInforme = transcurrido;
+            enviadasAlInformar = enviadas;
+        }
+    }
+    double total = segundosDesde(inicio);
+    delete[] buffer;
+
+    fprintf(stderr, "[Generador] %lld lectura(s) (%lld malformadas) en %.2f s: %.0f lecturas/s, %.2f MB/s%s\n",
+            enviadas, malformadas, total, total > 0.0 ? static_cast<double>(enviadas) / total : 0.0,
+            total > 0.0 ? static_cast<double>(bytes) / total / 1e6 : 0.0,
+            abierto ? "" : " (el lector cerró el puerto)");
+
+    if (hijo > 0) {
+        // El lector sigue con lo que tiene en el buffer; se lo espera
+        int estado = 0;
+        waitpid(hijo, &estado, 0);
+    }
+    if (esclavo >= 0) {
+        close(esclavo);
+    }
+    if (fd != STDOUT_FILENO) {
+        close(fd);
+    }
+    return 0;
+}
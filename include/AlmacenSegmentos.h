@@ -0,0 +1,859 @@
+/**
+ * @file AlmacenSegmentos.h
+ * @brief Historial persistente: un archivo de segmentos comprimidos por sensor
+ * @details Las lecturas se agregan al final de '<directorio>/<sensor>.seg'
+ *          en bloques columnares comprimidos (CompresionSeries.h). Al
+ *          arrancar, los archivos se mapean en memoria: el registro se
+ *          reconstruye leyendo solo las cabeceras, y cada historial se
+ *          decodifica recién cuando hace falta (hidratar).
+ */
+
+#ifndef ALMACEN_SEGMENTOS_H
+#define ALMACEN_SEGMENTOS_H
+
+#include "GestorSensores.h"
+#include "FuenteHistorial.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "ParserTramas.h"
+#include "ProtocoloBinario.h"  // leerU32, escribirU32, calcularCrc16
+#include "CompresionSeries.h"
+#include "Registro.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Milisegundos del reloj del sistema (época Unix)
+ *
+ * RAZÓN: El reloj monotónico vuelve a cero al reiniciar el equipo;
+ * en disco se guarda la hora real y al hidratar se traduce.
+ */
+inline long long relojSistemaMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const char MAGIA_SEGMENTO[4] = {'I', 'O', 'T', 'S'};
+const unsigned char VERSION_SEGMENTO = 1;
+const int CABECERA_BLOQUE_SEGMENTO = 24;   ///< carga u32, cantidad u16, crc u16, 2 marcas i64
+const int LECTURAS_POR_BLOQUE_SEGMENTO = 256;
+
+/**
+ * @brief Fuerza al disco las entradas de un directorio (archivos nuevos o renombrados)
+ *
+ * RAZÓN: fdatasync de un archivo recién creado no garantiza que su
+ * nombre sobreviva a un corte de luz; eso vive en el directorio.
+ */
+inline void sincronizarDirectorio(const char* directorio) {
+    int fd = open(directorio, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+/**
+ * @brief Escribe un entero de 64 bits little-endian
+ */
+inline void escribirI64(unsigned char* p, long long valor) {
+    unsigned long long v = static_cast<unsigned long long>(valor);
+    escribirU32(p, static_cast<unsigned int>(v));
+    escribirU32(p + 4, static_cast<unsigned int>(v >> 32));
+}
+
+/**
+ * @brief Lee un entero de 64 bits little-endian
+ */
+inline long long leerI64(const unsigned char* p) {
+    return static_cast<long long>(static_cast<unsigned long long>(leerU32(p)) |
+                                  (static_cast<unsigned long long>(leerU32(p + 4)) << 32));
+}
+
+/**
+ * @class AlmacenSegmentos
+ * @brief Persiste las lecturas de cada sensor y las recupera al reiniciar
+ *
+ * FORMATO DEL ARCHIVO:
+ *   Cabecera: "IOTS" | versión u8 | tipo u8 ('T'/'P') | largo u8 | 0 | nombre
+ *   Bloques:  carga u32 | cantidad u16 | CRC-16 u16 | primera marca i64
+ *             | última marca i64 | carga
+ *   Carga (columnar): primero las 'cantidad' marcas con delta de delta,
+ *   después los valores: XOR de floats para 'T', delta de delta para 'P'.
+ *
+ * RAZÓN de columnas: Las marcas se parecen entre sí y los valores entre
+ * sí; intercalarlos rompería las rachas que aprovechan los codificadores.
+ *
+ * ESCRITURA: Cada sensor junta hasta LECTURAS_POR_BLOQUE_SEGMENTO
+ * lecturas en memoria; al completarse se comprimen y se agregan con un
+ * solo write(). sincronizar() escribe también los bloques a medias.
+ * Un bloque ya escrito no se modifica nunca.
+ *
+ * RECUPERACIÓN: Al abrir un archivo se recorren las cabeceras de bloque
+ * y se verifica el CRC; lo que sigue al último bloque sano (un write()
+ * cortado por un apagón) se trunca antes de volver a agregar.
+ *
+ * ARRANQUE PEREZOSO: El mapeo no lee el archivo; el sistema trae cada
+ * página recién cuando se toca. restaurar() solo registra los sensores.
+ * El gestor llama a hidratar() (FuenteHistorial.h) la primera vez que
+ * procesa, lista o consulta uno: recién ahí se decodifica su historial
+ * y queda antes de las lecturas llegadas desde el arranque.
+ *
+ * HILOS: Un cerrojo protege todo; anotarLote lo toma una vez por lote
+ * y dentro cada lectura ubica su serie por identificador, en O(1).
+ */
+class AlmacenSegmentos : public FuenteHistorial {
+private:
+    /**
+     * @brief Estado de un archivo de segmento
+     */
+    struct Serie {
+        char nombre[LARGO_MAXIMO_ID + 1];
+        int largoNombre;
+        unsigned int identificador; ///< El nombre internado (TablaIdentificadores)
+        char tipo;                  ///< 'T' o 'P'
+        int fd;                     ///< Abierto para agregar al final
+
+        // Contenido que había al abrir (mapeado, solo lectura)
+        unsigned char* mapa;
+        long long largoMapa;        ///< Bytes mapeados
+        long long inicioBloques;    ///< Donde termina la cabecera
+        long long finValido;        ///< Donde termina el último bloque sano
+        int bloquesMapeados;
+        int lecturasMapeadas;
+        bool hidratada;             ///< true si ya se volcó al sensor
+
+        // Lecturas que aún no forman un bloque completo
+        long long marcas[LECTURAS_POR_BLOQUE_SEGMENTO];
+        double valores[LECTURAS_POR_BLOQUE_SEGMENTO];
+        int pendientes;
+        int bloquesEscritos;
+
+        // Lo último que quedó en disco, para no duplicarlo al recuperar la bitácora
+        long long marcaGuardada;    ///< Marca de la última lectura de los bloques sanos
+        int repetidasGuardadas;     ///< Lecturas al final con esa misma marca
+    };
+
+    char directorio[256];
+    Serie** series;
+    int cantidad;
+    int capacidad;
+    std::mutex cerrojo;
+
+    /**
+     * @brief Serie de cada identificador internado (nullptr = sin segmento)
+     *
+     * RAZÓN: serieDe y descartarGuardadas corren por cada lectura con el
+     * cerrojo tomado. Como en el índice del gestor, el identificador es
+     * la posición: una lectura, sin recorrer 'series' ni comparar nombres.
+     */
+    Serie** porIdentificador;
+    unsigned int capacidadIdentificadores;   ///< Potencia de 2
+
+    long long lecturasHidratadas;   ///< Recuperadas del disco hasta ahora
+    int seriesHidratadas;
+
+    /**
+     * @brief Arma la ruta del archivo de un sensor
+     *
+     * NOTA: Los caracteres que no son letras, dígitos, '-', '_' o '.'
+     * (y un '.' inicial) se escriben como "%XX" en hexadecimal, igual que
+     * '%' mismo. Así "T/1" va a "T%2F1.seg" y no choca con "T_1.seg":
+     * dos nombres distintos nunca comparten archivo. El nombre real
+     * queda en la cabecera.
+     */
+    void rutaDe(const char* nombre, char* ruta, int largoRuta) const {
+        static const char hex[] = "0123456789ABCDEF";
+        char seguro[LARGO_MAXIMO_ID * 3 + 1];
+        int largo = 0;
+        for (int i = 0; nombre[i] != '\0' && i < LARGO_MAXIMO_ID; i++) {
+            char c = nombre[i];
+            bool valido = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                          (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+            if (valido && !(i == 0 && c == '.')) {
+                seguro[largo++] = c;
+            } else {
+                unsigned char u = static_cast<unsigned char>(c);
+                seguro[largo++] = '%';
+                seguro[largo++] = hex[u >> 4];
+                seguro[largo++] = hex[u & 0x0F];
+            }
+        }
+        seguro[largo] = '\0';
+        snprintf(ruta, largoRuta, "%s/%s.seg", directorio, seguro);
+    }
+
+    void agregarSerie(Serie* s) {
+        s->identificador = TablaIdentificadores::global().internar(s->nombre, s->largoNombre);
+        if (s->identificador >= capacidadIdentificadores) {
+            unsigned int nueva = capacidadIdentificadores == 0 ? 64 : capacidadIdentificadores;
+            while (nueva <= s->identificador) {
+                nueva *= 2;
+            }
+            Serie** mayor = new Serie*[nueva];
+            for (unsigned int i = 0; i < nueva; i++) {
+                mayor[i] = i < capacidadIdentificadores ? porIdentificador[i] : nullptr;
+            }
+            delete[] porIdentificador;
+            porIdentificador = mayor;
+            capacidadIdentificadores = nueva;
+        }
+        porIdentificador[s->identificador] = s;
+
+        if (cantidad == capacidad) {
+            int nuevaCapacidad = capacidad == 0 ? 16 : capacidad * 2;
+            Serie** nuevo = new Serie*[nuevaCapacidad];
+            for (int i = 0; i < cantidad; i++) {
+                nuevo[i] = series[i];
+            }
+            delete[] series;
+            series = nuevo;
+            capacidad = nuevaCapacidad;
+        }
+        series[cantidad++] = s;
+    }
+
+    /**
+     * @brief Recorre los bloques mapeados y ubica el último sano
+     * @return false si la cabecera del archivo no es válida
+     */
+    static bool validar(Serie* s) {
+        const unsigned char* p = s->mapa;
+        long long largo = s->largoMapa;
+        if (largo < 8 || memcmp(p, MAGIA_SEGMENTO, 4) != 0 || p[4] != VERSION_SEGMENTO) {
+            return false;
+        }
+        int largoNombre = p[6];
+        if (largoNombre == 0 || largoNombre > LARGO_MAXIMO_ID || 8 + largoNombre > largo) {
+            return false;
+        }
+        if (p[5] != 'T' && p[5] != 'P') {
+            return false;
+        }
+        s->tipo = static_cast<char>(p[5]);
+        s->largoNombre = largoNombre;
+        memcpy(s->nombre, p + 8, largoNombre);
+        s->nombre[largoNombre] = '\0';
+
+        long long pos = 8 + largoNombre;
+        s->inicioBloques = pos;
+        long long inicioCola = pos;  // primer bloque de la racha que termina en la misma marca
+        while (pos + CABECERA_BLOQUE_SEGMENTO <= largo) {
+            long long carga = leerU32(p + pos);
+            int lecturas = leerU16(p + pos + 4);
+            if (lecturas == 0 || lecturas > LECTURAS_POR_BLOQUE_SEGMENTO ||
+                pos + CABECERA_BLOQUE_SEGMENTO + carga > largo) {
+                break;
+            }
+            const unsigned char* datos = p + pos + CABECERA_BLOQUE_SEGMENTO;
+            if (calcularCrc16(datos, static_cast<int>(carga)) != leerU16(p + pos + 6)) {
+                break;
+            }
+            long long ultimaMarca = leerI64(p + pos + 16);
+            if (s->bloquesMapeados == 0 || ultimaMarca != s->marcaGuardada) {
+                inicioCola = pos;
+            }
+            s->marcaGuardada = ultimaMarca;
+            s->bloquesMapeados++;
+            s->lecturasMapeadas += lecturas;
+            pos += CABECERA_BLOQUE_SEGMENTO + carga;
+        }
+        s->finValido = pos;
+        contarCola(s, inicioCola);
+        return true;
+    }
+
+    /**
+     * @brief Cuenta las lecturas finales que comparten la última marca
+     * @param inicioCola Primer bloque cuya última marca es la final
+     *
+     * RAZÓN: Un lote de la bitácora entero lleva una marca, y puede haber
+     * quedado mitad en disco y mitad en memoria. Solo se decodifica la
+     * columna de marcas de esos últimos bloques (casi siempre uno).
+     */
+    static void contarCola(Serie* s, long long inicioCola) {
+        s->repetidasGuardadas = 0;
+        for (long long pos = inicioCola; pos < s->finValido; ) {
+            const unsigned char* p = s->mapa + pos;
+            int carga = static_cast<int>(leerU32(p));
+            int lecturas = leerU16(p + 4);
+            LectorBits bits(p + CABECERA_BLOQUE_SEGMENTO, carga);
+            CodificadorDeltaDelta marcas;
+            for (int i = 0; i < lecturas; i++) {
+                if (marcas.leer(bits) == s->marcaGuardada) {
+                    s->repetidasGuardadas++;
+                }
+            }
+            pos += CABECERA_BLOQUE_SEGMENTO + carga;
+        }
+    }
+
+    /**
+     * @brief Abre (o crea) el archivo de un sensor y mapea lo que ya tenía
+     * @param ruta Archivo del segmento
+     * @param nombre Nombre esperado, o nullptr si se descubre desde la cabecera
+     * @param tipo Tipo para un archivo nuevo
+     * @return Serie lista para agregar, o nullptr si el archivo no sirve
+     */
+    Serie* abrirSerie(const char* ruta, const char* nombre, char tipo) {
+        int fd = open(ruta, O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            REGISTRO_ERROR("[Almacen] No se pudo abrir " << ruta);
+            return nullptr;
+        }
+
+        Serie* s = new Serie();
+        s->fd = fd;
+        s->mapa = nullptr;
+        s->largoMapa = 0;
+        s->hidratada = false;
+        s->marcaGuardada = -1;
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapa = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapa != MAP_FAILED) {
+                s->mapa = static_cast<unsigned char*>(mapa);
+                s->largoMapa = info.st_size;
+            }
+            if (s->mapa == nullptr || !validar(s) ||
+                (nombre != nullptr && strcmp(s->nombre, nombre) != 0)) {
+                REGISTRO_ADVERTENCIA("[Almacen] Segmento ignorado (cabecera inválida): " << ruta);
+                cerrarSerie(s);
+                return nullptr;
+            }
+            if (s->finValido < s->largoMapa) {
+                std::cout << "[Almacen] " << s->nombre << ": "
+                          << (s->largoMapa - s->finValido)
+                          << " byte(s) de un bloque incompleto descartados" << std::endl;
+                if (ftruncate(fd, s->finValido) != 0) {
+                    REGISTRO_ERROR("[Almacen] No se pudo truncar " << ruta);
+                }
+            }
+            return s;
+        }
+
+        if (nombre == nullptr) {
+            // Descubierto al listar el directorio, pero vacío: nada que restaurar
+            cerrarSerie(s);
+            return nullptr;
+        }
+
+        // Archivo nuevo: solo la cabecera
+        s->tipo = tipo;
+        s->largoNombre = static_cast<int>(strlen(nombre));
+        memcpy(s->nombre, nombre, s->largoNombre + 1);
+        s->hidratada = true;
+
+        unsigned char cabecera[8 + LARGO_MAXIMO_ID];
+        memcpy(cabecera, MAGIA_SEGMENTO, 4);
+        cabecera[4] = VERSION_SEGMENTO;
+        cabecera[5] = static_cast<unsigned char>(tipo);
+        cabecera[6] = static_cast<unsigned char>(s->largoNombre);
+        cabecera[7] = 0;
+        memcpy(cabecera + 8, nombre, s->largoNombre);
+        if (write(fd, cabecera, 8 + s->largoNombre) != 8 + s->largoNombre) {
+            REGISTRO_ERROR("[Almacen] No se pudo escribir la cabecera de " << ruta);
+        }
+        return s;
+    }
+
+    static void cerrarSerie(Serie* s) {
+        if (s->mapa != nullptr) {
+            munmap(s->mapa, s->largoMapa);
+        }
+        close(s->fd);
+        delete s;
+    }
+
+    /**
+     * @brief Serie ya abierta de un ID, o nullptr
+     * @param identificador El ID internado, o IDENTIFICADOR_DESCONOCIDO
+     *        para buscarlo por su texto
+     *
+     * NOTA: Un ID que nunca se internó no puede tener serie: agregarSerie
+     * interna el nombre de cada una.
+     */
+    Serie* serieExistente(const char* nombre, int largo, unsigned int identificador) const {
+        if (identificador == IDENTIFICADOR_DESCONOCIDO) {
+            identificador = TablaIdentificadores::global().buscar(nombre, largo);
+        }
+        if (identificador >= capacidadIdentificadores) {
+            return nullptr;  // incluye IDENTIFICADOR_DESCONOCIDO
+        }
+        return porIdentificador[identificador];
+    }
+
+    /**
+     * @brief Serie de un sensor, creándola la primera vez
+     */
+    Serie* serieDe(const LecturaParseada& l) {
+        Serie* s = serieExistente(l.id, l.largoId, l.identificador);
+        if (s != nullptr) {
+            return s;
+        }
+
+        char copia[LARGO_MAXIMO_ID + 1];
+        memcpy(copia, l.id, l.largoId);
+        copia[l.largoId] = '\0';
+        char ruta[512];
+        rutaDe(copia, ruta, sizeof(ruta));
+        s = abrirSerie(ruta, copia, l.tipo);
+        if (s != nullptr) {
+            agregarSerie(s);
+        }
+        return s;
+    }
+
+    /**
+     * @brief Comprime las lecturas pendientes de una serie y las agrega al archivo
+     */
+    static void escribirBloque(Serie* s) {
+        if (s->pendientes == 0) {
+            return;
+        }
+
+        const int maximo = CABECERA_BLOQUE_SEGMENTO +
+            (LECTURAS_POR_BLOQUE_SEGMENTO * (CodificadorDeltaDelta::MAXIMO_BITS * 2) + 7) / 8;
+        unsigned char bloque[maximo];
+        EscritorBits bits(bloque + CABECERA_BLOQUE_SEGMENTO, maximo - CABECERA_BLOQUE_SEGMENTO);
+
+        CodificadorDeltaDelta marcas;
+        for (int i = 0; i < s->pendientes; i++) {
+            marcas.escribir(bits, s->marcas[i]);
+        }
+        if (s->tipo == 'T') {
+            CodificadorXor valores;
+            for (int i = 0; i < s->pendientes; i++) {
+                valores.escribir(bits, static_cast<float>(s->valores[i]));
+            }
+        } else {
+            CodificadorDeltaDelta valores;
+            for (int i = 0; i < s->pendientes; i++) {
+                valores.escribir(bits, static_cast<long long>(s->valores[i]));
+            }
+        }
+
+        int carga = bits.bytesUsados();
+        escribirU32(bloque, static_cast<unsigned int>(carga));
+        bloque[4] = static_cast<unsigned char>(s->pendientes);
+        bloque[5] = static_cast<unsigned char>(s->pendientes >> 8);
+        unsigned short crc = calcularCrc16(bloque + CABECERA_BLOQUE_SEGMENTO, carga);
+        bloque[6] = static_cast<unsigned char>(crc);
+        bloque[7] = static_cast<unsigned char>(crc >> 8);
+        escribirI64(bloque + 8, s->marcas[0]);
+        escribirI64(bloque + 16, s->marcas[s->pendientes - 1]);
+
+        int total = CABECERA_BLOQUE_SEGMENTO + carga;
+        if (write(s->fd, bloque, total) != total) {
+            REGISTRO_ERROR("[Almacen] Escritura incompleta en el segmento de " << s->nombre);
+        }
+        s->bloquesEscritos++;
+        s->pendientes = 0;
+    }
+
+    /**
+     * @brief Decodifica los bloques mapeados de una serie en orden
+     * @tparam Visitante Invocable como f(long long marcaSistemaMs, double valor)
+     * @return Lecturas visitadas
+     */
+    template <typename Visitante>
+    static int decodificar(const Serie* s, Visitante f) {
+        int visitadas = 0;
+        long long marcas[LECTURAS_POR_BLOQUE_SEGMENTO];
+        long long pos = s->inicioBloques;
+        while (pos < s->finValido) {
+            const unsigned char* p = s->mapa + pos;
+            int carga = static_cast<int>(leerU32(p));
+            int lecturas = leerU16(p + 4);  // validar() ya lo acotó
+            LectorBits bits(p + CABECERA_BLOQUE_SEGMENTO, carga);
+
+            CodificadorDeltaDelta lectorMarcas;
+            for (int i = 0; i < lecturas; i++) {
+                marcas[i] = lectorMarcas.leer(bits);
+            }
+            if (s->tipo == 'T') {
+                CodificadorXor lectorValores;
+                for (int i = 0; i < lecturas; i++) {
+                    f(marcas[i], static_cast<double>(lectorValores.leer(bits)));
+                }
+            } else {
+                CodificadorDeltaDelta lectorValores;
+                for (int i = 0; i < lecturas; i++) {
+                    f(marcas[i], static_cast<double>(lectorValores.leer(bits)));
+                }
+            }
+            visitadas += lecturas;
+            pos += CABECERA_BLOQUE_SEGMENTO + carga;
+        }
+        return visitadas;
+    }
+
+    /**
+     * @brief Vuelca una serie mapeada al sensor, antes de sus lecturas nuevas
+     *
+     * RAZÓN: En los tipos conocidos se arma un lote con las marcas
+     * traducidas al reloj monotónico y el sensor lo adopta entero
+     * (adoptarAnteriores); los demás reciben las lecturas una a una.
+     */
+    struct Hidratar {
+        const Serie* serie;
+        long long desfase;  ///< reloj del sistema - reloj monotónico
+        int* lecturas;
+
+        template <typename S, typename U>
+        void volcar(S& sensor) const {
+            ListaSensorBloques<U> lote;
+            long long d = desfase;
+            *lecturas = decodificar(serie, [&lote, d](long long marca, double valor) {
+                lote.insertarAlFinal(static_cast<U>(valor), marca - d);
+            });
+            sensor.adoptarAnteriores(lote);
+        }
+
+        template <typename H>
+        void operator()(SensorTemperaturaCon<H>& sensor) const {
+            volcar<SensorTemperaturaCon<H>, float>(sensor);
+        }
+
+        template <typename H>
+        void operator()(SensorPresionCon<H>& sensor) const {
+            volcar<SensorPresionCon<H>, int>(sensor);
+        }
+
+        void operator()(SensorBase& sensor) const {
+            *lecturas = decodificar(serie, [&sensor](long long, double valor) {
+                sensor.agregarLectura(valor);
+            });
+        }
+    };
+
+    /**
+     * @brief Vuelca al sensor su serie mapeada, si todavía no lo hizo
+     *
+     * NOTA: El gestor la llama con el cerrojo del sensor tomado y aquí se
+     * toma el del almacén: siempre en ese orden (ninguna función del
+     * almacén espera a un sensor).
+     */
+    template <typename S>
+    int hidratarSensor(S& sensor) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        Serie* s = serieExistente(sensor.obtenerNombre(), static_cast<int>(strlen(sensor.obtenerNombre())),
+                                  sensor.obtenerIdentificador());
+        if (s == nullptr || s->hidratada) {
+            return 0;
+        }
+        int lecturas = 0;
+        Hidratar volcado = {s, relojSistemaMs() - relojMonotonicoMs(), &lecturas};
+        volcado(sensor);
+        s->hidratada = true;
+        lecturasHidratadas += lecturas;
+        seriesHidratadas++;
+
+        // Lo mapeado ya vive en el sensor; se devuelven las páginas
+        munmap(s->mapa, s->largoMapa);
+        s->mapa = nullptr;
+        s->largoMapa = 0;
+        return lecturas;
+    }
+
+public:
+    /**
+     * @brief Constructor: almacén inactivo hasta llamar a abrir()
+     */
+    AlmacenSegmentos()
+        : series(nullptr), cantidad(0), capacidad(0),
+          porIdentificador(nullptr), capacidadIdentificadores(0),
+          lecturasHidratadas(0), seriesHidratadas(0) {
+        directorio[0] = '\0';
+    }
+
+    /**
+     * @brief Destructor: escribe lo pendiente y cierra los archivos
+     */
+    ~AlmacenSegmentos() {
+        sincronizar();
+        for (int i = 0; i < cantidad; i++) {
+            cerrarSerie(series[i]);
+        }
+        delete[] series;
+        delete[] porIdentificador;
+    }
+
+    AlmacenSegmentos(const AlmacenSegmentos&) = delete;
+    AlmacenSegmentos& operator=(const AlmacenSegmentos&) = delete;
+
+    /**
+     * @brief Activa el almacén y mapea los segmentos que ya existan
+     * @param dir Directorio de los archivos (se crea si no existe)
+     * @return Segmentos encontrados, o -1 si el directorio no se puede usar
+     *
+     * COMPLEJIDAD: O(archivos + bloques): de cada bloque solo se lee la
+     * cabecera y se verifica el CRC; ningún valor se decodifica.
+     */
+    int abrir(const char* dir) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        snprintf(directorio, sizeof(directorio), "%s", dir);
+        mkdir(directorio, 0755);
+
+        DIR* d = opendir(directorio);
+        if (d == nullptr) {
+            std::cerr << "[Almacen] No se pudo abrir el directorio " << directorio << std::endl;
+            directorio[0] = '\0';
+            return -1;
+        }
+
+        int encontrados = 0;
+        struct dirent* entrada;
+        while ((entrada = readdir(d)) != nullptr) {
+            int largo = static_cast<int>(strlen(entrada->d_name));
+            if (largo <= 4 || strcmp(entrada->d_name + largo - 4, ".seg") != 0) {
+                continue;
+            }
+            char ruta[512];
+            snprintf(ruta, sizeof(ruta), "%s/%s", directorio, entrada->d_name);
+            Serie* s = abrirSerie(ruta, nullptr, 0);
+            if (s != nullptr) {
+                agregarSerie(s);
+                encontrados++;
+            }
+        }
+        closedir(d);
+
+        // readdir no garantiza orden; se restaura siempre en orden de nombre
+        for (int i = 1; i < cantidad; i++) {
+            Serie* s = series[i];
+            int j = i - 1;
+            for (; j >= 0 && strcmp(series[j]->nombre, s->nombre) > 0; j--) {
+                series[j + 1] = series[j];
+            }
+            series[j + 1] = s;
+        }
+        return encontrados;
+    }
+
+    /**
+     * @brief Indica si abrir() tuvo éxito
+     */
+    bool activo() const {
+        return directorio[0] != '\0';
+    }
+
+    /**
+     * @brief Marca más reciente entre los bloques sanos abiertos (-1 si no hay)
+     */
+    long long marcaMaxima() {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        long long maxima = -1;
+        for (int i = 0; i < cantidad; i++) {
+            if (series[i]->marcaGuardada > maxima) {
+                maxima = series[i]->marcaGuardada;
+            }
+        }
+        return maxima;
+    }
+
+    /**
+     * @brief Registra en el gestor un sensor por cada segmento mapeado
+     * @tparam Fabrica Invocable como SensorBase* (char tipo, const char* nombre)
+     * @param gestor Gestor donde se registran
+     * @param crearSensor Crea el sensor vacío (nullptr para omitirlo)
+     * @return Sensores registrados
+     *
+     * NOTA: No decodifica nada. Cada sensor queda marcado
+     * (SensorBase::marcarHistorialGuardado) y el gestor le pide su
+     * historial a este almacén la primera vez que lo usa; antes hay que
+     * darle el almacén con GestorSensores::usarFuenteHistorial.
+     */
+    template <typename Fabrica>
+    int restaurar(GestorSensores& gestor, Fabrica crearSensor) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        int registrados = 0;
+        for (int i = 0; i < cantidad; i++) {
+            Serie* s = series[i];
+            if (s->hidratada || gestor.buscarSensor(s->nombre, s->largoNombre) != nullptr) {
+                continue;
+            }
+            SensorBase* sensor = crearSensor(s->tipo, s->nombre);
+            if (sensor == nullptr) {
+                continue;
+            }
+            sensor->marcarHistorialGuardado();
+            if (gestor.registrarSiFalta(sensor) != sensor) {
+                delete sensor;
+            }
+            std::cout << "[Almacen] Restaurado " << s->nombre << ": " << s->lecturasMapeadas
+                      << " lectura(s) en " << s->bloquesMapeados << " bloque(s)" << std::endl;
+            registrados++;
+        }
+        return registrados;
+    }
+
+    /**
+     * @brief Decodifica el historial guardado de un sensor y se lo entrega
+     * @return Lecturas recuperadas (0 si no había o ya estaba hidratado)
+     */
+    int hidratar(SensorTemperatura& sensor) override {
+        return hidratarSensor(sensor);
+    }
+
+    int hidratar(SensorTemperaturaAcotado& sensor) override {
+        return hidratarSensor(sensor);
+    }
+
+    int hidratar(SensorPresion& sensor) override {
+        return hidratarSensor(sensor);
+    }
+
+    int hidratar(SensorPresionAcotado& sensor) override {
+        return hidratarSensor(sensor);
+    }
+
+    int hidratar(SensorBase& sensor) override {
+        return hidratarSensor(sensor);
+    }
+
+    /**
+     * @brief Guarda un lote de lecturas recién recibidas
+     * @param lecturas Lecturas ya parseadas (tipos distintos de 'T' y 'P' se omiten)
+     * @param n Lecturas del lote
+     *
+     * NOTA: Todo el lote lleva la misma marca, igual que en el historial
+     * en memoria (ver ListaSensorBloques::insertarVarios).
+     */
+    void anotarLote(const LecturaParseada* lecturas, int n) {
+        anotarLote(lecturas, n, relojSistemaMs());
+    }
+
+    /**
+     * @brief Guarda un lote con una marca dada (la que le asignó la bitácora)
+     * @param marca Milisegundos del reloj del sistema
+     */
+    void anotarLote(const LecturaParseada* lecturas, int n, long long marca) {
+        if (!activo() || n <= 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        for (int i = 0; i < n; i++) {
+            const LecturaParseada& l = lecturas[i];
+            if (l.tipo != 'T' && l.tipo != 'P') {
+                continue;
+            }
+            Serie* s = serieDe(l);
+            if (s == nullptr) {
+                continue;
+            }
+            s->marcas[s->pendientes] = marca;
+            s->valores[s->pendientes] = s->tipo == 'T' ? l.decimal : static_cast<double>(l.entero);
+            if (++s->pendientes == LECTURAS_POR_BLOQUE_SEGMENTO) {
+                escribirBloque(s);
+            }
+        }
+    }
+
+    /**
+     * @brief Guarda una lectura recién recibida
+     */
+    void anotar(const LecturaParseada& lectura) {
+        anotarLote(&lectura, 1);
+    }
+
+    /**
+     * @brief Escribe los bloques a medio llenar de todos los sensores
+     * @param aDisco true para además forzarlos al disco (fdatasync)
+     *
+     * NOTA: Sin 'aDisco' los datos quedan en el sistema operativo; un
+     * corte de luz puede perder lo último escrito. La bitácora
+     * (BitacoraEscritura.h) llama con true antes de descartar registros.
+     */
+    void sincronizar(bool aDisco = false) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        for (int i = 0; i < cantidad; i++) {
+            escribirBloque(series[i]);
+            if (aDisco) {
+                fdatasync(series[i]->fd);
+            }
+        }
+        if (aDisco && activo()) {
+            sincronizarDirectorio(directorio);
+        }
+    }
+
+    /**
+     * @brief Copia las lecturas de un lote recuperado que aún no estaban en disco
+     * @param lecturas Lote tal como lo guardó la bitácora
+     * @param n Lecturas del lote
+     * @param marca Marca del lote
+     * @param nuevas Recibe las lecturas que faltan (capacidad n)
+     * @return Lecturas copiadas en 'nuevas'
+     *
+     * CONCEPTO: La bitácora y los segmentos reciben lo mismo y en el
+     * mismo orden, con marcas que nunca retroceden. Por eso, para un
+     * sensor, todo lo anterior a su última marca en disco ya está, y de
+     * esa misma marca están las primeras 'repetidasGuardadas'.
+     *
+     * NOTA: Solo tiene sentido justo después de abrir(), antes de anotar.
+     */
+    int descartarGuardadas(const LecturaParseada* lecturas, int n, long long marca,
+                           LecturaParseada* nuevas) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        int copiadas = 0;
+        for (int i = 0; i < n; i++) {
+            const LecturaParseada& l = lecturas[i];
+            Serie* s = serieExistente(l.id, l.largoId, l.identificador);
+            if (s != nullptr && s->bloquesMapeados > 0) {
+                if (marca < s->marcaGuardada) {
+                    continue;
+                }
+                if (marca == s->marcaGuardada && s->repetidasGuardadas > 0) {
+                    s->repetidasGuardadas--;
+                    continue;
+                }
+            }
+            nuevas[copiadas++] = l;
+        }
+        return copiadas;
+    }
+
+    /**
+     * @brief Recorre lo guardado de un sensor sin cargarlo en su historial
+     * @tparam Visitante Invocable como f(long long marcaSistemaMs, double valor)
+     * @return Lecturas visitadas (solo las que estaban al abrir y aún no se hidrataron)
+     */
+    template <typename Visitante>
+    int recorrer(const char* nombre, Visitante f) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        const Serie* s = serieExistente(nombre, static_cast<int>(strlen(nombre)), IDENTIFICADOR_DESCONOCIDO);
+        return s != nullptr && s->mapa != nullptr ? decodificar(s, f) : 0;
+    }
+
+    /**
+     * @brief Imprime un resumen del espacio usado por cada segmento
+     */
+    void informar() {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        if (!activo()) {
+            return;
+        }
+        std::cout << "[Almacen] " << lecturasHidratadas << " lectura(s) recuperadas del disco ("
+                  << seriesHidratadas << " segmento(s) hidratados)\n";
+        std::cout << "[Almacen] " << cantidad << " segmento(s) en " << directorio << std::endl;
+        for (int i = 0; i < cantidad; i++) {
+            struct stat info;
+            long long bytes = fstat(series[i]->fd, &info) == 0 ? info.st_size : 0;
+            std::cout << "  " << series[i]->nombre << ": " << bytes << " byte(s), "
+                      << series[i]->bloquesEscritos << " bloque(s) nuevos" << std::endl;
+        }
+    }
+};
+
+#endif
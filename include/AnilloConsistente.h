@@ -0,0 +1,160 @@
+/**
+ * @file AnilloConsistente.h
+ * @brief Reparto de IDs de sensor entre fragmentos con hashing consistente
+ * @details Cada fragmento (un proceso trabajador, local o en otra máquina)
+ *          ocupa muchos puntos de un anillo de 32 bits; un ID pertenece al
+ *          primer punto que encuentra avanzando desde su propio hash.
+ */
+
+#ifndef ANILLO_CONSISTENTE_H
+#define ANILLO_CONSISTENTE_H
+
+#include "TablaIdentificadores.h"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @class AnilloConsistente
+ * @brief Decide qué fragmento es dueño de cada ID
+ *
+ * CONCEPTO - Hashing consistente:
+ * Con "hash % n" agregar un fragmento cambia el dueño de casi todos los
+ * IDs. En el anillo, un fragmento nuevo solo se queda con los tramos
+ * que caen justo antes de sus puntos: en promedio 1/(n+1) de los IDs
+ * cambian de dueño y el resto sigue donde estaba.
+ *
+ * CONCEPTO - Nodos virtuales:
+ * Con un solo punto por fragmento los tramos salen muy desparejos.
+ * Cada fragmento pone 'virtuales' puntos (128 por defecto), y la carga
+ * de cada uno se acerca a 1/n.
+ *
+ * RAZÓN de ubicar los puntos por NOMBRE y no por número de fragmento:
+ * El mismo nodo ("10.0.0.7:7000") cae en los mismos lugares aunque
+ * cambie su posición en la línea de comandos.
+ *
+ * COMPLEJIDAD:
+ * - fragmentoDe: O(largo del ID) para el hash + O(log puntos) de búsqueda
+ * - agregar: O(puntos · log puntos) (se reordena el anillo completo)
+ *
+ * USO:
+ *   AnilloConsistente anillo;
+ *   anillo.agregar("local-0", 0);
+ *   anillo.agregar("10.0.0.7:7000", 1);
+ *   int dueño = anillo.fragmentoDe("T-001", 5);  // 0 o 1
+ */
+class AnilloConsistente {
+public:
+    static const int VIRTUALES_POR_DEFECTO = 128;
+
+private:
+    /**
+     * @brief Un punto del anillo: posición y a qué fragmento pertenece
+     */
+    struct Punto {
+        unsigned int posicion;
+        int fragmento;
+
+        bool operator<(const Punto& otro) const {
+            return posicion < otro.posicion;
+        }
+    };
+
+    Punto* puntos;   ///< Ordenados por posición
+    int cantidad;
+    int capacidad;
+
+    /**
+     * @brief Mezcla final de MurmurHash3 (fmix32)
+     *
+     * RAZÓN: FNV-1a deja los bits altos poco mezclados para IDs que solo
+     * difieren en el último carácter ("T-001", "T-002"); sin esto caen
+     * en puntos vecinos del anillo y van casi todos al mismo fragmento.
+     */
+    static unsigned int mezclar(unsigned int h) {
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+public:
+    AnilloConsistente() : puntos(nullptr), cantidad(0), capacidad(0) {}
+
+    ~AnilloConsistente() {
+        delete[] puntos;
+    }
+
+    AnilloConsistente(const AnilloConsistente&) = delete;
+    AnilloConsistente& operator=(const AnilloConsistente&) = delete;
+
+    /**
+     * @brief Posición de un ID en el anillo
+     */
+    static unsigned int posicionDe(const char* id, int largo) {
+        return mezclar(TablaIdentificadores::calcularHash(id, largo));
+    }
+
+    /**
+     * @brief Agrega los puntos de un fragmento
+     * @param nombre Nombre estable del fragmento (decide dónde caen sus puntos)
+     * @param fragmento Número que devolverá fragmentoDe para sus IDs
+     * @param virtuales Puntos que ocupa en el anillo
+     */
+    void agregar(const char* nombre, int fragmento, int virtuales = VIRTUALES_POR_DEFECTO) {
+        if (cantidad + virtuales > capacidad) {
+            int nueva = capacidad == 0 ? virtuales : capacidad * 2;
+            while (nueva < cantidad + virtuales) {
+                nueva *= 2;
+            }
+            Punto* mayor = new Punto[nueva];
+            for (int i = 0; i < cantidad; i++) {
+                mayor[i] = puntos[i];
+            }
+            delete[] puntos;
+            puntos = mayor;
+            capacidad = nueva;
+        }
+
+        unsigned int base = TablaIdentificadores::calcularHash(nombre, static_cast<int>(strlen(nombre)));
+        for (int v = 0; v < virtuales; v++) {
+            Punto p;
+            p.posicion = mezclar(base ^ (static_cast<unsigned int>(v) * 0x9e3779b9u));
+            p.fragmento = fragmento;
+            puntos[cantidad++] = p;
+        }
+        std::sort(puntos, puntos + cantidad);
+    }
+
+    /**
+     * @brief Fragmento dueño de un ID
+     * @param id Primer carácter (no necesita terminar en '\0')
+     * @param largo Cantidad de caracteres
+     * @return Número de fragmento, o -1 si el anillo está vacío
+     */
+    int fragmentoDe(const char* id, int largo) const {
+        if (cantidad == 0) {
+            return -1;
+        }
+        Punto buscado;
+        buscado.posicion = posicionDe(id, largo);
+        buscado.fragmento = 0;
+        const Punto* p = std::lower_bound(puntos, puntos + cantidad, buscado);
+        // Pasado el último punto, el anillo da la vuelta al primero
+        if (p == puntos + cantidad) {
+            p = puntos;
+        }
+        return p->fragmento;
+    }
+
+    /**
+     * @brief Cantidad de puntos (fragmentos · virtuales)
+     */
+    int obtenerPuntos() const {
+        return cantidad;
+    }
+};
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file ArregloPublicado.h
+ * @brief Arreglo contiguo que crece sin invalidar a sus lectores
+ * @details Un solo escritor agrega al final; cualquier cantidad de hilos
+ *          puede leer al mismo tiempo sin cerrojos.
+ */
+
+#ifndef ARREGLO_PUBLICADO_H
+#define ARREGLO_PUBLICADO_H
+
+#include <atomic>
+
+/**
+ * @class ArregloPublicado
+ * @brief Arreglo dinámico de solo agregar, con publicación estilo RCU
+ * @tparam T Tipo de elemento (se copia al crecer)
+ *
+ * CONCEPTO:
+ * - Los elementos viven en un bloque contiguo, como en un vector
+ * - Al llenarse, se copia todo a un bloque del doble y se publica el
+ *   nuevo con un solo store; el viejo NO se libera (algún lector
+ *   puede estar recorriéndolo) sino que se encadena como 'retirado'
+ * - 'usados' se publica con release después de escribir el elemento
+ *
+ * LECTURA SEGURA:
+ *   int n = arreglo.tamaño();          // primero el tamaño...
+ *   const T* datos = arreglo.datos();  // ...después el bloque
+ *   for (int i = 0; i < n; i++) { ... datos[i] ... }
+ * En ese orden, el bloque obtenido tiene al menos 'n' elementos válidos.
+ *
+ * NOTA: Los bloques retirados suman menos que el vigente y se liberan
+ * en el destructor.
+ */
+template <typename T>
+class ArregloPublicado {
+private:
+    struct Bloque {
+        T* datos;
+        int capacidad;
+        Bloque* retirado;  ///< Bloque anterior, aún no liberado
+
+        explicit Bloque(int cap) : datos(new T[cap]), capacidad(cap), retirado(nullptr) {}
+        ~Bloque() { delete[] datos; }
+    };
+
+    std::atomic<Bloque*> actual;  ///< Bloque vigente
+    std::atomic<int> usados;      ///< Elementos válidos
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacidadInicial Elementos que caben antes del primer crecimiento
+     */
+    explicit ArregloPublicado(int capacidadInicial = 16)
+        : actual(new Bloque(capacidadInicial > 0 ? capacidadInicial : 1)), usados(0) {}
+
+    /**
+     * @brief Destructor: libera el bloque vigente y todos los retirados
+     */
+    ~ArregloPublicado() {
+        Bloque* b = actual.load(std::memory_order_relaxed);
+        while (b != nullptr) {
+            Bloque* retirado = b->retirado;
+            delete b;
+            b = retirado;
+        }
+    }
+
+    ArregloPublicado(const ArregloPublicado&) = delete;
+    ArregloPublicado& operator=(const ArregloPublicado&) = delete;
+
+    /**
+     * @brief Agrega un elemento al final
+     * @param valor Elemento a copiar
+     *
+     * NOTA: Un solo escritor a la vez; quien llama lo garantiza.
+     */
+    void agregar(const T& valor) {
+        Bloque* b = actual.load(std::memory_order_relaxed);
+        int n = usados.load(std::memory_order_relaxed);
+
+        if (n == b->capacidad) {
+            Bloque* nuevo = new Bloque(b->capacidad * 2);
+            for (int i = 0; i < n; i++) {
+                nuevo->datos[i] = b->datos[i];
+            }
+            nuevo->retirado = b;
+            actual.store(nuevo, std::memory_order_release);
+            b = nuevo;
+        }
+
+        b->datos[n] = valor;
+        usados.store(n + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Elementos publicados
+     */
+    int tamaño() const {
+        return usados.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Bloque vigente (leer tamaño() ANTES de llamar a este método)
+     */
+    const T* datos() const {
+        return actual.load(std::memory_order_acquire)->datos;
+    }
+};
+
+#endif
@@ -0,0 +1,729 @@
+/**
+ * @file BitacoraEscritura.h
+ * @brief Bitácora de escritura anticipada (WAL) con confirmación en grupo
+ * @details Toda lectura que se va a persistir se anota primero aquí. Un
+ *          hilo escritor junta lo anotado y hace un write() y un
+ *          fdatasync() por grupo, no por lectura. Al arrancar, lo que
+ *          quedó en la bitácora se reproduce en el gestor.
+ */
+
+#ifndef BITACORA_ESCRITURA_H
+#define BITACORA_ESCRITURA_H
+
+#include "AlmacenSegmentos.h"  // relojSistemaMs, escribirI64, sincronizarDirectorio
+#include "ParserTramas.h"
+#include "ProtocoloBinario.h"
+#include "Registro.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @class BitacoraEscritura
+ * @brief Registro secuencial y durable de los lotes de lecturas
+ *
+ * ARCHIVOS: '<directorio>/bitacora-NNNNNN.wal', de TAMAÑO_SEGMENTO bytes
+ * reservados de antemano (posix_fallocate).
+ *   Cabecera: "IOTW" | versión u8 | 0 0 0 | número u32 | primera secuencia u64
+ *             | salto u32
+ *   Registros: carga u32 | CRC-16 u16 | cantidad u16 | secuencia u64
+ *              | marca i64 | carga
+ *   Carga, por lectura: tipo u8 | largo u8 | ID | valor
+ *              (double de 8 bytes para 'T', entero de 4 bytes para 'P')
+ *
+ * RAZÓN de reservar los segmentos:
+ * - fdatasync no tiene que actualizar el tamaño del archivo (metadatos),
+ *   solo los datos: una escritura en disco por grupo, no dos
+ * - El espacio lleno de ceros marca el final: un registro con carga 0
+ *   termina la recuperación
+ *
+ * CONFIRMACIÓN EN GRUPO:
+ * anotarLote() solo copia a memoria (sin llamadas al sistema). El hilo
+ * escritor despierta cuando se juntan 'lecturasPorGrupo' lecturas o
+ * pasan 'latenciaMs' milisegundos, lo que ocurra primero. Con miles
+ * de lecturas por segundo, cada fdatasync cubre cientos de ellas.
+ *
+ * RECUPERACIÓN: Los segmentos se leen en orden. Un registro vale si su
+ * CRC coincide y su secuencia es la siguiente esperada. La primera de
+ * cada segmento está en su cabecera, así los restos de un segmento
+ * reciclado nunca se toman por registros nuevos.
+ *
+ * SALTO: Si un grupo no se pudo escribir, sus secuencias ya estaban
+ * asignadas. El segmento siguiente declara en 'salto' cuántas faltan
+ * antes de su primera secuencia, y la recuperación lo sigue leyendo en
+ * lugar de detenerse en el hueco.
+ *
+ * PUNTO DE CONTROL: Cuando los lotes ya están en disco en otro lado
+ * (AlmacenSegmentos::sincronizar(true)), los segmentos viejos se
+ * reciclan: se renombran para reusarlos sin volver a reservarlos.
+ *
+ * HILOS: Como SumideroAsincrono, un cerrojo para los datos en memoria y
+ * otro para el archivo; se anota mientras el escritor espera al disco.
+ */
+class BitacoraEscritura {
+public:
+    static const long long TAMAÑO_SEGMENTO = 4 * 1024 * 1024;
+    static const int CABECERA_SEGMENTO = 24;
+    static const int CABECERA_REGISTRO = 24;
+    static const int LECTURAS_POR_REGISTRO = 256;
+    static const int SEGMENTOS_ANTES_DE_CONTROL = 4;  ///< Vivos que piden un punto de control
+    static const int LIBRES_MAXIMOS = 2;              ///< Segmentos guardados para reciclar
+
+private:
+    char directorio[256];
+
+    // Protegido por 'cerrojoDatos'
+    std::mutex cerrojoDatos;
+    std::condition_variable hayTrabajo;
+    unsigned char* pendiente;       ///< Registros armados, aún no escritos
+    int usados;
+    int capacidad;
+    int lecturasPendientes;
+    unsigned long long siguienteSecuencia;
+    long long ultimaMarca;          ///< Para que las marcas nunca retrocedan
+    bool cerrando;
+
+    // Protegido por 'cerrojoArchivo' (solo lo toca quien escribe)
+    std::mutex cerrojoArchivo;
+    unsigned char* enVuelo;
+    int capacidadEnVuelo;
+    int fd;
+    unsigned int numeroActual;      ///< Segmento donde se escribe
+    unsigned int primerNumero;      ///< Segmento vivo más viejo
+    long long posicion;             ///< Próximo byte libre en el segmento actual
+    unsigned long long siguienteEnDisco;  ///< Secuencia que sigue a la última escrita
+    int libres;                     ///< Archivos 'libre-N.wal' listos para reciclar
+
+    std::atomic<unsigned int> segmentosVivos;
+    std::atomic<long long> grupos;
+    std::atomic<long long> lecturasEscritas;
+    std::atomic<int> grupoMaximo;
+    std::atomic<long long> lecturasPerdidas;  ///< Descartadas por no poder abrir un segmento
+
+    int lecturasPorGrupo;
+    int latenciaMs;
+    std::thread escritor;
+
+    void rutaSegmento(unsigned int numero, char* ruta, int largo) const {
+        snprintf(ruta, largo, "%s/bitacora-%06u.wal", directorio, numero);
+    }
+
+    void rutaLibre(int indice, char* ruta, int largo) const {
+        snprintf(ruta, largo, "%s/libre-%d.wal", directorio, indice);
+    }
+
+    /**
+     * @brief Cierra el segmento actual; el próximo se abrirá con otro número
+     */
+    void cerrarActual() {
+        if (fd >= 0) {
+            fdatasync(fd);
+            close(fd);
+            fd = -1;
+            numeroActual++;
+        }
+    }
+
+    /**
+     * @brief Cierra el segmento actual y abre el siguiente, reciclando si se puede
+     * @param secuenciaInicial Primera secuencia que tendrá el segmento
+     * @return false si el archivo no se pudo abrir: queda fd = -1 y el
+     *         próximo intento vuelve a probar con el mismo número
+     *
+     * NOTA: Si 'secuenciaInicial' pasa de 'siguienteEnDisco', la
+     * diferencia (secuencias descartadas) va en el campo 'salto'.
+     */
+    bool abrirSiguiente(unsigned long long secuenciaInicial) {
+        cerrarActual();
+
+        char ruta[512];
+        rutaSegmento(numeroActual, ruta, sizeof(ruta));
+        bool reciclado = false;
+        if (libres > 0) {
+            char libre[512];
+            rutaLibre(libres - 1, libre, sizeof(libre));
+            reciclado = rename(libre, ruta) == 0;
+            libres--;
+        }
+
+        fd = open(ruta, O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) {
+            REGISTRO_ERROR("[Bitacora] No se pudo abrir " << ruta << ": " << strerror(errno));
+            return false;
+        }
+        if (!reciclado && posix_fallocate(fd, 0, TAMAÑO_SEGMENTO) != 0) {
+            REGISTRO_ADVERTENCIA("[Bitacora] No se pudo reservar " << ruta);
+        }
+
+        unsigned char cabecera[CABECERA_SEGMENTO];
+        memset(cabecera, 0, sizeof(cabecera));
+        memcpy(cabecera, "IOTW", 4);
+        cabecera[4] = 1;
+        escribirU32(cabecera + 8, numeroActual);
+        escribirI64(cabecera + 12, static_cast<long long>(secuenciaInicial));
+        unsigned long long salto = secuenciaInicial - siguienteEnDisco;
+        escribirU32(cabecera + 20, salto > 0xFFFFFFFFULL ? 0xFFFFFFFFU : static_cast<unsigned int>(salto));
+        if (pwrite(fd, cabecera, sizeof(cabecera), 0) != CABECERA_SEGMENTO) {
+            REGISTRO_ERROR("[Bitacora] No se pudo escribir la cabecera de " << ruta);
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        fdatasync(fd);
+        sincronizarDirectorio(directorio);
+
+        posicion = CABECERA_SEGMENTO;
+        segmentosVivos.store(numeroActual - primerNumero + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Suma las lecturas de los registros armados en b[desde, hasta)
+     */
+    static int contarLecturas(const unsigned char* b, int desde, int hasta) {
+        int lecturas = 0;
+        while (desde < hasta) {
+            lecturas += leerU16(b + desde + 6);
+            desde += CABECERA_REGISTRO + static_cast<int>(leerU32(b + desde));
+        }
+        return lecturas;
+    }
+
+    /**
+     * @brief Escribe y confirma todo lo anotado (con 'cerrojoArchivo' tomado)
+     *
+     * PROCESO:
+     * 1. Tomar el buffer de pendientes y dejar uno vacío en su lugar
+     * 2. Escribir los registros con pwrite, pasando de segmento si uno
+     *    no entra entero en lo que queda del actual
+     * 3. Un solo fdatasync al final: desde ahí el grupo es durable
+     *
+     * ERRORES: Si el segmento siguiente no se puede abrir (disco lleno,
+     * permisos), un pwrite queda incompleto o un registro no entra ni en
+     * un segmento vacío, lo que faltaba escribir del grupo se descarta y
+     * se cuenta en 'lecturasPerdidas'; no se reintenta en un bucle. El
+     * segmento actual se cierra: el que abra el grupo siguiente declara
+     * las secuencias perdidas en su 'salto'.
+     */
+    void vaciarConCerrojo() {
+        int bytes;
+        int lecturas;
+        {
+            std::lock_guard<std::mutex> guardia(cerrojoDatos);
+            unsigned char* b = enVuelo;
+            enVuelo = pendiente;
+            pendiente = b;
+            int c = capacidadEnVuelo;
+            capacidadEnVuelo = capacidad;
+            capacidad = c;
+            bytes = usados;
+            lecturas = lecturasPendientes;
+            usados = 0;
+            lecturasPendientes = 0;
+        }
+        if (bytes == 0) {
+            return;
+        }
+
+        int desde = 0;
+        bool abierto = fd >= 0 || abrirSiguiente(static_cast<unsigned long long>(leerI64(enVuelo + 8)));
+        while (abierto && desde < bytes) {
+            // Juntar los registros que entran en el segmento actual
+            int hasta = desde;
+            int ultimo = desde;
+            while (hasta < bytes) {
+                int largo = CABECERA_REGISTRO + static_cast<int>(leerU32(enVuelo + hasta));
+                if (posicion + (hasta - desde) + largo > TAMAÑO_SEGMENTO) {
+                    break;
+                }
+                ultimo = hasta;
+                hasta += largo;
+            }
+            if (hasta == desde) {
+                // Si no entra ni en un segmento vacío, abrir otro no lo arregla
+                if (posicion == CABECERA_SEGMENTO ||
+                    !abrirSiguiente(static_cast<unsigned long long>(leerI64(enVuelo + desde + 8)))) {
+                    break;
+                }
+                continue;
+            }
+            if (pwrite(fd, enVuelo + desde, hasta - desde, posicion) != hasta - desde) {
+                REGISTRO_ERROR("[Bitacora] Escritura incompleta en el segmento " << numeroActual);
+                break;
+            }
+            posicion += hasta - desde;
+            siguienteEnDisco = static_cast<unsigned long long>(leerI64(enVuelo + ultimo + 8)) + 1;
+            desde = hasta;
+        }
+        if (desde < bytes) {
+            int perdidas = contarLecturas(enVuelo, desde, bytes);
+            lecturasPerdidas.fetch_add(perdidas, std::memory_order_relaxed);
+            lecturas -= perdidas;
+            REGISTRO_ERROR("[Bitacora] " << perdidas << " lectura(s) descartadas: sin segmento donde escribir");
+            // Lo que siga va a otro segmento, que declara el salto
+            cerrarActual();
+            if (lecturas == 0) {
+                return;
+            }
+        }
+        if (fd >= 0) {
+            fdatasync(fd);
+        }
+
+        grupos.fetch_add(1, std::memory_order_relaxed);
+        lecturasEscritas.fetch_add(lecturas, std::memory_order_relaxed);
+        if (lecturas > grupoMaximo.load(std::memory_order_relaxed)) {
+            grupoMaximo.store(lecturas, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Bucle del hilo escritor: un grupo por despertar
+     */
+    void escribirEnSegundoPlano() {
+        const std::chrono::milliseconds espera(static_cast<long>(latenciaMs));
+        std::unique_lock<std::mutex> guardia(cerrojoDatos);
+        while (!cerrando) {
+            hayTrabajo.wait_for(guardia, espera, [this]() {
+                return cerrando || lecturasPendientes >= lecturasPorGrupo;
+            });
+            if (usados > 0) {
+                guardia.unlock();
+                {
+                    std::lock_guard<std::mutex> guardiaArchivo(cerrojoArchivo);
+                    vaciarConCerrojo();
+                }
+                guardia.lock();
+            }
+        }
+    }
+
+    /**
+     * @brief Arma un registro al final de 'pendiente' (con 'cerrojoDatos' tomado)
+     */
+    void armarRegistro(const LecturaParseada* lecturas, int n, long long marca) {
+        int maximo = CABECERA_REGISTRO + n * (2 + LARGO_MAXIMO_ID + 8);
+        if (usados + maximo > capacidad) {
+            int nuevaCapacidad = capacidad * 2;
+            while (usados + maximo > nuevaCapacidad) {
+                nuevaCapacidad *= 2;
+            }
+            unsigned char* nuevo = new unsigned char[nuevaCapacidad];
+            memcpy(nuevo, pendiente, usados);
+            delete[] pendiente;
+            pendiente = nuevo;
+            capacidad = nuevaCapacidad;
+        }
+
+        unsigned char* registro = pendiente + usados;
+        unsigned char* p = registro + CABECERA_REGISTRO;
+        int cantidad = 0;
+        for (int i = 0; i < n; i++) {
+            const LecturaParseada& l = lecturas[i];
+            if (l.tipo != 'T' && l.tipo != 'P') {
+                continue;
+            }
+            *p++ = static_cast<unsigned char>(l.tipo);
+            *p++ = l.largoId;
+            memcpy(p, l.id, l.largoId);
+            p += l.largoId;
+            if (l.tipo == 'T') {
+                long long bits;
+                memcpy(&bits, &l.decimal, sizeof(bits));
+                escribirI64(p, bits);
+                p += 8;
+            } else {
+                escribirU32(p, static_cast<unsigned int>(l.entero));
+                p += 4;
+            }
+            cantidad++;
+        }
+        if (cantidad == 0) {
+            return;
+        }
+
+        int carga = static_cast<int>(p - registro) - CABECERA_REGISTRO;
+        escribirU32(registro, static_cast<unsigned int>(carga));
+        registro[6] = static_cast<unsigned char>(cantidad);
+        registro[7] = static_cast<unsigned char>(cantidad >> 8);
+        escribirI64(registro + 8, static_cast<long long>(siguienteSecuencia++));
+        escribirI64(registro + 16, marca);
+        unsigned short crc = calcularCrc16(registro + 6, CABECERA_REGISTRO - 6 + carga);
+        registro[4] = static_cast<unsigned char>(crc);
+        registro[5] = static_cast<unsigned char>(crc >> 8);
+
+        usados += CABECERA_REGISTRO + carga;
+        lecturasPendientes += cantidad;
+    }
+
+    /**
+     * @brief Decodifica la carga de un registro ya validado
+     * @return Lecturas escritas en 'lecturas'
+     */
+    static int leerCarga(const unsigned char* p, int carga, int cantidad, LecturaParseada* lecturas) {
+        const unsigned char* fin = p + carga;
+        int leidas = 0;
+        while (leidas < cantidad && p + 2 <= fin) {
+            LecturaParseada& l = lecturas[leidas];
+            l.tipo = static_cast<char>(p[0]);
+            l.largoId = p[1];
+            int bytesValor = l.tipo == 'T' ? 8 : 4;
+            if (l.largoId == 0 || l.largoId > LARGO_MAXIMO_ID || p + 2 + l.largoId + bytesValor > fin) {
+                break;
+            }
+            copiarIdLectura(l, reinterpret_cast<const char*>(p + 2), l.largoId);
+            p += 2 + l.largoId;
+            l.decimal = 0.0;
+            l.entero = 0;
+            if (l.tipo == 'T') {
+                long long bits = leerI64(p);
+                memcpy(&l.decimal, &bits, sizeof(bits));
+            } else {
+                l.entero = static_cast<int>(leerU32(p));
+            }
+            completarValores(l.tipo, l.decimal, l.entero);
+            p += bytesValor;
+            leidas++;
+        }
+        return leidas;
+    }
+
+    /**
+     * @brief Reproduce los registros válidos de un segmento
+     * @param esperada Secuencia esperada; avanza con cada registro
+     * @param primero true si es el primer segmento leído (fija la secuencia)
+     * @return false si la cabecera no continúa la secuencia
+     *
+     * NOTA: La cabecera continúa la secuencia si 'esperada' cae entre su
+     * primera secuencia menos el salto declarado y la primera misma. Lo
+     * segundo cubre registros de un pwrite incompleto que sí llegaron.
+     */
+    template <typename Reproductor>
+    bool reproducirSegmento(unsigned int numero, unsigned long long& esperada, bool primero,
+                            LecturaParseada* lecturas, long long& reproducidas, Reproductor& reproducir) {
+        char ruta[512];
+        rutaSegmento(numero, ruta, sizeof(ruta));
+        int f = open(ruta, O_RDONLY);
+        if (f < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(f, &info) != 0 || info.st_size < CABECERA_SEGMENTO) {
+            close(f);
+            return false;
+        }
+        void* mapa = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, f, 0);
+        close(f);
+        if (mapa == MAP_FAILED) {
+            return false;
+        }
+
+        const unsigned char* datos = static_cast<const unsigned char*>(mapa);
+        long long largo = info.st_size;
+        unsigned long long inicial = static_cast<unsigned long long>(leerI64(datos + 12));
+        unsigned long long salto = leerU32(datos + 20);
+        bool valido = memcmp(datos, "IOTW", 4) == 0 && leerU32(datos + 8) == numero &&
+                      (primero || (esperada <= inicial && esperada + salto >= inicial));
+        if (valido) {
+            esperada = inicial;
+            long long pos = CABECERA_SEGMENTO;
+            while (pos + CABECERA_REGISTRO <= largo) {
+                const unsigned char* r = datos + pos;
+                int carga = static_cast<int>(leerU32(r));
+                int cantidad = leerU16(r + 6);
+                if (carga == 0 || cantidad == 0 || cantidad > LECTURAS_POR_REGISTRO ||
+                    pos + CABECERA_REGISTRO + carga > largo ||
+                    static_cast<unsigned long long>(leerI64(r + 8)) != esperada ||
+                    calcularCrc16(r + 6, CABECERA_REGISTRO - 6 + carga) != leerU16(r + 4)) {
+                    break;
+                }
+                long long marca = leerI64(r + 16);
+                int n = leerCarga(r + CABECERA_REGISTRO, carga, cantidad, lecturas);
+                reproducir(static_cast<const LecturaParseada*>(lecturas), n, marca);
+                if (marca > ultimaMarca) {
+                    ultimaMarca = marca;
+                }
+                reproducidas += n;
+                esperada++;
+                pos += CABECERA_REGISTRO + carga;
+            }
+        }
+        munmap(mapa, largo);
+        return valido;
+    }
+
+public:
+    /**
+     * @brief Constructor: bitácora inactiva hasta llamar a abrir()
+     * @param porGrupo Lecturas que despiertan al escritor antes de tiempo
+     * @param latencia Espera máxima (ms) entre anotar y confirmar en disco
+     */
+    explicit BitacoraEscritura(int porGrupo = 512, int latencia = 5)
+        : pendiente(new unsigned char[64 * 1024]), usados(0), capacidad(64 * 1024),
+          lecturasPendientes(0), siguienteSecuencia(1), ultimaMarca(0), cerrando(false),
+          enVuelo(new unsigned char[64 * 1024]), capacidadEnVuelo(64 * 1024), fd(-1),
+          numeroActual(1), primerNumero(1), posicion(0), siguienteEnDisco(1), libres(0),
+          segmentosVivos(0), grupos(0), lecturasEscritas(0), grupoMaximo(0), lecturasPerdidas(0),
+          lecturasPorGrupo(porGrupo), latenciaMs(latencia) {
+        directorio[0] = '\0';
+    }
+
+    /**
+     * @brief Destructor: confirma lo pendiente y detiene al escritor
+     */
+    ~BitacoraEscritura() {
+        if (escritor.joinable()) {
+            {
+                std::lock_guard<std::mutex> guardia(cerrojoDatos);
+                cerrando = true;
+            }
+            hayTrabajo.notify_one();
+            escritor.join();
+        }
+        {
+            std::lock_guard<std::mutex> guardia(cerrojoArchivo);
+            vaciarConCerrojo();
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        delete[] pendiente;
+        delete[] enVuelo;
+    }
+
+    BitacoraEscritura(const BitacoraEscritura&) = delete;
+    BitacoraEscritura& operator=(const BitacoraEscritura&) = delete;
+
+    /**
+     * @brief Reproduce lo que quedó de la ejecución anterior y arranca el escritor
+     * @tparam Reproductor Invocable como f(const LecturaParseada*, int n, long long marca)
+     * @param dir Directorio de la bitácora (el mismo de los segmentos sirve)
+     * @param reproducir Recibe cada registro recuperado, en orden
+     * @return Lecturas reproducidas, o -1 si el directorio no se puede usar
+     *
+     * NOTA: Lo reproducido sigue en la bitácora hasta el primer
+     * puntoDeControl(); conviene hacerlo apenas se guardó en otro lado.
+     */
+    template <typename Reproductor>
+    long long abrir(const char* dir, Reproductor reproducir) {
+        std::lock_guard<std::mutex> guardiaArchivo(cerrojoArchivo);
+        snprintf(directorio, sizeof(directorio), "%s", dir);
+        mkdir(directorio, 0755);
+        DIR* d = opendir(directorio);
+        if (d == nullptr) {
+            std::cerr << "[Bitacora] No se pudo abrir el directorio " << directorio << std::endl;
+            directorio[0] = '\0';
+            return -1;
+        }
+
+        unsigned int menor = 0;
+        unsigned int mayor = 0;
+        struct dirent* entrada;
+        while ((entrada = readdir(d)) != nullptr) {
+            unsigned int numero;
+            char resto;
+            if (sscanf(entrada->d_name, "bitacora-%u.wa%c", &numero, &resto) == 2 && resto == 'l') {
+                if (menor == 0 || numero < menor) {
+                    menor = numero;
+                }
+                if (numero > mayor) {
+                    mayor = numero;
+                }
+            }
+        }
+        closedir(d);
+
+        // Los libres se numeran desde 0 sin huecos (ver puntoDeControl)
+        char libre[512];
+        rutaLibre(libres, libre, sizeof(libre));
+        while (libres < LIBRES_MAXIMOS && access(libre, F_OK) == 0) {
+            rutaLibre(++libres, libre, sizeof(libre));
+        }
+
+        long long reproducidas = 0;
+        unsigned long long esperada = 1;
+        if (mayor > 0) {
+            LecturaParseada* lecturas = new LecturaParseada[LECTURAS_POR_REGISTRO];
+            bool primero = true;
+            for (unsigned int numero = menor; numero <= mayor; numero++) {
+                if (!reproducirSegmento(numero, esperada, primero, lecturas, reproducidas, reproducir)) {
+                    break;  // Un hueco en la secuencia: lo que sigue no es confiable
+                }
+                primero = false;
+            }
+            delete[] lecturas;
+        }
+
+        {
+            std::lock_guard<std::mutex> guardia(cerrojoDatos);
+            siguienteSecuencia = esperada;
+        }
+        primerNumero = mayor > 0 ? menor : 1;
+        numeroActual = mayor + 1;
+        siguienteEnDisco = esperada;
+        abrirSiguiente(esperada);
+
+        escritor = std::thread(&BitacoraEscritura::escribirEnSegundoPlano, this);
+        return reproducidas;
+    }
+
+    /**
+     * @brief Impide que las próximas marcas sean menores a 'marca'
+     *
+     * USO: Con la última marca de los segmentos, por si el reloj del
+     * sistema volvió atrás entre dos ejecuciones.
+     */
+    void marcaMinima(long long marca) {
+        std::lock_guard<std::mutex> guardia(cerrojoDatos);
+        if (marca > ultimaMarca) {
+            ultimaMarca = marca;
+        }
+    }
+
+    /**
+     * @brief Indica si abrir() tuvo éxito
+     */
+    bool activa() const {
+        return directorio[0] != '\0';
+    }
+
+    /**
+     * @brief Anota un lote de lecturas (solo copia a memoria)
+     * @return Marca asignada al lote (ms del sistema, nunca menor que la anterior)
+     *
+     * NOTA: El lote es durable a más tardar 'latencia' ms después; quien
+     * necesite esperarlo llama a confirmar(). Lotes de más de
+     * LECTURAS_POR_REGISTRO lecturas se parten en varios registros.
+     */
+    long long anotarLote(const LecturaParseada* lecturas, int n) {
+        long long marca = relojSistemaMs();
+        if (!activa() || n <= 0) {
+            return marca;
+        }
+
+        bool avisar;
+        {
+            std::lock_guard<std::mutex> guardia(cerrojoDatos);
+            if (marca < ultimaMarca) {
+                marca = ultimaMarca;
+            }
+            ultimaMarca = marca;
+            for (int i = 0; i < n; i += LECTURAS_POR_REGISTRO) {
+                int tramo = n - i < LECTURAS_POR_REGISTRO ? n - i : LECTURAS_POR_REGISTRO;
+                armarRegistro(lecturas + i, tramo, marca);
+            }
+            avisar = lecturasPendientes >= lecturasPorGrupo;
+        }
+        if (avisar) {
+            hayTrabajo.notify_one();
+        }
+        return marca;
+    }
+
+    /**
+     * @brief Espera a que todo lo anotado hasta ahora esté en disco
+     */
+    void confirmar() {
+        std::lock_guard<std::mutex> guardia(cerrojoArchivo);
+        vaciarConCerrojo();
+    }
+
+    /**
+     * @brief Indica si ya hay suficientes segmentos como para un punto de control
+     */
+    bool pidePuntoDeControl() const {
+        return segmentosVivos.load(std::memory_order_relaxed) >=
+               static_cast<unsigned int>(SEGMENTOS_ANTES_DE_CONTROL);
+    }
+
+    /**
+     * @brief Descarta los segmentos cuyo contenido ya está guardado en otro lado
+     * @tparam Volcar Invocable sin parámetros que deja en disco todo lo
+     *         anotado hasta ahora (ej: almacen.sincronizar(true))
+     *
+     * PROCESO:
+     * 1. Confirmar lo pendiente y pasar a un segmento nuevo
+     * 2. volcar(): desde ahí, lo de los segmentos anteriores sobra
+     * 3. Renombrar hasta LIBRES_MAXIMOS de ellos para reciclar y borrar el resto
+     *
+     * NOTA: Llamar desde el hilo que anota, para que nada anotado en la
+     * bitácora falte todavía en el almacén cuando se vuelca.
+     */
+    template <typename Volcar>
+    void puntoDeControl(Volcar volcar) {
+        if (!activa()) {
+            volcar();
+            return;
+        }
+        std::lock_guard<std::mutex> guardia(cerrojoArchivo);
+        vaciarConCerrojo();
+        unsigned long long siguiente;
+        {
+            std::lock_guard<std::mutex> guardiaDatos(cerrojoDatos);
+            siguiente = siguienteSecuencia;
+        }
+        abrirSiguiente(siguiente);
+
+        volcar();
+
+        for (unsigned int numero = primerNumero; numero < numeroActual; numero++) {
+            char ruta[512];
+            rutaSegmento(numero, ruta, sizeof(ruta));
+            bool reciclado = false;
+            if (libres < LIBRES_MAXIMOS) {
+                char libre[512];
+                rutaLibre(libres, libre, sizeof(libre));
+                reciclado = rename(ruta, libre) == 0;
+                if (reciclado) {
+                    libres++;
+                }
+            }
+            if (!reciclado) {
+                unlink(ruta);
+            }
+        }
+        primerNumero = numeroActual;
+        segmentosVivos.store(1, std::memory_order_relaxed);
+        sincronizarDirectorio(directorio);
+    }
+
+    /**
+     * @brief Imprime cuántas lecturas cubrió cada confirmación en disco
+     */
+    void informar() const {
+        if (!activa()) {
+            return;
+        }
+        long long g = grupos.load(std::memory_order_relaxed);
+        long long l = lecturasEscritas.load(std::memory_order_relaxed);
+        std::cout << "[Bitacora] " << l << " lectura(s) en " << g << " confirmación(es) de grupo ("
+                  << (g > 0 ? l / g : 0) << " por fdatasync en promedio, máximo "
+                  << grupoMaximo.load(std::memory_order_relaxed) << ")" << std::endl;
+        long long perdidas = lecturasPerdidas.load(std::memory_order_relaxed);
+        if (perdidas > 0) {
+            std::cout << "[Bitacora] " << perdidas << " lectura(s) sin confirmar: no se pudo abrir un segmento\n";
+        }
+    }
+
+    /**
+     * @brief Lecturas anotadas que nunca llegaron a la bitácora por un error de apertura
+     */
+    long long obtenerLecturasPerdidas() const {
+        return lecturasPerdidas.load(std::memory_order_relaxed);
+    }
+};
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @file ColaSPSC.h
+ * @brief Cola circular sin bloqueos para un productor y un consumidor
+ * @details El hilo lector (productor) encola lecturas ya parseadas y el hilo
+ *          de procesamiento (consumidor) las saca por lotes. No usa mutex:
+ *          cada índice lo escribe un solo hilo y se publica con atomics.
+ */
+
+#ifndef COLA_SPSC_H
+#define COLA_SPSC_H
+
+#include <atomic>
+
+/**
+ * @class ColaSPSC
+ * @brief Cola "Single Producer, Single Consumer" de capacidad fija
+ * @tparam T Tipo de elemento (se copia al encolar y desencolar)
+ * @tparam CAPACIDAD Número de casillas; debe ser potencia de 2
+ *
+ * CONCEPTO - Sin bloqueos (lock-free):
+ * - 'escritura' solo la modifica el productor
+ * - 'lectura' solo la modifica el consumidor
+ * - Cada uno lee el índice del otro con memory_order_acquire y publica
+ *   el suyo con memory_order_release, así los datos de la casilla se
+ *   ven completos antes que el índice que los anuncia.
+ *
+ * RAZÓN del relleno de 64 bytes:
+ * Los dos índices quedan en líneas de caché distintas para que los
+ * hilos no se estorben al escribir cada uno el suyo (false sharing).
+ * Se usa relleno y no alignas(64) porque en C++11 'new' no garantiza
+ * alineaciones mayores a la normal.
+ *
+ * CONTADORES DE CONTRAPRESIÓN:
+ * - encoladas: elementos aceptados
+ * - rechazadas: intentos con la cola llena (el consumidor va atrasado)
+ * - maximaOcupacion: mayor cantidad de elementos pendientes observada
+ */
+template <typename T, int CAPACIDAD>
+class ColaSPSC {
+    static_assert(CAPACIDAD > 0 && (CAPACIDAD & (CAPACIDAD - 1)) == 0,
+                  "CAPACIDAD debe ser potencia de 2");
+
+private:
+    static const unsigned long MASCARA = CAPACIDAD - 1;
+
+    static const int LINEA_CACHE = 64;
+
+    std::atomic<unsigned long> escritura;  ///< Próxima casilla a escribir (productor)
+    char relleno1[LINEA_CACHE];
+    std::atomic<unsigned long> lectura;    ///< Próxima casilla a leer (consumidor)
+    char relleno2[LINEA_CACHE];
+
+    std::atomic<unsigned long> encoladas;        ///< Solo la escribe el productor
+    std::atomic<unsigned long> rechazadas;       ///< Solo la escribe el productor
+    std::atomic<unsigned long> maximaOcupacion;  ///< Solo la escribe el productor
+    char relleno3[LINEA_CACHE];
+
+    T casillas[CAPACIDAD];  ///< Almacenamiento circular
+
+public:
+    /**
+     * @brief Constructor: cola vacía con contadores en cero
+     */
+    ColaSPSC()
+        : escritura(0), lectura(0), encoladas(0), rechazadas(0), maximaOcupacion(0) {}
+
+    ColaSPSC(const ColaSPSC&) = delete;
+    ColaSPSC& operator=(const ColaSPSC&) = delete;
+
+    /**
+     * @brief Intenta encolar un elemento (solo desde el hilo productor)
+     * @param elemento Valor a copiar en la cola
+     * @return true si se encoló, false si la cola estaba llena
+     */
+    bool intentarEncolar(const T& elemento) {
+        unsigned long w = escritura.load(std::memory_order_relaxed);
+        unsigned long r = lectura.load(std::memory_order_acquire);
+        unsigned long ocupacion = w - r;
+
+        if (ocupacion == static_cast<unsigned long>(CAPACIDAD)) {
+            rechazadas.store(rechazadas.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        casillas[w & MASCARA] = elemento;
+        escritura.store(w + 1, std::memory_order_release);
+
+        encoladas.store(encoladas.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (ocupacion + 1 > maximaOcupacion.load(std::memory_order_relaxed)) {
+            maximaOcupacion.store(ocupacion + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Saca hasta 'maximo' elementos de una vez (solo desde el consumidor)
+     * @param destino Arreglo donde se copian los elementos
+     * @param maximo Tamaño de 'destino'
+     * @return Elementos copiados (0 si la cola estaba vacía)
+     *
+     * RAZÓN del lote: Se lee el índice del productor una sola vez
+     * y se publica el propio una sola vez por lote.
+     */
+    int desencolarLote(T* destino, int maximo) {
+        unsigned long r = lectura.load(std::memory_order_relaxed);
+        unsigned long w = escritura.load(std::memory_order_acquire);
+
+        unsigned long disponibles = w - r;
+        int n = disponibles < static_cast<unsigned long>(maximo)
+                    ? static_cast<int>(disponibles) : maximo;
+
+        for (int i = 0; i < n; i++) {
+            destino[i] = casillas[(r + i) & MASCARA];
+        }
+        lectura.store(r + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Elementos aceptados desde que se creó la cola
+     */
+    unsigned long obtenerEncoladas() const {
+        return encoladas.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Elementos descartados porque la cola estaba llena
+     */
+    unsigned long obtenerRechazadas() const {
+        return rechazadas.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Mayor cantidad de elementos pendientes que se llegó a tener
+     */
+    unsigned long obtenerMaximaOcupacion() const {
+        return maximaOcupacion.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Capacidad fija de la cola
+     */
+    int obtenerCapacidad() const {
+        return CAPACIDAD;
+    }
+};
+
+#endif
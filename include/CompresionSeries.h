@@ -0,0 +1,269 @@
+/**
+ * @file CompresionSeries.h
+ * @brief Compresión de series de tiempo para los segmentos en disco
+ * @details Marcas y enteros con delta de delta; decimales con XOR al
+ *          estilo Gorilla. Todo se escribe en un flujo de bits.
+ */
+
+#ifndef COMPRESION_SERIES_H
+#define COMPRESION_SERIES_H
+
+#include <cstring>
+
+/**
+ * @class EscritorBits
+ * @brief Agrega bits (del más significativo al menos) a un arreglo de bytes
+ *
+ * NOTA: Quien lo usa reserva el peor caso; escribir más allá de la
+ * capacidad se ignora y deja 'desbordado()' en true.
+ */
+class EscritorBits {
+private:
+    unsigned char* datos;
+    int capacidad;        ///< Bytes disponibles en 'datos'
+    long long bits;       ///< Bits escritos hasta ahora
+    bool desborde;
+
+public:
+    EscritorBits(unsigned char* destino, int bytes)
+        : datos(destino), capacidad(bytes), bits(0), desborde(false) {
+        memset(datos, 0, capacidad);
+    }
+
+    /**
+     * @brief Escribe los 'cantidad' bits más bajos de 'valor'
+     * @param cantidad Entre 1 y 64
+     */
+    void escribir(unsigned long long valor, int cantidad) {
+        for (int i = cantidad - 1; i >= 0; i--) {
+            long long byte = bits >> 3;
+            if (byte >= capacidad) {
+                desborde = true;
+                return;
+            }
+            if ((valor >> i) & 1u) {
+                datos[byte] |= static_cast<unsigned char>(0x80u >> (bits & 7));
+            }
+            bits++;
+        }
+    }
+
+    /**
+     * @brief Bytes ocupados (el último puede estar a medias)
+     */
+    int bytesUsados() const {
+        return static_cast<int>((bits + 7) >> 3);
+    }
+
+    bool desbordado() const {
+        return desborde;
+    }
+};
+
+/**
+ * @class LectorBits
+ * @brief Lee bits en el mismo orden en que EscritorBits los escribió
+ *
+ * NOTA: Leer más allá del final devuelve ceros y deja 'agotado()' en
+ * true, así un bloque dañado no lee fuera de su memoria.
+ */
+class LectorBits {
+private:
+    const unsigned char* datos;
+    int largo;
+    long long bits;
+    bool agotamiento;
+
+public:
+    LectorBits(const unsigned char* origen, int bytes)
+        : datos(origen), largo(bytes), bits(0), agotamiento(false) {}
+
+    unsigned long long leer(int cantidad) {
+        unsigned long long valor = 0;
+        for (int i = 0; i < cantidad; i++) {
+            long long byte = bits >> 3;
+            if (byte >= largo) {
+                agotamiento = true;
+                return 0;
+            }
+            valor = (valor << 1) | ((datos[byte] >> (7 - (bits & 7))) & 1u);
+            bits++;
+        }
+        return valor;
+    }
+
+    bool agotado() const {
+        return agotamiento;
+    }
+};
+
+/**
+ * @class CodificadorDeltaDelta
+ * @brief Codifica enteros que cambian poco o a ritmo constante
+ *
+ * CONCEPTO - Delta de delta:
+ * Con una lectura por segundo las marcas son t, t+1000, t+2000...
+ * El delta es siempre 1000 y el delta del delta es 0: un solo bit.
+ * Lo mismo vale para una presión que sube o baja de a pasos iguales.
+ *
+ * PREFIJOS (sobre el delta de delta en zigzag, sin signo):
+ *   '0'                 -> 0
+ *   '10'   +  7 bits    -> menor a 128
+ *   '110'  +  9 bits    -> menor a 512
+ *   '1110' + 12 bits    -> menor a 4096
+ *   '1111' + 64 bits    -> cualquier otro (incluye el primer valor)
+ *
+ * RAZÓN del zigzag: Lleva -1, 1, -2, 2... a 1, 2, 3, 4..., así los
+ * cambios chicos en cualquier dirección usan pocos bits.
+ */
+class CodificadorDeltaDelta {
+private:
+    // Sin signo: las restas dan la vuelta en vez de desbordar, y
+    // decodificar deshace la misma vuelta (aritmética módulo 2^64)
+    unsigned long long anterior;
+    unsigned long long deltaAnterior;
+
+    static unsigned long long zigzag(unsigned long long v) {
+        return (v << 1) ^ (0ULL - (v >> 63));
+    }
+
+    static unsigned long long desZigzag(unsigned long long v) {
+        return (v >> 1) ^ (0ULL - (v & 1u));
+    }
+
+public:
+    /**
+     * @brief Peor caso en bits de un valor
+     */
+    static const int MAXIMO_BITS = 68;
+
+    CodificadorDeltaDelta() : anterior(0), deltaAnterior(0) {}
+
+    void escribir(EscritorBits& salida, long long valor) {
+        unsigned long long actual = static_cast<unsigned long long>(valor);
+        unsigned long long delta = actual - anterior;
+        unsigned long long z = zigzag(delta - deltaAnterior);
+        if (z == 0) {
+            salida.escribir(0, 1);
+        } else if (z < 128) {
+            salida.escribir(2, 2);
+            salida.escribir(z, 7);
+        } else if (z < 512) {
+            salida.escribir(6, 3);
+            salida.escribir(z, 9);
+        } else if (z < 4096) {
+            salida.escribir(14, 4);
+            salida.escribir(z, 12);
+        } else {
+            salida.escribir(15, 4);
+            salida.escribir(z, 64);
+        }
+        anterior = actual;
+        deltaAnterior = delta;
+    }
+
+    long long leer(LectorBits& entrada) {
+        unsigned long long z = 0;
+        if (entrada.leer(1) != 0) {
+            if (entrada.leer(1) == 0) {
+                z = entrada.leer(7);
+            } else if (entrada.leer(1) == 0) {
+                z = entrada.leer(9);
+            } else if (entrada.leer(1) == 0) {
+                z = entrada.leer(12);
+            } else {
+                z = entrada.leer(64);
+            }
+        }
+        deltaAnterior += desZigzag(z);
+        anterior += deltaAnterior;
+        return static_cast<long long>(anterior);
+    }
+};
+
+/**
+ * @class CodificadorXor
+ * @brief Codifica floats de 32 bits con XOR contra el valor anterior
+ *
+ * CONCEPTO (Gorilla, Facebook 2015, adaptado a 32 bits):
+ * Dos temperaturas seguidas comparten signo, exponente y los primeros
+ * bits de la mantisa; su XOR es casi todo ceros. Se guardan solo los
+ * bits "significativos" del medio.
+ *   '0'                                 -> igual al anterior
+ *   '10' + bits en la ventana previa    -> cabe entre los ceros anteriores
+ *   '11' + 5 bits ceros a la izquierda
+ *        + 5 bits (largo - 1) + largo bits -> ventana nueva
+ *
+ * NOTA: El primer valor se compara contra 0, así que pasa completo
+ * por la rama de ventana nueva.
+ */
+class CodificadorXor {
+private:
+    unsigned int anterior;
+    int ceros;     ///< Ceros a la izquierda de la ventana vigente
+    int finales;   ///< Ceros a la derecha de la ventana vigente
+    bool ventana;  ///< false hasta que se abre la primera ventana
+
+    static unsigned int aBits(float v) {
+        unsigned int b;
+        memcpy(&b, &v, sizeof(b));
+        return b;
+    }
+
+    static float deBits(unsigned int b) {
+        float v;
+        memcpy(&v, &b, sizeof(v));
+        return v;
+    }
+
+public:
+    static const int MAXIMO_BITS = 44;
+
+    CodificadorXor() : anterior(0), ceros(0), finales(0), ventana(false) {}
+
+    void escribir(EscritorBits& salida, float valor) {
+        unsigned int bits = aBits(valor);
+        unsigned int x = bits ^ anterior;
+        anterior = bits;
+        if (x == 0) {
+            salida.escribir(0, 1);
+            return;
+        }
+
+        int izquierda = __builtin_clz(x);
+        int derecha = __builtin_ctz(x);
+        if (ventana && izquierda >= ceros && derecha >= finales) {
+            salida.escribir(2, 2);
+            salida.escribir(x >> finales, 32 - ceros - finales);
+            return;
+        }
+
+        // 5 bits alcanzan para 0..31 ceros: x != 0 nunca tiene 32
+        salida.escribir(3, 2);
+        salida.escribir(static_cast<unsigned int>(izquierda), 5);
+        salida.escribir(static_cast<unsigned int>(32 - izquierda - derecha - 1), 5);
+        salida.escribir(x >> derecha, 32 - izquierda - derecha);
+        ceros = izquierda;
+        finales = derecha;
+        ventana = true;
+    }
+
+    float leer(LectorBits& entrada) {
+        if (entrada.leer(1) != 0) {
+            if (entrada.leer(1) != 0) {
+                ceros = static_cast<int>(entrada.leer(5));
+                int largo = static_cast<int>(entrada.leer(5)) + 1;
+                finales = 32 - ceros - largo;
+                if (finales < 0) {
+                    // Solo con datos dañados; LectorBits ya no lee más allá
+                    finales = 0;
+                }
+            }
+            unsigned int x = static_cast<unsigned int>(entrada.leer(32 - ceros - finales)) << finales;
+            anterior ^= x;
+        }
+        return deBits(anterior);
+    }
+};
+
+#endif
@@ -0,0 +1,294 @@
+/**
+ * @file EscritorInforme.h
+ * @brief Escritor con buffer grande para los listados de sensores
+ * @details Formatea texto y números directamente en un buffer propio y
+ *          lo entrega al destino (un std::ostream o un descriptor) en
+ *          pocos bloques grandes, en vez de un operator<< y un vaciado
+ *          por línea.
+ */
+
+#ifndef ESCRITOR_INFORME_H
+#define ESCRITOR_INFORME_H
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+
+#include <unistd.h>
+
+/**
+ * @brief Qué incluir en un listado de sensores
+ *
+ * Por defecto se lista todo, igual que siempre se hizo.
+ */
+struct OpcionesInforme {
+    bool soloResumen;    ///< true = cantidad y estadísticas, sin las lecturas
+    int maximoLecturas;  ///< Últimas N lecturas por sensor (-1 = todas)
+
+    OpcionesInforme() : soloResumen(false), maximoLecturas(-1) {}
+};
+
+/**
+ * @class EscritorInforme
+ * @brief Buffer de salida con formateo propio de enteros y decimales
+ *
+ * RAZÓN: Un historial de un millón de lecturas pasaba por un millón de
+ * operator<< con su centinela, su locale y su num_put. Aquí cada valor
+ * es un puñado de divisiones sobre un buffer ya reservado, y el destino
+ * recibe el texto en bloques de 'capacidad' bytes.
+ *
+ * FORMATO: decimal() escribe lo mismo que operator<< con la precisión
+ * por defecto (%g con 6 cifras), así el listado no cambia. Los casos
+ * que el camino rápido no resuelve exacto (notación exponencial, un
+ * empate al redondear, NaN) pasan por snprintf.
+ *
+ * DESTINO:
+ * - std::ostream: un write() del flujo por bloque (std::cout ya va al
+ *   SumideroAsincrono, que junta los bloques en pocas llamadas)
+ * - descriptor: write(2) directo, reintentando si se interrumpe
+ *
+ * USO:
+ *   EscritorInforme salida(std::cout);
+ *   salida << "ID: " << nombre << '\n';
+ *   salida.decimal(45.3f);
+ *   // el destructor vacía lo pendiente
+ */
+class EscritorInforme {
+private:
+    char* buffer;
+    int capacidad;
+    int usados;
+    std::ostream* flujo;  ///< Destino, o nullptr si se escribe en 'fd'
+    int fd;
+    unsigned long long bytesEntregados;
+    int entregas;
+
+    /**
+     * @brief Garantiza 'n' bytes libres (n no puede superar la capacidad)
+     */
+    void reservar(int n) {
+        if (usados + n > capacidad) {
+            vaciar();
+        }
+    }
+
+    void escribirEnDescriptor(const char* p, int n) {
+        while (n > 0) {
+            ssize_t escritos = write(fd, p, static_cast<size_t>(n));
+            if (escritos < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            p += escritos;
+            n -= static_cast<int>(escritos);
+        }
+    }
+
+    /**
+     * @brief Camino lento de decimal(): el mismo formato que operator<<
+     */
+    void decimalConPrintf(double valor) {
+        reservar(32);
+        usados += snprintf(buffer + usados, 32, "%g", valor);
+    }
+
+public:
+    /**
+     * @brief Escritor hacia un flujo (std::cout, un ostringstream, ...)
+     * @param destino Flujo que recibe los bloques
+     * @param cap Bytes del buffer (como mínimo 64)
+     */
+    explicit EscritorInforme(std::ostream& destino, int cap = 1 << 18)
+        : capacidad(cap < 64 ? 64 : cap), usados(0), flujo(&destino), fd(-1),
+          bytesEntregados(0), entregas(0) {
+        buffer = new char[capacidad];
+    }
+
+    /**
+     * @brief Escritor hacia un descriptor ya abierto (archivo, tubería, socket)
+     * @param descriptor No se cierra al destruir el escritor
+     * @param cap Bytes del buffer (como mínimo 64)
+     */
+    explicit EscritorInforme(int descriptor, int cap = 1 << 18)
+        : capacidad(cap < 64 ? 64 : cap), usados(0), flujo(nullptr), fd(descriptor),
+          bytesEntregados(0), entregas(0) {
+        buffer = new char[capacidad];
+    }
+
+    ~EscritorInforme() {
+        vaciar();
+        delete[] buffer;
+    }
+
+    EscritorInforme(const EscritorInforme&) = delete;
+    EscritorInforme& operator=(const EscritorInforme&) = delete;
+
+    /**
+     * @brief Entrega al destino todo lo acumulado
+     */
+    void vaciar() {
+        if (usados == 0) {
+            return;
+        }
+        if (flujo != nullptr) {
+            flujo->write(buffer, usados);
+        } else {
+            escribirEnDescriptor(buffer, usados);
+        }
+        bytesEntregados += static_cast<unsigned long long>(usados);
+        entregas++;
+        usados = 0;
+    }
+
+    /**
+     * @brief Copia 'n' caracteres; si no caben en el buffer se entregan directo
+     */
+    void texto(const char* p, int n) {
+        if (n > capacidad - usados) {
+            vaciar();
+            if (n > capacidad) {
+                if (flujo != nullptr) {
+                    flujo->write(p, n);
+                } else {
+                    escribirEnDescriptor(p, n);
+                }
+                bytesEntregados += static_cast<unsigned long long>(n);
+                entregas++;
+                return;
+            }
+        }
+        memcpy(buffer + usados, p, static_cast<size_t>(n));
+        usados += n;
+    }
+
+    void texto(const char* cadena) {
+        texto(cadena, static_cast<int>(strlen(cadena)));
+    }
+
+    void caracter(char c) {
+        reservar(1);
+        buffer[usados++] = c;
+    }
+
+    /**
+     * @brief Entero en base 10, cifras generadas de atrás hacia adelante
+     */
+    void entero(long long valor) {
+        reservar(24);
+        unsigned long long magnitud = valor < 0 ? 0ULL - static_cast<unsigned long long>(valor)
+                                                : static_cast<unsigned long long>(valor);
+        char cifras[20];
+        int n = 0;
+        do {
+            cifras[n++] = static_cast<char>('0' + magnitud % 10);
+            magnitud /= 10;
+        } while (magnitud != 0);
+        if (valor < 0) {
+            buffer[usados++] = '-';
+        }
+        while (n > 0) {
+            buffer[usados++] = cifras[--n];
+        }
+    }
+
+    /**
+     * @brief Decimal con 6 cifras significativas, sin ceros de sobra (como %g)
+     *
+     * PROCESO (camino rápido, 1e-4 <= |v| < 999999.5):
+     * 1. Exponente e: la potencia de 10 tal que 10^e <= |v| < 10^(e+1)
+     * 2. Escalar a un entero de 6 cifras: r = redondear(|v| * 10^(5-e))
+     * 3. Escribir r con el punto 5-e lugares desde la derecha y quitar
+     *    los ceros finales (y el punto si no queda nada detrás)
+     */
+    void decimal(double valor) {
+        static const double POTENCIAS[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+        static const double LIMITES[] = {1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5};
+        double magnitud = std::fabs(valor);
+        if (!(magnitud >= 1e-4 && magnitud < 999999.5)) {
+            // Cero, notación exponencial, infinito o NaN
+            if (valor == 0.0 && !std::signbit(valor)) {
+                caracter('0');
+            } else {
+                decimalConPrintf(valor);
+            }
+            return;
+        }
+
+        int e = 5;
+        while (e > -4 && magnitud < LIMITES[e + 4]) {
+            e--;
+        }
+        int decimales = 5 - e;
+        double escalado = magnitud * POTENCIAS[decimales];
+        double fraccion = escalado - std::floor(escalado);
+        if (std::fabs(fraccion - 0.5) < 1e-6) {
+            // Empate aparente: solo el valor binario exacto decide
+            decimalConPrintf(valor);
+            return;
+        }
+        unsigned long long r = static_cast<unsigned long long>(escalado + 0.5);
+        if (r >= 1000000ULL) {
+            // Redondeó hacia arriba a una cifra más (p. ej., 9.999995 -> 10)
+            r /= 10;
+            decimales--;
+        }
+
+        reservar(24);
+        if (valor < 0) {
+            buffer[usados++] = '-';
+        }
+        char cifras[16];
+        int n = 0;
+        for (int i = 0; i < decimales; i++) {
+            cifras[n++] = static_cast<char>('0' + r % 10);
+            r /= 10;
+        }
+        // Los ceros finales de la parte decimal no se escriben
+        int inicioDecimales = 0;
+        while (inicioDecimales < decimales && cifras[inicioDecimales] == '0') {
+            inicioDecimales++;
+        }
+        do {
+            cifras[n++] = static_cast<char>('0' + r % 10);
+            r /= 10;
+        } while (r != 0);
+
+        while (n > decimales) {
+            buffer[usados++] = cifras[--n];
+        }
+        if (inicioDecimales < decimales) {
+            buffer[usados++] = '.';
+            while (n > inicioDecimales) {
+                buffer[usados++] = cifras[--n];
+            }
+        }
+    }
+
+    EscritorInforme& operator<<(const char* cadena) { texto(cadena); return *this; }
+    EscritorInforme& operator<<(char c) { caracter(c); return *this; }
+    EscritorInforme& operator<<(int valor) { entero(valor); return *this; }
+    EscritorInforme& operator<<(long valor) { entero(valor); return *this; }
+    EscritorInforme& operator<<(long long valor) { entero(valor); return *this; }
+    EscritorInforme& operator<<(float valor) { decimal(valor); return *this; }
+    EscritorInforme& operator<<(double valor) { decimal(valor); return *this; }
+
+    /**
+     * @brief Bytes entregados al destino hasta ahora (sin lo pendiente)
+     */
+    unsigned long long obtenerBytesEntregados() const {
+        return bytesEntregados;
+    }
+
+    /**
+     * @brief Cantidad de bloques entregados (escrituras al destino)
+     */
+    int obtenerEntregas() const {
+        return entregas;
+    }
+};
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file EstadisticasLista.h
+ * @brief Estadísticas incrementales para los historiales de sensores
+ * @details Mantiene suma, cantidad, mínimo, máximo y varianza (Welford)
+ *          conforme se insertan y eliminan valores, para que las listas
+ *          respondan promedio y extremos sin recorrerse.
+ */
+
+#ifndef ESTADISTICAS_LISTA_H
+#define ESTADISTICAS_LISTA_H
+
+#include <type_traits>
+
+/**
+ * @brief Tipo acumulador más ancho que T
+ * @tparam T Tipo de las lecturas
+ *
+ * RAZÓN: Sumar muchas lecturas int de ~1013 hPa desborda un int
+ * (2^31 / 1013 ≈ 2 millones de lecturas). Los enteros se acumulan
+ * en long long y los decimales en double.
+ */
+template <typename T>
+struct AcumuladorDe {
+    typedef typename std::conditional<std::is_integral<T>::value, long long, double>::type tipo;
+};
+
+/**
+ * @class EstadisticasLista
+ * @brief Agregados de una lista actualizados en O(1) por operación
+ * @tparam T Tipo de las lecturas
+ *
+ * CONCEPTO - Algoritmo de Welford:
+ * Actualiza la media y la suma de cuadrados de las diferencias (M2)
+ * con cada valor nuevo, sin guardar todos los valores y sin la pérdida
+ * de precisión de la fórmula "media de cuadrados - cuadrado de media".
+ * Al quitar un valor se aplica la actualización inversa.
+ *
+ * NOTA sobre mínimo y máximo:
+ * Al insertar se actualizan en O(1). Al eliminar, la lista dueña debe
+ * informar los nuevos extremos con fijarExtremos(), ya que solo ella
+ * conoce los valores que quedan.
+ */
+template <typename T>
+class EstadisticasLista {
+public:
+    typedef typename AcumuladorDe<T>::tipo Acumulador;
+
+private:
+    Acumulador suma;  ///< Suma de todos los valores en el acumulador ancho
+    int cantidad;     ///< Número de valores
+    T minimo;         ///< Valor más bajo (válido si cantidad > 0)
+    T maximo;         ///< Valor más alto (válido si cantidad > 0)
+    double media;     ///< Media de Welford
+    double m2;        ///< Suma de cuadrados de diferencias respecto a la media
+
+public:
+    /**
+     * @brief Constructor: estadísticas de una lista vacía
+     */
+    EstadisticasLista() { reiniciar(); }
+
+    /**
+     * @brief Vuelve al estado de lista vacía
+     */
+    void reiniciar() {
+        suma = 0;
+        cantidad = 0;
+        minimo = static_cast<T>(0);
+        maximo = static_cast<T>(0);
+        media = 0.0;
+        m2 = 0.0;
+    }
+
+    /**
+     * @brief Registra un valor insertado
+     * @param valor Valor agregado a la lista
+     */
+    void agregar(T valor) {
+        suma += valor;
+        cantidad++;
+
+        if (cantidad == 1 || valor < minimo) {
+            minimo = valor;
+        }
+        if (cantidad == 1 || maximo < valor) {
+            maximo = valor;
+        }
+
+        double delta = static_cast<double>(valor) - media;
+        media += delta / cantidad;
+        m2 += delta * (static_cast<double>(valor) - media);
+    }
+
+    /**
+     * @brief Registra un valor eliminado (suma, cantidad y varianza)
+     * @param valor Valor quitado de la lista
+     *
+     * IMPORTANTE: Después de llamar a quitar(), la lista debe llamar a
+     * fijarExtremos() si aún le quedan valores.
+     */
+    void quitar(T valor) {
+        suma -= valor;
+        cantidad--;
+
+        if (cantidad == 0) {
+            reiniciar();
+            return;
+        }
+
+        double x = static_cast<double>(valor);
+        double mediaAnterior = media;
+        media = (mediaAnterior * (cantidad + 1) - x) / cantidad;
+        m2 -= (x - mediaAnterior) * (x - media);
+        if (m2 < 0.0) {
+            m2 = 0.0;  // Evita negativos por redondeo
+        }
+    }
+
+    /**
+     * @brief Actualiza los extremos tras una eliminación
+     * @param nuevoMinimo Mínimo de los valores restantes
+     * @param nuevoMaximo Máximo de los valores restantes
+     */
+    void fijarExtremos(T nuevoMinimo, T nuevoMaximo) {
+        minimo = nuevoMinimo;
+        maximo = nuevoMaximo;
+    }
+
+    /**
+     * @brief Suma las estadísticas de otra lista, como si sus valores
+     *        se hubieran insertado aquí uno por uno
+     * @param otra Estadísticas de los valores agregados en bloque
+     *
+     * CONCEPTO - Combinación de Chan:
+     * Dos grupos con (n_a, media_a, M2_a) y (n_b, media_b, M2_b) dan
+     *   delta = media_b - media_a
+     *   media = media_a + delta * n_b / n
+     *   M2    = M2_a + M2_b + delta² * n_a * n_b / n
+     * sin volver a recorrer ningún valor.
+     */
+    void combinar(const EstadisticasLista& otra) {
+        if (otra.cantidad == 0) {
+            return;
+        }
+        if (cantidad == 0) {
+            *this = otra;
+            return;
+        }
+
+        int total = cantidad + otra.cantidad;
+        double delta = otra.media - media;
+        media += delta * otra.cantidad / total;
+        m2 += otra.m2 + delta * delta * (static_cast<double>(cantidad) * otra.cantidad / total);
+
+        suma += otra.suma;
+        cantidad = total;
+        if (otra.minimo < minimo) {
+            minimo = otra.minimo;
+        }
+        if (maximo < otra.maximo) {
+            maximo = otra.maximo;
+        }
+    }
+
+    /**
+     * @brief Promedio en el tipo de la lista
+     * @return suma / cantidad convertido a T, o 0 si está vacía
+     *
+     * NOTA: Para int la división es entera, igual que antes.
+     */
+    T promedio() const {
+        if (cantidad == 0) {
+            return static_cast<T>(0);
+        }
+        return static_cast<T>(suma / cantidad);
+    }
+
+    Acumulador obtenerSuma() const { return suma; }   ///< Suma acumulada
+    T obtenerMinimo() const { return minimo; }        ///< Valor más bajo
+    T obtenerMaximo() const { return maximo; }        ///< Valor más alto
+
+    /**
+     * @brief Varianza muestral (n - 1)
+     * @return Varianza, o 0 con menos de dos valores
+     */
+    double varianza() const {
+        return cantidad > 1 ? m2 / (cantidad - 1) : 0.0;
+    }
+};
+
+#endif
@@ -0,0 +1,353 @@
+/**
+ * @file ExportadorMetricas.h
+ * @brief Resumen periódico de Metricas.h y punto HTTP en formato Prometheus
+ * @details Un único hilo en segundo plano: cada cierto intervalo imprime
+ *          un resumen en std::cout y, si se pidió un puerto, responde
+ *          GET /metrics con el formato de texto de Prometheus.
+ */
+
+#ifndef EXPORTADOR_METRICAS_H
+#define EXPORTADOR_METRICAS_H
+
+#include "Metricas.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/**
+ * @class ExportadorMetricas
+ * @brief Publica las métricas del proceso sin tocar el camino de ingesta
+ *
+ * RAZÓN de un hilo propio: Tomar una foto recorre todos los fragmentos
+ * (unos KB por hilo) y formatear texto es lento comparado con una
+ * lectura; nada de eso debe pasar en el hilo que lee los puertos.
+ *
+ * HTTP: Solo lo mínimo para un scraper: una petición por conexión,
+ * respuesta completa y cierre. Escucha en 127.0.0.1 (no en todas las
+ * interfaces), sin autenticación.
+ *
+ * USO:
+ *   ExportadorMetricas exportador;
+ *   exportador.iniciar(10, 9464);   // resumen cada 10 s, HTTP en :9464
+ *   ...
+ *   exportador.imprimirResumen();   // totales desde el arranque
+ */
+class ExportadorMetricas {
+private:
+    int intervaloMs;       ///< 0 = sin resumen periódico
+    int escucha;           ///< Socket del punto HTTP, o -1
+    int despertador[2];    ///< Tubería para sacar al hilo de poll() al cerrar
+    std::thread hilo;
+    FotoMetricas* anterior;  ///< Foto del último resumen, para las tasas
+    FotoMetricas* actual;
+
+    static const char* nombreEtapa(int etapa) {
+        static const char* const NOMBRES[CANTIDAD_ETAPAS] = {
+            "lectura", "parseo", "busqueda", "insercion", "proceso"};
+        return NOMBRES[etapa];
+    }
+
+    /**
+     * @brief Abre el socket de escucha en 127.0.0.1:'puerto'
+     */
+    bool abrirEscucha(int puerto) {
+        escucha = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (escucha < 0) {
+            return false;
+        }
+        int si = 1;
+        setsockopt(escucha, SOL_SOCKET, SO_REUSEADDR, &si, sizeof(si));
+        struct sockaddr_in direccion;
+        memset(&direccion, 0, sizeof(direccion));
+        direccion.sin_family = AF_INET;
+        direccion.sin_port = htons(static_cast<unsigned short>(puerto));
+        direccion.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(escucha, reinterpret_cast<struct sockaddr*>(&direccion), sizeof(direccion)) != 0 ||
+            listen(escucha, 8) != 0) {
+            close(escucha);
+            escucha = -1;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Responde una petición HTTP y cierra la conexión
+     *
+     * NOTA: Un cliente que no manda nada no traba al hilo: la lectura
+     * tiene un plazo de 200 ms.
+     */
+    void atender(int cliente) {
+        struct timeval plazo;
+        plazo.tv_sec = 0;
+        plazo.tv_usec = 200000;
+        setsockopt(cliente, SOL_SOCKET, SO_RCVTIMEO, &plazo, sizeof(plazo));
+
+        char peticion[1024];
+        ssize_t n = recv(cliente, peticion, sizeof(peticion) - 1, 0);
+        if (n <= 0) {
+            close(cliente);
+            return;
+        }
+        peticion[n] = '\0';
+
+        std::ostringstream cuerpo;
+        const char* estado = "200 OK";
+        if (strncmp(peticion, "GET /metrics", 12) == 0 || strncmp(peticion, "GET / ", 6) == 0) {
+            Metricas::global().tomarFoto(*actual);
+            escribirPrometheus(cuerpo, *actual);
+        } else {
+            estado = "404 Not Found";
+            cuerpo << "Solo GET /metrics\n";
+        }
+
+        std::string texto = cuerpo.str();
+        std::ostringstream respuesta;
+        respuesta << "HTTP/1.0 " << estado << "\r\n"
+                  << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                  << "Content-Length: " << texto.size() << "\r\n"
+                  << "Connection: close\r\n\r\n"
+                  << texto;
+        std::string salida = respuesta.str();
+        const char* p = salida.data();
+        std::size_t restante = salida.size();
+        while (restante > 0) {
+            ssize_t enviados = send(cliente, p, restante, MSG_NOSIGNAL);
+            if (enviados <= 0) {
+                break;
+            }
+            p += enviados;
+            restante -= static_cast<std::size_t>(enviados);
+        }
+        close(cliente);
+    }
+
+    /**
+     * @brief Bucle del hilo: resúmenes puntuales y conexiones entrantes
+     */
+    void ejecutar() {
+        long long proximo = intervaloMs > 0 ? relojMs() + intervaloMs : -1;
+        while (true) {
+            struct pollfd esperas[2];
+            esperas[0].fd = despertador[0];
+            esperas[0].events = POLLIN;
+            esperas[1].fd = escucha;
+            esperas[1].events = POLLIN;
+            int espera = proximo < 0 ? -1 : static_cast<int>(proximo - relojMs());
+            if (proximo >= 0 && espera < 0) {
+                espera = 0;
+            }
+            int listos = poll(esperas, escucha >= 0 ? 2 : 1, espera);
+            if (listos > 0 && (esperas[0].revents & POLLIN)) {
+                return;
+            }
+            if (listos > 0 && escucha >= 0 && (esperas[1].revents & POLLIN)) {
+                int cliente = accept4(escucha, nullptr, nullptr, SOCK_CLOEXEC);
+                if (cliente >= 0) {
+                    atender(cliente);
+                }
+            }
+            if (proximo >= 0 && relojMs() >= proximo) {
+                Metricas::global().tomarFoto(*actual);
+                std::ostringstream texto;
+                escribirResumen(texto, *actual, anterior);
+                std::cout << texto.str();  // Una sola escritura: no se mezcla con otros hilos
+                FotoMetricas* t = anterior;
+                anterior = actual;
+                actual = t;
+                proximo += intervaloMs;
+            }
+        }
+    }
+
+    static long long relojMs() {
+        return static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+public:
+    ExportadorMetricas() : intervaloMs(0), escucha(-1), anterior(new FotoMetricas()), actual(new FotoMetricas()) {
+        despertador[0] = despertador[1] = -1;
+        Metricas::global().tomarFoto(*anterior);
+    }
+
+    ~ExportadorMetricas() {
+        if (hilo.joinable()) {
+            char c = 0;
+            ssize_t escritos = write(despertador[1], &c, 1);
+            (void)escritos;
+            hilo.join();
+        }
+        if (despertador[0] >= 0) {
+            close(despertador[0]);
+            close(despertador[1]);
+        }
+        if (escucha >= 0) {
+            close(escucha);
+        }
+        delete anterior;
+        delete actual;
+    }
+
+    ExportadorMetricas(const ExportadorMetricas&) = delete;
+    ExportadorMetricas& operator=(const ExportadorMetricas&) = delete;
+
+    /**
+     * @brief Arranca el hilo
+     * @param segundos Intervalo del resumen en std::cout (0 = ninguno)
+     * @param puerto Puerto HTTP en 127.0.0.1 (0 = ninguno)
+     * @return false si el puerto no se pudo abrir (el resumen sigue igual)
+     */
+    bool iniciar(int segundos, int puerto) {
+        intervaloMs = segundos > 0 ? segundos * 1000 : 0;
+        bool abierto = true;
+        if (puerto > 0) {
+            abierto = abrirEscucha(puerto);
+            if (abierto) {
+                std::cout << "[Metricas] Prometheus en http://127.0.0.1:" << puerto << "/metrics\n";
+            } else {
+                std::cerr << "[Metricas] No se pudo escuchar en el puerto " << puerto << std::endl;
+            }
+        }
+        if ((intervaloMs > 0 || escucha >= 0) && pipe(despertador) == 0) {
+            hilo = std::thread(&ExportadorMetricas::ejecutar, this);
+        }
+        return abierto;
+    }
+
+    /**
+     * @brief Imprime los totales desde el arranque (al cerrar el programa)
+     */
+    void imprimirResumen() {
+        FotoMetricas* foto = new FotoMetricas();
+        Metricas::global().tomarFoto(*foto);
+        std::ostringstream texto;
+        escribirResumen(texto, *foto, nullptr);
+        std::cout << texto.str();
+        delete foto;
+    }
+
+    /**
+     * @brief Resumen legible: contadores (con tasa si hay foto anterior) y latencias
+     */
+    static void escribirResumen(std::ostream& salida, const FotoMetricas& foto, const FotoMetricas* previa) {
+        const unsigned long long* c = foto.contadores;
+        double segundos = 0.0;
+        unsigned long long lineasAntes = 0;
+        if (previa != nullptr) {
+            segundos = static_cast<double>(foto.tomadaMs - previa->tomadaMs) / 1000.0;
+            lineasAntes = previa->contadores[CONTADOR_LINEAS];
+        }
+
+        char linea[256];
+        snprintf(linea, sizeof(linea),
+                 "[Metricas] %llu línea(s)", c[CONTADOR_LINEAS]);
+        salida << linea;
+        if (segundos > 0.0) {
+            snprintf(linea, sizeof(linea), " (%.0f/s)",
+                     static_cast<double>(c[CONTADOR_LINEAS] - lineasAntes) / segundos);
+            salida << linea;
+        }
+        snprintf(linea, sizeof(linea),
+                 " | %llu malformada(s) | %llu descartada(s) | %llu lectura(s) | %.1f KB leídos"
+                 " | %llu sensor(es) nuevos\n",
+                 c[CONTADOR_MALFORMADAS], c[CONTADOR_DESCARTADAS], c[CONTADOR_LECTURAS],
+                 static_cast<double>(c[CONTADOR_BYTES_LEIDOS]) / 1024.0, c[CONTADOR_SENSORES_NUEVOS]);
+        salida << linea;
+
+        for (int e = 0; e < CANTIDAD_ETAPAS; e++) {
+            EtapaMetrica etapa = static_cast<EtapaMetrica>(e);
+            if (foto.cantidad[e] == 0) {
+                continue;
+            }
+            snprintf(linea, sizeof(linea),
+                     "[Metricas]   %-9s n=%-10llu prom=%.0f ns  p50=%.0f ns  p99=%.0f ns  p99.9=%.0f ns  máx=%.0f ns\n",
+                     nombreEtapa(e), foto.cantidad[e], foto.promedioNs(etapa), foto.percentilNs(etapa, 50.0),
+                     foto.percentilNs(etapa, 99.0), foto.percentilNs(etapa, 99.9), foto.maximoNs(etapa));
+            salida << linea;
+        }
+    }
+
+    /**
+     * @brief Formato de texto de Prometheus (versión 0.0.4)
+     *
+     * RAZÓN de límites fijos en los histogramas: Las cubetas internas
+     * están en ciclos y su equivalencia en segundos se recalibra; Prometheus
+     * necesita los mismos 'le' en cada lectura para poder restar.
+     */
+    static void escribirPrometheus(std::ostream& salida, const FotoMetricas& foto) {
+        static const char* const NOMBRES[CANTIDAD_CONTADORES] = {
+            "sistemaiot_bytes_leidos_total", "sistemaiot_lineas_total",
+            "sistemaiot_lineas_malformadas_total", "sistemaiot_lineas_descartadas_total",
+            "sistemaiot_lecturas_total", "sistemaiot_sensores_nuevos_total"};
+        static const char* const AYUDAS[CANTIDAD_CONTADORES] = {
+            "Bytes leidos de los puertos", "Lineas de texto recibidas",
+            "Lineas rechazadas por el parser", "Lineas demasiado largas descartadas",
+            "Lecturas entregadas a un sensor", "Sensores creados al recibir un ID nuevo"};
+        for (int c = 0; c < CANTIDAD_CONTADORES; c++) {
+            salida << "# HELP " << NOMBRES[c] << ' ' << AYUDAS[c] << '\n'
+                   << "# TYPE " << NOMBRES[c] << " counter\n"
+                   << NOMBRES[c] << ' ' << foto.contadores[c] << '\n';
+        }
+
+        // 50 ns a 10 s
+        static const double LIMITES[] = {5e-8, 1e-7, 2.5e-7, 5e-7, 1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5,
+                                         5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3, 1e-2, 1e-1, 1.0, 10.0};
+        const int CANTIDAD_LIMITES = static_cast<int>(sizeof(LIMITES) / sizeof(LIMITES[0]));
+        const double segundosPorCiclo = foto.nanosegundosPorCiclo / 1e9;
+        const char* histograma = "sistemaiot_latencia_segundos";
+        salida << "# HELP " << histograma << " Duracion de cada etapa del camino de ingesta\n"
+               << "# TYPE " << histograma << " histogram\n";
+        char numero[32];
+        for (int e = 0; e < CANTIDAD_ETAPAS; e++) {
+            unsigned long long acumulado = 0;
+            int cubeta = 0;
+            for (int l = 0; l < CANTIDAD_LIMITES; l++) {
+                // Cubetas completas por debajo del límite (su techo es el piso de la siguiente)
+                while (cubeta < HistogramaLatencia::CUBETAS - 1 &&
+                       static_cast<double>(HistogramaLatencia::limiteInferior(cubeta + 1)) * segundosPorCiclo <=
+                           LIMITES[l]) {
+                    acumulado += foto.cubetas[e][cubeta];
+                    cubeta++;
+                }
+                snprintf(numero, sizeof(numero), "%g", LIMITES[l]);
+                salida << histograma << "_bucket{etapa=\"" << nombreEtapa(e) << "\",le=\"" << numero << "\"} "
+                       << acumulado << '\n';
+            }
+            salida << histograma << "_bucket{etapa=\"" << nombreEtapa(e) << "\",le=\"+Inf\"} "
+                   << foto.cantidad[e] << '\n';
+            snprintf(numero, sizeof(numero), "%.9f", static_cast<double>(foto.sumaCiclos[e]) * segundosPorCiclo);
+            salida << histograma << "_sum{etapa=\"" << nombreEtapa(e) << "\"} " << numero << '\n'
+                   << histograma << "_count{etapa=\"" << nombreEtapa(e) << "\"} " << foto.cantidad[e] << '\n';
+        }
+
+        // Percentiles ya calculados, para mirar sin histogram_quantile()
+        const char* percentil = "sistemaiot_latencia_percentil_segundos";
+        static const double PERCENTILES[] = {50.0, 99.0, 99.9};
+        salida << "# HELP " << percentil << " Percentil de latencia desde el arranque\n"
+               << "# TYPE " << percentil << " gauge\n";
+        for (int e = 0; e < CANTIDAD_ETAPAS; e++) {
+            for (int p = 0; p < 3; p++) {
+                snprintf(numero, sizeof(numero), "%.9f",
+                         foto.percentilNs(static_cast<EtapaMetrica>(e), PERCENTILES[p]) / 1e9);
+                salida << percentil << "{etapa=\"" << nombreEtapa(e) << "\",percentil=\"" << PERCENTILES[p]
+                       << "\"} " << numero << '\n';
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file FuenteHistorial.h
+ * @brief Interfaz de quien guarda historiales fuera de memoria
+ * @details GestorSensores la usa para traer el historial guardado de un
+ *          sensor recién cuando lo necesita (procesar, listar, ventanas).
+ */
+
+#ifndef FUENTE_HISTORIAL_H
+#define FUENTE_HISTORIAL_H
+
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+
+/**
+ * @class FuenteHistorial
+ * @brief Entrega a un sensor las lecturas que tenía antes del arranque
+ *
+ * CONCEPTO - Hidratación perezosa:
+ * Al arrancar solo se registran los sensores guardados. La primera vez
+ * que el gestor va a leer el historial de uno, le pide a la fuente que
+ * lo vuelque; los que nadie consulta nunca se decodifican.
+ *
+ * RAZÓN de una sobrecarga por tipo: El gestor ya conoce el tipo real
+ * (ver GestorSensores::visitarSensor) y la fuente puede volcar un lote
+ * entero con adoptarAnteriores sin otra conversión.
+ *
+ * NOTA: Se llama con el cerrojo del sensor tomado, una sola vez por
+ * sensor (ver SensorBase::tomarHistorialGuardado).
+ */
+class FuenteHistorial {
+public:
+    virtual ~FuenteHistorial() {}
+
+    /**
+     * @brief Vuelca lo guardado antes de las lecturas que ya tenga el sensor
+     * @return Lecturas recuperadas
+     */
+    virtual int hidratar(SensorTemperatura& sensor) = 0;
+    virtual int hidratar(SensorTemperaturaAcotado& sensor) = 0;
+    virtual int hidratar(SensorPresion& sensor) = 0;
+    virtual int hidratar(SensorPresionAcotado& sensor) = 0;
+    virtual int hidratar(SensorBase& sensor) = 0;
+};
+
+#endif
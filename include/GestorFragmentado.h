@@ -0,0 +1,692 @@
+/**
+ * @file GestorFragmentado.h
+ * @brief Sensores repartidos entre varios procesos o máquinas
+ * @details El frente (GestorFragmentado) recibe las lecturas, decide el
+ *          dueño de cada ID con un AnilloConsistente y se las manda; cada
+ *          fragmento (servirFragmento) tiene su propio GestorSensores.
+ *          procesarTodos y listarSensores se reparten a todos los
+ *          fragmentos y juntan las respuestas (dispersar y reunir).
+ */
+
+#ifndef GESTOR_FRAGMENTADO_H
+#define GESTOR_FRAGMENTADO_H
+
+#include "AnilloConsistente.h"
+#include "EscritorInforme.h"
+#include "GestorSensores.h"
+#include "IngestaSerial.h"
+#include "LectorLineas.h"
+#include "ParserTramas.h"
+#include "PoolHilos.h"
+#include "ProtocoloBinario.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * PROTOCOLO entre el frente y un fragmento (texto, una orden por línea):
+ * - "TIPO,ID,VALOR"    una lectura, igual que la manda el ESP32; sin respuesta
+ * - "#PROCESAR"        procesarTodos(); responde lo que imprimió
+ * - "#VENTANAS"        imprimirVentanas(); responde lo que imprimió
+ * - "#LISTAR c|r|N"    listarSensores completo, resumen o últimas N lecturas
+ *
+ * Cada respuesta viaja en tramos: 4 bytes con el largo (little-endian,
+ * ver escribirU32) seguidos de ese texto. Un tramo de largo 0 la termina.
+ *
+ * RAZÓN de prefijar el largo y no usar un byte de fin: el texto
+ * incluye los IDs tal como llegaron, así que ningún byte está a salvo
+ * de aparecer en él. Con el largo por delante el frente nunca mira el
+ * contenido. Y como son tramos, un listado enorme sale a medida que se
+ * escribe, sin tener que medirlo antes.
+ */
+const int CABECERA_TRAMO = 4;
+
+/**
+ * @brief Escribe 'n' bytes completos en el descriptor, reintentando si se interrumpe
+ */
+inline void escribirEnDescriptor(int fd, const char* p, int n) {
+    while (n > 0) {
+        ssize_t escritos = write(fd, p, static_cast<size_t>(n));
+        if (escritos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        p += escritos;
+        n -= static_cast<int>(escritos);
+    }
+}
+
+/**
+ * @brief Envía un tramo de respuesta; con n = 0, el que cierra la respuesta
+ */
+inline void enviarTramo(int fd, const char* p, int n) {
+    unsigned char cabecera[CABECERA_TRAMO];
+    escribirU32(cabecera, static_cast<unsigned int>(n));
+    escribirEnDescriptor(fd, reinterpret_cast<const char*>(cabecera), CABECERA_TRAMO);
+    escribirEnDescriptor(fd, p, n);
+}
+
+/**
+ * @class SalidaEnTramos
+ * @brief streambuf que manda cada bloque recibido como un tramo
+ *
+ * USO: Destino de un EscritorInforme, que entrega el listado en
+ * bloques de su capacidad; cada bloque se vuelve un tramo.
+ */
+class SalidaEnTramos : public std::streambuf {
+private:
+    int fd;
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            char letra = traits_type::to_char_type(c);
+            enviarTramo(fd, &letra, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* texto, std::streamsize largo) override {
+        if (largo > 0) {
+            enviarTramo(fd, texto, static_cast<int>(largo));
+        }
+        return largo;
+    }
+
+public:
+    explicit SalidaEnTramos(int descriptor) : fd(descriptor) {}
+
+    /**
+     * @brief Cierra la respuesta con el tramo vacío
+     */
+    void terminar() {
+        enviarTramo(fd, nullptr, 0);
+    }
+};
+
+/**
+ * @brief Ejecuta una orden del frente y devuelve lo que escribió en std::cout
+ *
+ * RAZÓN de desviar std::cout y no cambiar el gestor: procesarTodos e
+ * imprimirVentanas escriben ahí directamente (los mensajes por sensor,
+ * con salidaRegistro, también llegan ahí en este hilo).
+ */
+template <typename Accion>
+inline void responderCapturando(int fd, Accion accion) {
+    std::ostringstream texto;
+    std::streambuf* anterior = std::cout.rdbuf(texto.rdbuf());
+    accion();
+    std::cout.rdbuf(anterior);
+
+    const std::string capturado = texto.str();
+    if (!capturado.empty()) {
+        enviarTramo(fd, capturado.data(), static_cast<int>(capturado.size()));
+    }
+    enviarTramo(fd, nullptr, 0);
+}
+
+/**
+ * @brief Lado fragmento: atiende las órdenes de un frente hasta que cierra
+ * @param fd Conexión con el frente (socketpair o TCP)
+ * @param gestor Sensores de este fragmento (sobreviven a la conexión)
+ * @param pool Hilos para procesarTodos, o nullptr para el hilo actual
+ *
+ * Los mensajes de ingesta ("[Serial] Nuevo sensor ...") salen por la
+ * consola del fragmento, no por la conexión: al frente solo vuelven
+ * las respuestas a órdenes '#'.
+ */
+inline void servirFragmento(int fd, GestorSensores& gestor, PoolHilos* pool) {
+    Persistencia sinPersistencia;
+    LectorLineas lector(fd);
+    while (lector.llenar() > 0) {
+        char* linea;
+        int largo;
+        while (lector.siguienteLinea(linea, largo)) {
+            if (linea[0] != '#') {
+                procesarLinea(linea, largo, gestor, sinPersistencia);
+            } else if (strcmp(linea, "#PROCESAR") == 0) {
+                responderCapturando(fd, [&gestor, pool]() {
+                    if (pool != nullptr) {
+                        gestor.procesarTodos(*pool);
+                    } else {
+                        gestor.procesarTodos();
+                    }
+                });
+            } else if (strcmp(linea, "#VENTANAS") == 0) {
+                responderCapturando(fd, [&gestor]() { gestor.imprimirVentanas(); });
+            } else if (strncmp(linea, "#LISTAR ", 8) == 0) {
+                OpcionesInforme opciones;
+                const char* modo = linea + 8;
+                if (strcmp(modo, "r") == 0) {
+                    opciones.soloResumen = true;
+                } else if (strcmp(modo, "c") != 0) {
+                    char* fin;
+                    long maximo = strtol(modo, &fin, 10);
+                    if (fin == modo || *fin != '\0' || maximo < 0 || maximo > 2147483647L) {
+                        // Igual se responde: el frente espera un tramo final por orden
+                        responderCapturando(fd, [modo]() {
+                            std::cout << "[Fragmento] #LISTAR espera r, c o un número: " << modo << "\n";
+                        });
+                        continue;
+                    }
+                    opciones.maximoLecturas = static_cast<int>(maximo);
+                }
+                SalidaEnTramos tramos(fd);
+                {
+                    std::ostream flujo(&tramos);
+                    EscritorInforme salida(flujo);
+                    gestor.listarSensores(salida, opciones);
+                }
+                tramos.terminar();
+            } else {
+                std::cout << "[Fragmento] Orden desconocida: " << linea << "\n";
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lado fragmento en otra máquina: escucha en 0.0.0.0:'puerto' para siempre
+ * @param puerto Puerto TCP
+ * @param trabajadores Hilos de procesarTodos (-1 = hilo principal, 0 = uno por núcleo)
+ * @return 1 si no se pudo abrir el puerto (nunca vuelve si se pudo)
+ *
+ * Atiende a un frente a la vez; los sensores quedan entre conexiones,
+ * así un frente que se reinicia sigue viendo el historial de este nodo.
+ *
+ * NOTA: Escucha en todas las interfaces (es para recibir de otra
+ * máquina) y el protocolo no autentica: usarlo dentro de una red de
+ * confianza.
+ */
+inline int servirNodo(int puerto, int trabajadores) {
+    int escucha = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (escucha < 0) {
+        std::cout << "[Nodo] No se pudo crear el socket: " << strerror(errno) << "\n";
+        return 1;
+    }
+    int si = 1;
+    setsockopt(escucha, SOL_SOCKET, SO_REUSEADDR, &si, sizeof(si));
+    struct sockaddr_in direccion;
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sin_family = AF_INET;
+    direccion.sin_port = htons(static_cast<unsigned short>(puerto));
+    direccion.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(escucha, reinterpret_cast<struct sockaddr*>(&direccion), sizeof(direccion)) != 0 ||
+        listen(escucha, 1) != 0) {
+        std::cout << "[Nodo] No se pudo escuchar en el puerto " << puerto << ": " << strerror(errno) << "\n";
+        close(escucha);
+        return 1;
+    }
+    std::cout << "[Nodo] Esperando al frente en 0.0.0.0:" << puerto << std::endl;
+
+    GestorSensores gestor;
+    PoolHilos* pool = trabajadores >= 0 ? new PoolHilos(trabajadores) : nullptr;
+    while (true) {
+        int frente = accept4(escucha, nullptr, nullptr, SOCK_CLOEXEC);
+        if (frente < 0) {
+            continue;
+        }
+        setsockopt(frente, IPPROTO_TCP, TCP_NODELAY, &si, sizeof(si));
+        std::cout << "[Nodo] Frente conectado" << std::endl;
+        servirFragmento(frente, gestor, pool);
+        close(frente);
+        std::cout << "[Nodo] Frente desconectado (" << gestor.obtenerCantidad() << " sensor(es) retenidos)"
+                  << std::endl;
+    }
+}
+
+/**
+ * @class GestorFragmentado
+ * @brief Frente que reparte los sensores entre fragmentos por su ID
+ *
+ * CONCEPTO - Fragmentación (sharding):
+ * Un solo GestorSensores queda limitado a la memoria y los núcleos de
+ * una máquina. Aquí cada ID tiene un único fragmento dueño (elegido
+ * por el AnilloConsistente) y todas sus lecturas van a ese proceso;
+ * la capacidad crece agregando fragmentos.
+ *
+ * FRAGMENTOS:
+ * - Locales (lanzarLocal): el mismo ejecutable, en otro proceso, unido
+ *   al frente por un socketpair
+ * - Remotos (conectarRemoto): un "SistemaIoT --nodo PUERTO" en otra
+ *   máquina, por TCP
+ * Los dos hablan el mismo protocolo (ver CABECERA_TRAMO).
+ *
+ * RAZÓN del buffer de envío por fragmento: Una lectura son ~15 bytes;
+ * se juntan hasta TAM_ENVIO y viajan en un solo send().
+ *
+ * DISPERSAR Y REUNIR:
+ * procesarTodos() manda la orden a todos antes de esperar a ninguno,
+ * así los fragmentos trabajan a la vez; luego lee las respuestas en
+ * orden de fragmento, para que la salida no se mezcle.
+ *
+ * NOTA: Un fragmento que se cae queda marcado; sus lecturas se
+ * descartan y el resto sigue funcionando.
+ */
+class GestorFragmentado {
+public:
+    static const int TAM_ENVIO = 1 << 16;  ///< Bytes acumulados por fragmento antes de enviar
+
+private:
+    struct Fragmento {
+        int fd;                    ///< Conexión, o -1 si se cayó
+        pid_t proceso;             ///< Proceso hijo, o -1 si es remoto
+        char nombre[64];           ///< "local-K" o "host:puerto" (ubica sus puntos en el anillo)
+        char* envio;               ///< Lecturas pendientes de enviar
+        int usados;
+        unsigned long long lecturas;
+    };
+
+    Fragmento* fragmentos;
+    int cantidad;
+    int capacidad;
+    int locales;  ///< Fragmentos lanzados con lanzarLocal (numera "local-K")
+    AnilloConsistente anillo;
+
+    void agregarFragmento(int fd, pid_t proceso, const char* nombre) {
+        if (cantidad == capacidad) {
+            int nueva = capacidad == 0 ? 4 : capacidad * 2;
+            Fragmento* mayor = new Fragmento[nueva];
+            for (int i = 0; i < cantidad; i++) {
+                mayor[i] = fragmentos[i];
+            }
+            delete[] fragmentos;
+            fragmentos = mayor;
+            capacidad = nueva;
+        }
+        Fragmento& f = fragmentos[cantidad];
+        f.fd = fd;
+        f.proceso = proceso;
+        snprintf(f.nombre, sizeof(f.nombre), "%s", nombre);
+        f.envio = new char[TAM_ENVIO];
+        f.usados = 0;
+        f.lecturas = 0;
+        anillo.agregar(f.nombre, cantidad);
+        cantidad++;
+    }
+
+    /**
+     * @brief Marca un fragmento como caído (una sola vez)
+     */
+    void perder(Fragmento& f) {
+        if (f.fd < 0) {
+            return;
+        }
+        std::cout << "[Fragmentos] Se perdió el fragmento " << f.nombre << ": " << strerror(errno) << "\n";
+        close(f.fd);
+        f.fd = -1;
+        f.usados = 0;
+    }
+
+    /**
+     * @brief Envía 'n' bytes completos
+     *
+     * RAZÓN de MSG_NOSIGNAL: Si el fragmento murió, send() devuelve
+     * EPIPE en vez de matar al frente con SIGPIPE.
+     */
+    void enviar(Fragmento& f, const char* p, int n) {
+        while (n > 0 && f.fd >= 0) {
+            ssize_t enviados = send(f.fd, p, static_cast<size_t>(n), MSG_NOSIGNAL);
+            if (enviados < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perder(f);
+                return;
+            }
+            p += enviados;
+            n -= static_cast<int>(enviados);
+        }
+    }
+
+    void vaciar(Fragmento& f) {
+        if (f.usados > 0) {
+            enviar(f, f.envio, f.usados);
+            f.usados = 0;
+        }
+    }
+
+    /**
+     * @brief Agrega una línea (sin '\n') al buffer de envío de su fragmento
+     */
+    void encolar(Fragmento& f, const char* linea, int largo) {
+        if (f.fd < 0) {
+            return;
+        }
+        if (f.usados + largo + 1 > TAM_ENVIO) {
+            vaciar(f);
+        }
+        memcpy(f.envio + f.usados, linea, static_cast<size_t>(largo));
+        f.usados += largo;
+        f.envio[f.usados++] = '\n';
+        f.lecturas++;
+    }
+
+    /**
+     * @brief Dispersar: la misma orden a todos, tras las lecturas pendientes
+     */
+    void difundir(const char* orden) {
+        int largo = static_cast<int>(strlen(orden));
+        for (int i = 0; i < cantidad; i++) {
+            vaciar(fragmentos[i]);
+            enviar(fragmentos[i], orden, largo);
+        }
+    }
+
+    /**
+     * @brief Lee exactamente 'n' bytes del fragmento
+     * @return false si la conexión se cortó antes (el fragmento queda perdido)
+     */
+    bool recibir(Fragmento& f, char* p, int n) {
+        while (n > 0 && f.fd >= 0) {
+            ssize_t leidos = read(f.fd, p, static_cast<size_t>(n));
+            if (leidos < 0 && errno == EINTR) {
+                continue;
+            }
+            if (leidos <= 0) {
+                if (leidos == 0) {
+                    errno = ECONNRESET;
+                }
+                perder(f);
+                return false;
+            }
+            p += leidos;
+            n -= static_cast<int>(leidos);
+        }
+        return f.fd >= 0;
+    }
+
+    /**
+     * @brief Reunir: copia los tramos de la respuesta de un fragmento hasta el tramo vacío
+     */
+    void recoger(Fragmento& f, EscritorInforme& salida) {
+        char bloque[1 << 16];
+        unsigned char cabecera[CABECERA_TRAMO];
+        while (recibir(f, reinterpret_cast<char*>(cabecera), CABECERA_TRAMO)) {
+            unsigned int restante = leerU32(cabecera);
+            if (restante == 0) {
+                return;
+            }
+            while (restante > 0) {
+                int parte = restante < sizeof(bloque) ? static_cast<int>(restante) : static_cast<int>(sizeof(bloque));
+                if (!recibir(f, bloque, parte)) {
+                    return;
+                }
+                salida.texto(bloque, parte);
+                restante -= static_cast<unsigned int>(parte);
+            }
+        }
+    }
+
+    /**
+     * @brief Orden a todos y respuestas en orden, cada una con su encabezado
+     */
+    void dispersarYReunir(const char* orden, EscritorInforme& salida) {
+        difundir(orden);
+        for (int i = 0; i < cantidad; i++) {
+            salida << "\n[Fragmento " << i + 1 << "/" << cantidad << ": " << fragmentos[i].nombre << "]\n";
+            if (fragmentos[i].fd < 0) {
+                salida << "[Fragmentos] Sin respuesta (fragmento caído)\n";
+                continue;
+            }
+            recoger(fragmentos[i], salida);
+        }
+    }
+
+public:
+    GestorFragmentado() : fragmentos(nullptr), cantidad(0), capacidad(0), locales(0) {}
+
+    /**
+     * @brief Envía lo pendiente, cierra las conexiones y espera a los hijos
+     *
+     * Al ver la conexión cerrada, un fragmento local termina solo; uno
+     * remoto vuelve a esperar a otro frente.
+     */
+    ~GestorFragmentado() {
+        for (int i = 0; i < cantidad; i++) {
+            vaciar(fragmentos[i]);
+            if (fragmentos[i].fd >= 0) {
+                close(fragmentos[i].fd);
+            }
+        }
+        for (int i = 0; i < cantidad; i++) {
+            if (fragmentos[i].proceso > 0) {
+                waitpid(fragmentos[i].proceso, nullptr, 0);
+            }
+            delete[] fragmentos[i].envio;
+        }
+        delete[] fragmentos;
+    }
+
+    GestorFragmentado(const GestorFragmentado&) = delete;
+    GestorFragmentado& operator=(const GestorFragmentado&) = delete;
+
+    /**
+     * @brief Lanza un fragmento local: este mismo ejecutable con --fragmento-fd
+     * @param trabajadores Se pasa al hijo como su --trabajadores
+     *
+     * El hijo recibe también la retención de este proceso (--retencion),
+     * así sus sensores guardan lo mismo que guardarían aquí.
+     * @return true si el proceso arrancó
+     *
+     * NOTA: Entre fork() y exec() solo hay close/execv, que son seguras
+     * aunque el frente ya tenga otros hilos (el sumidero de salida).
+     */
+    bool lanzarLocal(int trabajadores) {
+        int par[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, par) != 0) {
+            std::cout << "[Fragmentos] socketpair falló: " << strerror(errno) << "\n";
+            return false;
+        }
+        // El extremo del frente no debe heredarlo ningún hijo: si no, el
+        // fragmento no vería el cierre hasta que todos sus hermanos terminen
+        fcntl(par[0], F_SETFD, FD_CLOEXEC);
+
+        char textoFd[16];
+        char textoTrabajadores[16];
+        char textoRetencion[32];
+        snprintf(textoFd, sizeof(textoFd), "%d", par[1]);
+        snprintf(textoTrabajadores, sizeof(textoTrabajadores), "%d", trabajadores);
+        snprintf(textoRetencion, sizeof(textoRetencion), "%d:%d",
+                 retencionSensores().lecturas, retencionSensores().segundos);
+        char programa[] = "SistemaIoT";
+        char opcion[] = "--fragmento-fd";
+        char* argumentos[] = {programa, opcion, textoFd, textoTrabajadores, textoRetencion, nullptr};
+
+        pid_t hijo = fork();
+        if (hijo < 0) {
+            std::cout << "[Fragmentos] fork falló: " << strerror(errno) << "\n";
+            close(par[0]);
+            close(par[1]);
+            return false;
+        }
+        if (hijo == 0) {
+            // Puertos seriales, epoll, ...: el fragmento no los usa
+            for (int d = 3; d < 1024; d++) {
+                if (d != par[1]) {
+                    close(d);
+                }
+            }
+            execv("/proc/self/exe", argumentos);
+            _exit(127);
+        }
+        close(par[1]);
+
+        char nombre[32];
+        snprintf(nombre, sizeof(nombre), "local-%d", locales++);
+        agregarFragmento(par[0], hijo, nombre);
+        return true;
+    }
+
+    /**
+     * @brief Conecta con un "SistemaIoT --nodo PUERTO" en otra máquina
+     * @param direccion "host:puerto"
+     * @return true si se conectó
+     */
+    bool conectarRemoto(const char* direccion) {
+        char host[64];
+        snprintf(host, sizeof(host), "%s", direccion);
+        char* dosPuntos = strrchr(host, ':');
+        if (dosPuntos == nullptr) {
+            std::cout << "[Fragmentos] Falta el puerto en " << direccion << " (host:puerto)\n";
+            return false;
+        }
+        *dosPuntos = '\0';
+
+        struct addrinfo pistas;
+        memset(&pistas, 0, sizeof(pistas));
+        pistas.ai_family = AF_UNSPEC;
+        pistas.ai_socktype = SOCK_STREAM;
+        struct addrinfo* resultados = nullptr;
+        int error = getaddrinfo(host, dosPuntos + 1, &pistas, &resultados);
+        if (error != 0) {
+            std::cout << "[Fragmentos] No se encontró " << direccion << ": " << gai_strerror(error) << "\n";
+            return false;
+        }
+
+        int fd = -1;
+        for (struct addrinfo* r = resultados; r != nullptr && fd < 0; r = r->ai_next) {
+            fd = socket(r->ai_family, r->ai_socktype | SOCK_CLOEXEC, r->ai_protocol);
+            if (fd >= 0 && connect(fd, r->ai_addr, r->ai_addrlen) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(resultados);
+        if (fd < 0) {
+            std::cout << "[Fragmentos] No se pudo conectar con " << direccion << ": " << strerror(errno) << "\n";
+            return false;
+        }
+
+        // Las órdenes son cortas y se espera su respuesta: sin Nagle
+        int si = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &si, sizeof(si));
+        agregarFragmento(fd, -1, direccion);
+        return true;
+    }
+
+    int obtenerCantidad() const {
+        return cantidad;
+    }
+
+    /**
+     * @brief Fragmento dueño de un ID (el mismo para todas sus lecturas)
+     */
+    int fragmentoDe(const char* id, int largo) const {
+        return anillo.fragmentoDe(id, largo);
+    }
+
+    /**
+     * @brief Envía una línea "TIPO,ID,VALOR" a su fragmento
+     * @return false si la línea está malformada (no se envía)
+     *
+     * RAZÓN de validar aquí: El frente igual necesita el ID para elegir
+     * el fragmento, y una línea rota no viaja por la red.
+     */
+    bool enrutarLinea(const char* linea, int largo) {
+        TramaLectura trama;
+        if (!parsearTrama(linea, largo, trama)) {
+            return false;
+        }
+        int dueño = anillo.fragmentoDe(trama.id.inicio, trama.id.largo);
+        encolar(fragmentos[dueño], linea, largo);
+        return true;
+    }
+
+    /**
+     * @brief Envía un lote ya convertido (modo --binario), lectura por lectura
+     *
+     * Cada lectura vuelve a texto: %.9g alcanza para que el float del
+     * fragmento sea exactamente el del ESP32.
+     *
+     * RAZÓN de volver a validar: El ID se escribe tal cual en la línea.
+     * Con un '\n' o un '#' inicial inyectaría una orden en el fragmento
+     * y su respuesta desfasaría las del frente; con una ',' el fragmento
+     * descartaría la línea. Lo que no cumple idValido no se envía.
+     */
+    void enrutarLecturas(const LecturaParseada* lecturas, int n) {
+        char linea[LARGO_MAXIMO_ID + 40];
+        for (int i = 0; i < n; i++) {
+            const LecturaParseada& l = lecturas[i];
+            if ((l.tipo != 'T' && l.tipo != 'P') || !idValido(l.id, l.largoId)) {
+                METRICA_CONTAR(CONTADOR_MALFORMADAS, 1);
+                continue;
+            }
+            int largo;
+            if (l.tipo == 'T') {
+                largo = snprintf(linea, sizeof(linea), "%c,%s,%.9g", l.tipo, l.id, l.decimal);
+            } else {
+                largo = snprintf(linea, sizeof(linea), "%c,%s,%d", l.tipo, l.id, l.entero);
+            }
+            encolar(fragmentos[anillo.fragmentoDe(l.id, l.largoId)], linea, largo);
+        }
+    }
+
+    /**
+     * @brief La pasada de proceso en todos los fragmentos a la vez
+     */
+    void procesarTodos() {
+        EscritorInforme salida(std::cout);
+        dispersarYReunir("#PROCESAR\n", salida);
+    }
+
+    void imprimirVentanas() {
+        EscritorInforme salida(std::cout);
+        dispersarYReunir("#VENTANAS\n", salida);
+    }
+
+    /**
+     * @brief Listado de cada fragmento, uno detrás de otro, en 'salida'
+     */
+    void listarSensores(EscritorInforme& salida, const OpcionesInforme& opciones) {
+        char orden[32];
+        if (opciones.soloResumen) {
+            snprintf(orden, sizeof(orden), "#LISTAR r\n");
+        } else if (opciones.maximoLecturas >= 0) {
+            snprintf(orden, sizeof(orden), "#LISTAR %d\n", opciones.maximoLecturas);
+        } else {
+            snprintf(orden, sizeof(orden), "#LISTAR c\n");
+        }
+        dispersarYReunir(orden, salida);
+    }
+
+    /**
+     * @brief Lecturas enviadas a cada fragmento (muestra qué tan parejo reparte el anillo)
+     */
+    void informar() const {
+        unsigned long long total = 0;
+        for (int i = 0; i < cantidad; i++) {
+            total += fragmentos[i].lecturas;
+        }
+        std::cout << "[Fragmentos] " << cantidad << " fragmento(s), " << anillo.obtenerPuntos()
+                  << " puntos en el anillo, " << total << " lectura(s) enviadas\n";
+        for (int i = 0; i < cantidad; i++) {
+            std::cout << "  " << fragmentos[i].nombre << ": " << fragmentos[i].lecturas << " lectura(s)";
+            if (total > 0) {
+                std::cout << " (" << (100.0 * fragmentos[i].lecturas / total) << "%)";
+            }
+            if (fragmentos[i].fd < 0) {
+                std::cout << " [caído]";
+            }
+            std::cout << "\n";
+        }
+    }
+};
+
+#endif
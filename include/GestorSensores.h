@@ -1,92 +1,481 @@
 /**
  * @file GestorSensores.h
  * @brief Sistema de gestión polimórfica de sensores
- * @details Maneja una lista enlazada de punteros a SensorBase,
- * permitiendo almacenar diferentes tipos de sensores juntos.
+ * @details Guarda los sensores en arreglos contiguos (uno por dato y uno
+ * por tipo de sensor), permitiendo almacenar diferentes tipos de
+ * sensores juntos y recorrerlos sin saltar por la memoria.
  */
 
 #ifndef GESTOR_SENSORES_H
 #define GESTOR_SENSORES_H
 
 #include "SensorBase.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "ArregloPublicado.h"
+#include "PoolHilos.h"
+#include "ParserTramas.h"
+#include "SensoresPendientes.h"
+#include "FuenteHistorial.h"
+#include "Registro.h"
+#include "Metricas.h"
+#include "EscritorInforme.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 
 /**
- * @brief Nodo para la lista de gestión polimórfica
- * 
- * DIFERENCIA CLAVE con Nodo<T>:
- * - Este nodo NO es genérico
- * - Almacena específicamente punteros a SensorBase
- * - Permite el polimorfismo: guardar SensorTemperatura* y SensorPresion* juntos
- * 
- * CONCEPTO - Puntero a Clase Base:
- * SensorBase* puede apuntar a:
- *   - SensorTemperatura
- *   - SensorPresion
- *   - Cualquier futuro sensor que herede de SensorBase
+ * @brief Tipo real de un sensor registrado
+ *
+ * Se guarda junto a cada sensor para convertirlo a su clase con
+ * static_cast, sin preguntar por la tabla virtual en cada lectura.
  */
-struct NodoSensor {
-    SensorBase* sensor;     ///< Puntero polimórfico al sensor
-    NodoSensor* siguiente;  ///< Siguiente nodo en la lista
-    
-    /**
-     * @brief Constructor del nodo
-     * @param s Puntero al sensor a almacenar
-     */
-    
-    NodoSensor(SensorBase* s) : sensor(s), siguiente(nullptr) {}
+enum TipoSensor {
+    TIPO_TEMPERATURA,          ///< SensorTemperatura
+    TIPO_TEMPERATURA_ACOTADO,  ///< SensorTemperaturaAcotado (--retencion)
+    TIPO_PRESION,              ///< SensorPresion
+    TIPO_PRESION_ACOTADO,      ///< SensorPresionAcotado (--retencion)
+    TIPO_OTRO,                 ///< Cualquier otra clase derivada de SensorBase
+    CANTIDAD_TIPOS
 };
 
 /**
  * @class GestorSensores
  * @brief Administrador central de todos los sensores del sistema
- * 
+ *
  * TAREAS:
- * 1. Mantener una lista de todos los sensores activos
+ * 1. Mantener el registro de todos los sensores activos
  * 2. Permitir agregar nuevos sensores
  * 3. Buscar sensores por ID
  * 4. Procesar todos los sensores con iteración
  * 5. Liberar memoria al destruirse
- * 
+ *
  * PATRÓN DE DISEÑO:
  * Este es un ejemplo del patrón "Gestor" o "Manager":
  * - Centraliza la gestión de recursos (sensores)
  * - Proporciona una interfaz limpia para operaciones comunes
+ *
+ * CONCEPTO - Estructura de arreglos (SoA):
+ * En lugar de una lista de nodos {sensor, hash, siguiente}, cada dato
+ * tiene su propio arreglo, indexado por orden de registro:
+ *   sensores[i], tipos[i]
+ * Los nombres no se guardan aquí: cada sensor tiene su identificador
+ * internado (TablaIdentificadores.h) y el índice va de identificador
+ * a posición, sin comparar texto.
+ * procesarTodos ordena a los sensores por su tipo real (temperaturas,
+ * presiones, otros) y recorre un tramo a la vez llamando directamente
+ * a la versión de ese tipo: la decisión "¿qué tipo es?" se toma una
+ * vez por tramo, no una vez por sensor.
+ *
+ * NOTA - Qué queda fuera de los arreglos:
+ * El historial y el cerrojo siguen dentro de cada sensor, en el heap,
+ * y 'sensores' guarda punteros. Procesar o listar un sensor tiene que
+ * tomar su cerrojo y leer su historial de todos modos, y el sensor ya
+ * se comparte con la ingesta, la bitácora y la hidratación. Copiar
+ * esos campos aquí obligaría a sincronizar dos copias. El salto por
+ * puntero se disimula pidiendo a la caché los sensores de más adelante
+ * (ver procesarTramo).
+ *
+ * CONCEPTO - Procesamiento incremental:
+ * Cada sensor se anota en 'pendientes' al recibir su primera lectura
+ * después de una pasada. procesarTodos solo visita esos: con la mayor
+ * parte de la flota inactiva, la pasada cuesta O(cambiados).
+ *
+ * CONCURRENCIA:
+ * - buscarSensor, procesarTodos y listarSensores no toman cerrojos
+ *   del registro: leen arreglos e índice publicados con atomics
+ * - agregarSensor y registrarSiFalta se serializan con 'cerrojoRegistro'
+ * - Las lecturas y el procesamiento de un sensor se protegen con el
+ *   cerrojo propio del sensor (SensorBase::obtenerCerrojo), así dos
+ *   hilos solo se esperan si trabajan sobre el MISMO sensor
+ * - El destructor no debe correr en paralelo con ningún otro método
  */
 class GestorSensores {
 private:
-    NodoSensor* cabeza;  ///< Primer nodo de la lista de sensores
-    int cantidad;        ///< Contador de sensores registrados
-    
+    /**
+     * @brief Índice de sensores por identificador internado
+     *
+     * CONCEPTO - Tabla de acceso directo:
+     * Los identificadores son densos (0, 1, 2, ...), así que la casilla
+     * de un sensor es simplemente casillas[identificador]: guarda su
+     * posición en los arreglos de registro (más 1), o 0 si ese ID no
+     * tiene sensor en este gestor. Sin hash, sin sondeo, sin strcmp.
+     *
+     * RAZÓN:
+     * - buscarSensor se llama por cada línea recibida
+     * - El texto ya se comparó una vez al traducirlo a identificador;
+     *   aquí solo queda leer un entero
+     */
+    struct TablaIndice {
+        std::atomic<int>* casillas;  ///< Posición + 1; 0 = sin sensor
+        unsigned int capacidad;      ///< Siempre potencia de 2
+        TablaIndice* retirada;       ///< Tabla anterior, aún no liberada
+
+        explicit TablaIndice(unsigned int cap)
+            : casillas(new std::atomic<int>[cap]), capacidad(cap), retirada(nullptr) {
+            for (unsigned int i = 0; i < cap; i++) {
+                casillas[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        ~TablaIndice() {
+            delete[] casillas;
+        }
+    };
+
+    // Registro en orden de llegada (misma posición = mismo sensor)
+    ArregloPublicado<SensorBase*> sensores;  ///< Puntero polimórfico a cada sensor
+    ArregloPublicado<unsigned char> tipos;   ///< TipoSensor de cada sensor
+
+    /**
+     * @brief Tabla vigente del índice
+     *
+     * CONCEPTO - Publicación estilo RCU (read-copy-update):
+     * Para crecer no se modifica la tabla que los lectores pueden estar
+     * recorriendo: se arma una copia más grande y se publica con un solo
+     * store. La tabla vieja queda en la cadena 'retirada' y se libera en
+     * el destructor, cuando ya no puede haber lectores. Como cada tabla
+     * dobla a la anterior, las retiradas suman menos que la vigente.
+     */
+    std::atomic<TablaIndice*> indice;
+
+    std::mutex cerrojoRegistro;  ///< Serializa a quienes agregan sensores
+
+    SensoresPendientes pendientes;  ///< Sensores con lecturas sin procesar
+
+    FuenteHistorial* fuente;  ///< De dónde traer los historiales guardados, o nullptr
+
+    /**
+     * @brief Agranda el índice hasta que 'identificador' tenga casilla
+     *
+     * RAZÓN de doblar: Los identificadores crecen de a uno; doblando,
+     * copiar las casillas cuesta O(1) amortizado por sensor.
+     *
+     * NOTA: Se llama con cerrojoRegistro tomado.
+     */
+    void crecerIndice(unsigned int identificador) {
+        TablaIndice* vieja = indice.load(std::memory_order_relaxed);
+        unsigned int capacidad = vieja->capacidad;
+        while (capacidad <= identificador) {
+            capacidad *= 2;
+        }
+        TablaIndice* nueva = new TablaIndice(capacidad);
+        for (unsigned int i = 0; i < vieja->capacidad; i++) {
+            nueva->casillas[i].store(vieja->casillas[i].load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+        }
+
+        nueva->retirada = vieja;
+        indice.store(nueva, std::memory_order_release);
+    }
+
+    /**
+     * @brief Posición de un identificador en una tabla concreta del índice
+     * @return Posición del sensor en los arreglos de registro, o -1
+     *
+     * NOTA: La casilla se lee con acquire: si tiene posición, los
+     * arreglos de registro ya contienen ese sensor.
+     */
+    static int buscarEnTabla(const TablaIndice* tabla, unsigned int identificador) {
+        if (identificador >= tabla->capacidad) {
+            return -1;
+        }
+        return tabla->casillas[identificador].load(std::memory_order_acquire) - 1;
+    }
+
+    /**
+     * @brief Posición del sensor de un ID dado como texto, o -1
+     */
+    int buscarPosicion(const char* id, int largo) const {
+        unsigned int identificador = TablaIdentificadores::global().buscar(id, largo);
+        if (identificador == IDENTIFICADOR_DESCONOCIDO) {
+            return -1;
+        }
+        return buscarEnTabla(indice.load(std::memory_order_acquire), identificador);
+    }
+
+    /**
+     * @brief Agrega un sensor al registro y al índice
+     * @param sensor Sensor nuevo
+     *
+     * NOTA: Se llama con cerrojoRegistro tomado. Primero se publican
+     * los arreglos y al final la casilla del índice: quien encuentra
+     * la casilla ya ve el sensor completo. Quien llama ya comprobó que
+     * el ID no estaba registrado.
+     *
+     * RAZÓN de dynamic_cast:
+     * Se hace una sola vez por sensor, al registrarlo. A partir de ahí
+     * 'tipos' dice a qué clase convertirlo con static_cast.
+     */
+    void registrar(SensorBase* sensor) {
+        int posicion = sensores.tamaño();
+
+        TipoSensor tipo = TIPO_OTRO;
+        if (dynamic_cast<SensorTemperatura*>(sensor) != nullptr) {
+            tipo = TIPO_TEMPERATURA;
+        } else if (dynamic_cast<SensorTemperaturaAcotado*>(sensor) != nullptr) {
+            tipo = TIPO_TEMPERATURA_ACOTADO;
+        } else if (dynamic_cast<SensorPresion*>(sensor) != nullptr) {
+            tipo = TIPO_PRESION;
+        } else if (dynamic_cast<SensorPresionAcotado*>(sensor) != nullptr) {
+            tipo = TIPO_PRESION_ACOTADO;
+        }
+
+        sensores.agregar(sensor);
+        tipos.agregar(static_cast<unsigned char>(tipo));
+        // Después de publicarlo: quien lea la lista de pendientes ya lo encuentra
+        sensor->vincularPendientes(&pendientes, posicion);
+
+        if (posicion == 0) {
+            std::cout << "[Gestor] Primer sensor registrado: " << sensor->obtenerNombre() << '\n';
+        } else {
+            std::cout << "[Gestor] Sensor agregado: " << sensor->obtenerNombre() << '\n';
+        }
+
+        unsigned int identificador = sensor->obtenerIdentificador();
+        if (identificador >= indice.load(std::memory_order_relaxed)->capacidad) {
+            crecerIndice(identificador);
+        }
+        std::atomic<int>& casilla = indice.load(std::memory_order_relaxed)->casillas[identificador];
+        if (casilla.load(std::memory_order_relaxed) == 0) {
+            casilla.store(posicion + 1, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Llama a f con el sensor convertido a su clase real
+     * @tparam Funcion Invocable con SensorTemperatura&, SensorPresion&,
+     *         sus versiones acotadas y SensorBase& (los demás tipos)
+     * @param tipo El TipoSensor guardado en 'tipos'
+     *
+     * RAZÓN: Es el único switch sobre 'tipos'; visitarSensor, la
+     * ingesta por lotes y la hidratación pasan todos por aquí.
+     */
+    template <typename Funcion>
+    static void segunTipo(unsigned char tipo, SensorBase* sensor, Funcion& f) {
+        switch (tipo) {
+            case TIPO_TEMPERATURA:
+                f(*static_cast<SensorTemperatura*>(sensor));
+                break;
+            case TIPO_TEMPERATURA_ACOTADO:
+                f(*static_cast<SensorTemperaturaAcotado*>(sensor));
+                break;
+            case TIPO_PRESION:
+                f(*static_cast<SensorPresion*>(sensor));
+                break;
+            case TIPO_PRESION_ACOTADO:
+                f(*static_cast<SensorPresionAcotado*>(sensor));
+                break;
+            default:
+                f(*sensor);
+                break;
+        }
+    }
+
+    /**
+     * @brief Procesa un sensor de tipo conocido sin despacho virtual
+     *
+     * RAZÓN de 'S::': la llamada calificada elige la función al compilar;
+     * el compilador puede incluso expandirla en el bucle del tramo.
+     */
+    template <typename S>
+    void procesarUno(S* sensor) const {
+        std::lock_guard<std::mutex> guardia(sensor->obtenerCerrojo());
+        traerHistorial(fuente, *sensor);
+        sensor->limpiarPendiente();
+        sensor->S::procesarLectura();
+    }
+
+    /**
+     * @brief Procesa un sensor de otro tipo (despacho virtual)
+     */
+    void procesarUno(SensorBase* sensor) const {
+        std::lock_guard<std::mutex> guardia(sensor->obtenerCerrojo());
+        traerHistorial(fuente, *sensor);
+        sensor->limpiarPendiente();
+        sensor->procesarLectura();
+    }
+
+    /**
+     * @brief Hidrata el sensor si todavía tiene su historial guardado afuera
+     *
+     * NOTA: Con el cerrojo del sensor tomado, antes de leer su historial.
+     * Después de la primera vez es leer un bool.
+     */
+    template <typename S>
+    static void traerHistorial(FuenteHistorial* fuente, S& sensor) {
+        if (sensor.tomarHistorialGuardado() && fuente != nullptr) {
+            fuente->hidratar(sensor);
+        }
+    }
+
+    /**
+     * @brief Visitante de segunTipo para traerHistorial
+     */
+    struct TraerHistorial {
+        FuenteHistorial* fuente;
+
+        template <typename S>
+        void operator()(S& sensor) const {
+            traerHistorial(fuente, sensor);
+        }
+    };
+
+    /**
+     * @brief traerHistorial para un sensor dado por posición y de tipo desconocido
+     */
+    void traerHistorialEn(int posicion) const {
+        TraerHistorial traer = {fuente};
+        segunTipo(tipos.datos()[posicion], sensores.datos()[posicion], traer);
+    }
+
+    /**
+     * @brief Vacía la lista de pendientes y la ordena por tipo
+     * @param posiciones Recibe las posiciones (liberar con delete[]; nullptr si no hay)
+     * @param porTipo Recibe cuántas hay de cada TipoSensor, en ese orden
+     * @return Cantidad total de sensores pendientes
+     *
+     * ORDEN: Por tipo (temperaturas, presiones, otros; cada una con
+     * su versión acotada a continuación) y dentro de cada
+     * uno por posición de registro. Ordenar k enteros cuesta
+     * O(k log k): no depende del tamaño de la flota.
+     */
+    int tomarPendientes(int*& posiciones, int porTipo[CANTIDAD_TIPOS]) {
+        int k = pendientes.tomar(posiciones);
+        for (int t = 0; t < CANTIDAD_TIPOS; t++) {
+            porTipo[t] = 0;
+        }
+        if (k == 0) {
+            return 0;
+        }
+        // Leer tamaño() antes que datos(): toda posición anotada ya está publicada
+        sensores.tamaño();
+        const unsigned char* tipo = tipos.datos();
+        std::sort(posiciones, posiciones + k, [tipo](int a, int b) {
+            return tipo[a] != tipo[b] ? tipo[a] < tipo[b] : a < b;
+        });
+        for (int i = 0; i < k; i++) {
+            porTipo[tipo[posiciones[i]]]++;
+        }
+        return k;
+    }
+
+    /**
+     * @brief Procesa, en orden, un tramo de pendientes que son todos de tipo S
+     *
+     * RAZÓN de anticipar: lista[] es contigua, pero cada sensor vive en
+     * su propio bloque del heap. Pedir el sensor DISTANCIA_ANTICIPO
+     * posiciones adelante solapa esa espera con el trabajo del actual.
+     */
+    template <typename S>
+    void procesarTramo(const int* posiciones, int n) const {
+        SensorBase* const* lista = sensores.datos();
+        for (int i = 0; i < n; i++) {
+            if (i + DISTANCIA_ANTICIPO < n) {
+                anticipar(lista[posiciones[i + DISTANCIA_ANTICIPO]]);
+            }
+            procesarUno(static_cast<S*>(lista[posiciones[i]]));
+        }
+    }
+
+    static const int DISTANCIA_ANTICIPO = 8;  ///< Sensores pedidos por adelantado
+
+    /**
+     * @brief Pide a la caché el comienzo de un sensor sin esperarlo
+     */
+    static void anticipar(const SensorBase* sensor) {
+#if defined(__GNUC__)
+        __builtin_prefetch(sensor);
+#else
+        (void)sensor;
+#endif
+    }
+
+    /**
+     * @brief Procesa un tramo en el pool; la salida de posiciones[i] va a salidas[i]
+     */
+    template <typename S>
+    void procesarTramo(const int* posiciones, int n, PoolHilos& pool, std::ostringstream* salidas) const {
+        SensorBase* const* lista = sensores.datos();
+        pool.ejecutar(n, [this, lista, posiciones, salidas](int i) {
+            DesvioRegistro desvio(salidas[i]);
+            procesarUno(static_cast<S*>(lista[posiciones[i]]));
+        });
+    }
+
+    /**
+     * @brief Visitante de agregarLecturas: un grupo de valores a un sensor
+     *
+     * NOTA: Las plantillas sobre el historial cubren la versión por
+     * bloques y la acotada de cada tipo.
+     */
+    struct AgregarLote {
+        const double* decimales;
+        const int* enteros;
+        int n;
+
+        template <typename H>
+        void operator()(SensorTemperaturaCon<H>& sensor) const {
+            sensor.agregarLecturas(decimales, n);
+        }
+
+        template <typename H>
+        void operator()(SensorPresionCon<H>& sensor) const {
+            sensor.agregarLecturas(enteros, n);
+        }
+
+        void operator()(SensorBase& sensor) const {
+            sensor.agregarLecturas(decimales, n);
+        }
+    };
+
+    /**
+     * @brief Visitante de consultarVentana: S:: evita la tabla virtual
+     */
+    struct ConsultaVentana {
+        int segundos;
+        ResumenVentana* resumen;
+        FuenteHistorial* fuente;
+
+        template <typename S>
+        void operator()(S& sensor) const {
+            traerHistorial(fuente, sensor);
+            *resumen = sensor.S::consultarVentana(segundos);
+        }
+
+        void operator()(SensorBase& sensor) const {
+            traerHistorial(fuente, sensor);
+            *resumen = sensor.consultarVentana(segundos);
+        }
+    };
+
 public:
     /**
      * @brief Constructor del gestor
-     * 
-     * Inicializa la lista vacía y el contador en 0.
+     *
+     * Inicializa el registro vacío.
      */
-    GestorSensores() : cabeza(nullptr), cantidad(0) {
+    GestorSensores() : indice(new TablaIndice(16)), fuente(nullptr) {
         std::cout << "\n[GestorSensores] Sistema inicializado." << std::endl;
     }
-    
+
     /**
      * @brief Destructor - Libera TODOS los sensores y sus listas internas
-     * 
+     *
      * PROCESO CRÍTICO DE LIBERACIÓN EN CASCADA:
-     * 
-     * Para cada sensor en la lista:
+     *
+     * Para cada sensor, en orden de registro:
      * 1. Obtenemos el puntero SensorBase*
      * 2. delete sensor llama a:
      *    a) ~SensorTemperatura() o ~SensorPresion()
      *       - Aquí se imprime el mensaje de liberación
-     *       - Se destruye 'historial' (ListaSensor)
-     *       - ~ListaSensor() libera TODOS los nodos internos
+     *       - Se destruye 'historial'
+     *       - El destructor del historial libera TODOS sus nodos
      *    b) ~SensorBase()
-     * 3. Liberamos el NodoSensor
-     * 
-     * RAZÓN del orden:
-     * - Primero delete sensor (libera el sensor y su lista interna)
-     * - Después delete nodoActual (libera el nodo de gestión)
-     * 
+     * 3. Los arreglos del registro se liberan solos al final
+     *
      * Si no hiciéramos esto = FUGA MASIVA DE MEMORIA:
      * - Los sensores quedarían huérfanos
      * - Sus listas internas nunca se liberarían
@@ -94,148 +483,497 @@ public:
      */
     ~GestorSensores() {
         std::cout << "\n--- Liberación de Memoria en Cascada ---" << std::endl;
-        NodoSensor* actual = cabeza;
-        
-        while (actual != nullptr) {
-            NodoSensor* siguiente = actual->siguiente;
-            
-            std::cout << "[Destructor General] Liberando Nodo: " << actual->sensor->obtenerNombre() << std::endl;
-            
+
+        int n = sensores.tamaño();
+        SensorBase* const* lista = sensores.datos();
+        for (int i = 0; i < n; i++) {
+            std::cout << "[Destructor General] Liberando Nodo: " << lista[i]->obtenerNombre() << std::endl;
+
             // Llamamos al destructor polimórfico
-            delete actual->sensor;  // Libera el sensor virtual
-            delete actual;          // Libera el nodo de gestión
-            
-            actual = siguiente;
+            delete lista[i];
+        }
+
+        TablaIndice* tabla = indice.load(std::memory_order_relaxed);
+        while (tabla != nullptr) {
+            TablaIndice* retirada = tabla->retirada;
+            delete tabla;
+            tabla = retirada;
         }
-        
+
         std::cout << "Sistema cerrado. Memoria limpia." << std::endl;
     }
-    
+
+    /**
+     * @brief Indica de dónde traer los historiales de los sensores restaurados
+     * @param f Fuente (p. ej., AlmacenSegmentos), o nullptr para ninguna
+     *
+     * Un sensor registrado con marcarHistorialGuardado() recibe su
+     * historial la primera vez que se procesa, se lista o se consultan
+     * sus ventanas. Llamar antes de que empiece la ingesta.
+     */
+    void usarFuenteHistorial(FuenteHistorial* f) {
+        fuente = f;
+    }
+
     /**
-     * @brief Agrega un nuevo sensor a la lista de gestión
+     * @brief Agrega un nuevo sensor al registro
      * @param sensor Puntero al sensor (puede ser de cualquier tipo derivado)
-     * 
+     * @return false si ya había un sensor con ese ID; entonces 'sensor'
+     *         no se registra y sigue siendo de quien llama
+     *
      * CONCEPTO - Polimorfismo en Acción:
      * Podemos recibir:
      *   agregarSensor(new SensorTemperatura("T-001"));
      *   agregarSensor(new SensorPresion("P-001"));
-     * 
+     *
      * Ambos se almacenan como SensorBase*, pero mantienen su tipo real.
      * Cuando llamamos sensor->procesarLectura(), se ejecuta la versión
      * correcta según el tipo real del objeto.
-     * 
+     *
      * PROCESO:
-     * 1. Crear un NodoSensor con el puntero
-     * 2. Insertarlo al final de la lista
-     * 3. Incrementar contador
-     */
-    void agregarSensor(SensorBase* sensor) {
-        NodoSensor* nuevoNodo = new NodoSensor(sensor);
-        
-        if (cabeza == nullptr) {
-            cabeza = nuevoNodo;
-            std::cout << "[Gestor] Primer sensor registrado: " << sensor->obtenerNombre() << std::endl;
-        } else {
-            NodoSensor* actual = cabeza;
-            while (actual->siguiente != nullptr) {
-                actual = actual->siguiente;
-            }
-            actual->siguiente = nuevoNodo;
-            std::cout << "[Gestor] Sensor agregado: " << sensor->obtenerNombre() << std::endl;
+     * 1. Rechazarlo si la casilla de su identificador ya tiene sensor
+     * 2. Agregar el puntero y su tipo real al final de 'sensores' y 'tipos'
+     * 3. Escribir su posición en casillas[identificador], creciendo la
+     *    tabla si el identificador todavía no entra
+     */
+    bool agregarSensor(SensorBase* sensor) {
+        std::lock_guard<std::mutex> guardia(cerrojoRegistro);
+        if (buscarEnTabla(indice.load(std::memory_order_relaxed), sensor->obtenerIdentificador()) >= 0) {
+            REGISTRO_ADVERTENCIA("[Gestor] Sensor duplicado ignorado: " << sensor->obtenerNombre());
+            return false;
         }
-        cantidad++;
+        registrar(sensor);
+        return true;
     }
-    
+
+    /**
+     * @brief Registra un sensor solo si su nombre no está registrado
+     * @param sensor Sensor recién creado
+     * @return El sensor que quedó registrado con ese nombre: 'sensor'
+     *         si era nuevo, o el que ya existía
+     *
+     * RAZÓN: Con varios hilos de ingesta, dos pueden no encontrar el
+     * mismo ID a la vez y crear cada uno su sensor. La comprobación se
+     * repite aquí con el cerrojo tomado; si otro hilo ganó, quien llama
+     * debe liberar su 'sensor' y usar el devuelto.
+     */
+    SensorBase* registrarSiFalta(SensorBase* sensor) {
+        std::lock_guard<std::mutex> guardia(cerrojoRegistro);
+        int existente = buscarEnTabla(indice.load(std::memory_order_relaxed), sensor->obtenerIdentificador());
+        if (existente >= 0) {
+            return sensores.datos()[existente];
+        }
+        registrar(sensor);
+        METRICA_CONTAR(CONTADOR_SENSORES_NUEVOS, 1);
+        return sensor;
+    }
+
     /**
      * @brief Busca un sensor por su ID
      * @param id Identificador del sensor a buscar
      * @return Puntero al sensor encontrado, o nullptr si no existe
-     * 
+     *
      * RAZÓN de retorno SensorBase*:
      * - El código cliente puede trabajar con el sensor sin saber su tipo
      * - Puede llamar a métodos polimórficos directamente
-     * 
+     *
+     * COMPLEJIDAD: Una búsqueda en TablaIdentificadores para traducir el
+     * texto y luego O(1) exacto: una casilla leída por su identificador.
      */
 
     // Aquí es donde se realiza la busqueda
     SensorBase* buscarSensor(const char* id) {
-        NodoSensor* actual = cabeza;
-        
-        // Iteracion para busqueda
-        while (actual != nullptr) {
-            // Compara los valores y retorna 0 si es verdadero
-            if (strcmp(actual->sensor->obtenerNombre(), id) == 0) {
-                return actual->sensor;
+        return buscarSensor(id, static_cast<int>(strlen(id)));
+    }
+
+    /**
+     * @brief Busca un sensor por un ID que no termina en '\0'
+     * @param id Primer carácter del ID (por ejemplo, dentro del buffer serial)
+     * @param largo Cantidad de caracteres del ID
+     * @return Puntero al sensor encontrado, o nullptr si no existe
+     *
+     * RAZÓN: El parser entrega el ID como rebanada del buffer recibido;
+     * así lo buscamos sin copiarlo a otra cadena.
+     *
+     * SIN CERROJOS: Se lee la tabla vigente con acquire. Si en ese
+     * momento otro hilo la reemplaza, seguimos en la vieja, que sigue
+     * viva y válida (solo le faltaría el sensor recién agregado).
+     *
+     * COSTO: Una búsqueda en TablaIdentificadores (la única comparación
+     * de texto) y una casilla leída por su identificador.
+     */
+    SensorBase* buscarSensor(const char* id, int largo) {
+        int i = buscarPosicion(id, largo);
+        return i >= 0 ? sensores.datos()[i] : nullptr;
+    }
+
+    /**
+     * @brief Busca un sensor por su identificador internado
+     * @param identificador Valor de SensorBase::obtenerIdentificador o LecturaParseada::identificador
+     * @return Puntero al sensor encontrado, o nullptr si no existe en este gestor
+     */
+    SensorBase* buscarSensor(unsigned int identificador) {
+        int i = buscarEnTabla(indice.load(std::memory_order_acquire), identificador);
+        return i >= 0 ? sensores.datos()[i] : nullptr;
+    }
+
+    /**
+     * @brief Busca un sensor y le aplica un visitante según su tipo real
+     * @tparam Visitante Clase con operator() para SensorTemperatura&,
+     *         SensorPresion& y SensorBase& (los demás tipos). Las
+     *         versiones acotadas caen en SensorBase& salvo que el
+     *         visitante las acepte (p. ej., con SensorTemperaturaCon<H>&)
+     * @param id Primer carácter del ID
+     * @param largo Cantidad de caracteres del ID
+     * @param visitante Se llama una vez, con el cerrojo del sensor tomado
+     * @return false si el sensor no existe
+     *
+     * CONCEPTO - Polimorfismo estático:
+     * El switch sobre 'tipos' reemplaza a la tabla virtual. Como cada
+     * rama llama al operator() de un tipo concreto (y esas clases son
+     * 'final'), el compilador puede expandir agregarLectura en línea
+     * en la ruta de ingesta. La interfaz virtual sigue disponible
+     * para sensores nuevos: caen en la rama TIPO_OTRO.
+     *
+     * EJEMPLO:
+     *   struct Agregar {
+     *       double valor;
+     *       void operator()(SensorTemperatura& s) const { s.agregarLectura(valor); }
+     *       void operator()(SensorPresion& s) const { s.agregarLectura(static_cast<int>(valor)); }
+     *       void operator()(SensorBase& s) const { s.agregarLectura(valor); }
+     *   };
+     *   gestor.visitarSensor("T-001", 5, Agregar{23.5});
+     */
+    template <typename Visitante>
+    bool visitarSensor(const char* id, int largo, Visitante visitante) {
+        METRICA_INICIO(inicioBusqueda);
+        int i = buscarPosicion(id, largo);
+        METRICA_FIN(ETAPA_BUSQUEDA, inicioBusqueda);
+        if (i < 0) {
+            return false;
+        }
+
+        SensorBase* sensor = sensores.datos()[i];
+        std::lock_guard<std::mutex> guardia(sensor->obtenerCerrojo());
+        segunTipo(tipos.datos()[i], sensor, visitante);
+        return true;
+    }
+
+    /**
+     * @brief Resume las lecturas de un sensor en los últimos segundos
+     * @param id Identificador del sensor
+     * @param segundos Largo de la ventana (ej: 60, 300, 3600)
+     * @param resumen Recibe cantidad, media, mínimo y máximo
+     * @return false si el sensor no existe
+     *
+     * RAZÓN: Va por visitarSensor, así la consulta toma el cerrojo del
+     * sensor y en los tipos conocidos no pasa por la tabla virtual.
+     */
+    bool consultarVentana(const char* id, int segundos, ResumenVentana& resumen) {
+        ConsultaVentana consulta = {segundos, &resumen, fuente};
+        return visitarSensor(id, static_cast<int>(strlen(id)), consulta);
+    }
+
+    static const int LOTE_MAXIMO_AGREGAR = 256;  ///< Lecturas por tramo de agregarLecturas
+
+    /**
+     * @brief Agrega un lote de lecturas ya parseadas, agrupadas por sensor
+     * @tparam Fabrica Función u objeto: SensorBase* (const LecturaParseada&),
+     *         que crea el sensor de un ID desconocido o devuelve nullptr
+     *         para descartar la lectura
+     * @param lecturas Primera lectura del lote (p. ej., lo desencolado de la cola)
+     * @param cantidad Lecturas del lote
+     * @param crearSensor Se llama como máximo una vez por ID nuevo
+     * @return Lecturas agregadas (las descartadas por la fábrica no cuentan)
+     *
+     * PROCESO:
+     * 1. Resolver cada lectura a la posición de su sensor (creándolo si falta)
+     * 2. Ordenar el lote por posición, sin alterar el orden de llegada
+     *    de las lecturas de un mismo sensor (stable_sort)
+     * 3. Por cada sensor: un cerrojo, un despacho por tipo y una sola
+     *    llamada a agregarLecturas con todos sus valores seguidos
+     *
+     * RAZÓN: En una ráfaga del puerto serial llegan muchas líneas de los
+     * mismos pocos sensores; así la búsqueda repetida es lo único que se
+     * paga por lectura, y el historial inserta en bloque. Si la lectura
+     * ya trae su identificador, esa búsqueda es leer una casilla.
+     *
+     * NOTA: Cada sensor recibe sus valores como en visitarSensor con
+     * AgregarLectura: 'decimal' si es de temperatura u otro tipo, y
+     * 'entero' si es de presión. Las lecturas traen los dos campos
+     * llenos (completarValores), sea cual sea el tipo de la línea.
+     *
+     * MEMORIA: Los arreglos auxiliares viven en la pila, con lugar para
+     * LOTE_MAXIMO_AGREGAR lecturas (lo que entregan la cola de --hilos y
+     * un registro de la bitácora). Un lote mayor se reparte en tramos de
+     * ese tamaño; así el camino de ingesta no pide memoria.
+     */
+    template <typename Fabrica>
+    int agregarLecturas(const LecturaParseada* lecturas, int cantidad, Fabrica crearSensor) {
+        if (cantidad > LOTE_MAXIMO_AGREGAR) {
+            int agregadas = 0;
+            for (int desde = 0; desde < cantidad; desde += LOTE_MAXIMO_AGREGAR) {
+                int tramo = cantidad - desde < LOTE_MAXIMO_AGREGAR ? cantidad - desde : LOTE_MAXIMO_AGREGAR;
+                agregadas += agregarLecturas(lecturas + desde, tramo, crearSensor);
+            }
+            return agregadas;
+        }
+        if (cantidad <= 0) {
+            return 0;
+        }
+
+        int posiciones[LOTE_MAXIMO_AGREGAR];
+        int orden[LOTE_MAXIMO_AGREGAR];
+        int validas = 0;
+
+        for (int i = 0; i < cantidad; i++) {
+            const LecturaParseada& lectura = lecturas[i];
+            METRICA_INICIO(inicioBusqueda);
+            int pos;
+            if (lectura.identificador != IDENTIFICADOR_DESCONOCIDO) {
+                pos = buscarEnTabla(indice.load(std::memory_order_acquire), lectura.identificador);
+            } else {
+                pos = buscarPosicion(lectura.id, lectura.largoId);
+            }
+            METRICA_FIN(ETAPA_BUSQUEDA, inicioBusqueda);
+            if (pos < 0) {
+                SensorBase* nuevo = crearSensor(lectura);
+                if (nuevo == nullptr) {
+                    continue;
+                }
+                // Si otro hilo registró el mismo ID mientras tanto, se usa el suyo
+                SensorBase* registrado = registrarSiFalta(nuevo);
+                if (registrado != nuevo) {
+                    delete nuevo;
+                }
+                pos = buscarEnTabla(indice.load(std::memory_order_acquire), registrado->obtenerIdentificador());
+            }
+            posiciones[i] = pos;
+            orden[validas++] = i;
+        }
+
+        std::stable_sort(orden, orden + validas, [posiciones](int a, int b) {
+            return posiciones[a] < posiciones[b];
+        });
+
+        double decimales[LOTE_MAXIMO_AGREGAR];
+        int enteros[LOTE_MAXIMO_AGREGAR];
+        SensorBase* const* lista = sensores.datos();
+        const unsigned char* tipo = tipos.datos();
+
+        int inicio = 0;
+        while (inicio < validas) {
+            int pos = posiciones[orden[inicio]];
+            int fin = inicio;
+            while (fin < validas && posiciones[orden[fin]] == pos) {
+                decimales[fin - inicio] = lecturas[orden[fin]].decimal;
+                enteros[fin - inicio] = lecturas[orden[fin]].entero;
+                fin++;
             }
-            
-            // Si no lo es itera con el siguiente elemento de la lista
-            actual = actual->siguiente;
+            int n = fin - inicio;
+
+            SensorBase* sensor = lista[pos];
+            std::lock_guard<std::mutex> guardia(sensor->obtenerCerrojo());
+            // Un evento de inserción por grupo: mide el costo de un lote de un sensor
+            METRICA_INICIO(inicioInsercion);
+            AgregarLote lote = {decimales, enteros, n};
+            segunTipo(tipo[pos], sensor, lote);
+            METRICA_FIN(ETAPA_INSERCION, inicioInsercion);
+            inicio = fin;
         }
-        
-        // No se encontro
-        return nullptr;
+
+        METRICA_CONTAR(CONTADOR_LECTURAS, static_cast<unsigned long long>(validas));
+        return validas;
     }
-    
+
     /**
-     * @brief Procesa todos los sensores registrados
-     * 
+     * @brief Procesa los sensores que recibieron lecturas desde la última pasada
+     *
      * DEMOSTRACIÓN DEL POLIMORFISMO:
-     * 
-     * Para cada sensor en la lista:
-     *   sensor->procesarLectura();
-     * 
-     * Aunque todos son SensorBase*, cada uno ejecuta SU PROPIA versión:
+     *
+     * Cada sensor ejecuta SU PROPIA versión de procesarLectura:
      * - SensorTemperatura: Elimina mínimo + promedio
      * - SensorPresion: Solo promedio
-     * 
-     * El gestor no necesita saber qué tipo es cada sensor.
-     * El polimorfismo se encarga automáticamente.
+     *
+     * ORDEN: Un tramo por TipoSensor (temperaturas, temperaturas
+     * acotadas, presiones, presiones acotadas, otros; ver tomarPendientes)
+     * y dentro de cada tramo por posición en el arreglo de sensores. En
+     * los cuatro primeros tramos el tipo ya se conoce y la llamada no
+     * pasa por la tabla virtual.
+     *
+     * INCREMENTAL: Un sensor sin lecturas nuevas no se vuelve a procesar
+     * (tampoco pierde otro mínimo). La primera pasada los ve a todos,
+     * porque todos llegaron con alguna lectura.
      */
     void procesarTodos() {
-        if (cabeza == nullptr) {
-            std::cout << "[Gestor] No hay sensores para procesar." << std::endl;
+        if (sensores.tamaño() == 0) {
+            std::cout << "[Gestor] No hay sensores para procesar.\n";
             return;
         }
-        
-        std::cout << "\n--- Ejecutando Polimorfismo ---" << std::endl;
-        NodoSensor* actual = cabeza;
-        
-        while (actual != nullptr) {
-            // Aqui se aplica el polimorfismo llamando la función correcta
-            actual->sensor->procesarLectura();
-            actual = actual->siguiente;
+
+        std::cout << "\n--- Ejecutando Polimorfismo ---\n";
+        METRICA_INICIO(inicioPasada);
+        int* posiciones;
+        int porTipo[CANTIDAD_TIPOS];
+        if (tomarPendientes(posiciones, porTipo) == 0) {
+            std::cout << "[Gestor] Ningún sensor recibió lecturas desde la última pasada.\n";
+            return;
         }
+        const int* tramo = posiciones;
+        procesarTramo<SensorTemperatura>(tramo, porTipo[TIPO_TEMPERATURA]);
+        tramo += porTipo[TIPO_TEMPERATURA];
+        procesarTramo<SensorTemperaturaAcotado>(tramo, porTipo[TIPO_TEMPERATURA_ACOTADO]);
+        tramo += porTipo[TIPO_TEMPERATURA_ACOTADO];
+        procesarTramo<SensorPresion>(tramo, porTipo[TIPO_PRESION]);
+        tramo += porTipo[TIPO_PRESION];
+        procesarTramo<SensorPresionAcotado>(tramo, porTipo[TIPO_PRESION_ACOTADO]);
+        tramo += porTipo[TIPO_PRESION_ACOTADO];
+        procesarTramo<SensorBase>(tramo, porTipo[TIPO_OTRO]);
+        METRICA_FIN(ETAPA_PROCESO, inicioPasada);
+
+        delete[] posiciones;
     }
-    
+
     /**
-     * @brief Imprime información de todos los sensores
+     * @brief Procesa todos los sensores repartiéndolos entre varios hilos
+     * @param pool Hilos trabajadores que se usarán
+     *
+     * RAZÓN de que sea seguro:
+     * Cada sensor tiene su propio historial y su propio pool de nodos;
+     * dos hilos nunca tocan el mismo sensor en la misma ronda.
+     *
+     * SALIDA DETERMINISTA:
+     * Cada sensor escribe sus mensajes en su propio ostringstream
+     * (DesvioRegistro). Al terminar se imprimen en el mismo orden que
+     * usa procesarTodos(), así el resultado es idéntico sin importar
+     * qué hilo procesó cada sensor. Se hace una ronda del pool por tipo.
+     * Igual que procesarTodos(), solo se visitan los sensores pendientes.
+     */
+    void procesarTodos(PoolHilos& pool) {
+        if (sensores.tamaño() == 0) {
+            std::cout << "[Gestor] No hay sensores para procesar.\n";
+            return;
+        }
+
+        // Los sensores que cambien mientras tanto quedan para la próxima
+        METRICA_INICIO(inicioPasada);
+        int* posiciones;
+        int porTipo[CANTIDAD_TIPOS];
+        int n = tomarPendientes(posiciones, porTipo);
+        std::ostringstream* salidas = new std::ostringstream[n > 0 ? n : 1];
+        int hecho = 0;
+        procesarTramo<SensorTemperatura>(posiciones, porTipo[TIPO_TEMPERATURA], pool, salidas);
+        hecho += porTipo[TIPO_TEMPERATURA];
+        procesarTramo<SensorTemperaturaAcotado>(posiciones + hecho, porTipo[TIPO_TEMPERATURA_ACOTADO],
+                                                pool, salidas + hecho);
+        hecho += porTipo[TIPO_TEMPERATURA_ACOTADO];
+        procesarTramo<SensorPresion>(posiciones + hecho, porTipo[TIPO_PRESION], pool, salidas + hecho);
+        hecho += porTipo[TIPO_PRESION];
+        procesarTramo<SensorPresionAcotado>(posiciones + hecho, porTipo[TIPO_PRESION_ACOTADO],
+                                            pool, salidas + hecho);
+        hecho += porTipo[TIPO_PRESION_ACOTADO];
+        procesarTramo<SensorBase>(posiciones + hecho, porTipo[TIPO_OTRO], pool, salidas + hecho);
+        METRICA_FIN(ETAPA_PROCESO, inicioPasada);
+
+        std::cout << "\n--- Ejecutando Polimorfismo (" << pool.obtenerCantidadHilos()
+                  << " hilos) ---\n";
+        if (n == 0) {
+            std::cout << "[Gestor] Ningún sensor recibió lecturas desde la última pasada.\n";
+        }
+        for (int i = 0; i < n; i++) {
+            std::cout << salidas[i].str();
+        }
+
+        delete[] salidas;
+        delete[] posiciones;
+    }
+
+    /**
+     * @brief Imprime información de todos los sensores, en orden de registro
      */
     void listarSensores() const {
-        if (cabeza == nullptr) {
-            std::cout << "[Gestor] No hay sensores registrados." << std::endl;
+        EscritorInforme salida(std::cout);
+        listarSensores(salida, OpcionesInforme());
+    }
+
+    /**
+     * @brief Escribe el listado de sensores en un informe con buffer
+     * @param salida Destino (std::cout, un archivo, ...); ver EscritorInforme.h
+     * @param opciones Completo, solo resumen, o últimas N lecturas por sensor
+     *
+     * RAZÓN: Con muchos sensores y lecturas, el listado era una llamada
+     * a operator<< (y un vaciado por std::endl) por valor. Aquí cada
+     * sensor escribe en el buffer del informe mientras se tiene su
+     * cerrojo, y el buffer se entrega en bloques grandes: la memoria
+     * extra es el buffer, no una copia del listado.
+     */
+    void listarSensores(EscritorInforme& salida, const OpcionesInforme& opciones) const {
+        int n = sensores.tamaño();
+        if (n == 0) {
+            salida << "[Gestor] No hay sensores registrados.\n";
             return;
         }
-        
-        std::cout << "\n=== Lista de Sensores Registrados ===" << std::endl;
-        std::cout << "Total de sensores: " << cantidad  << std::endl << std::endl;
-        
-        NodoSensor* actual = cabeza;
-        int index = 1;
-        
-        while (actual != nullptr) {
-            std::cout << index++ << ". ";
-            actual->sensor->imprimirInfo();
-            actual = actual->siguiente;
+
+        salida << "\n=== Lista de Sensores Registrados ===\n";
+        salida << "Total de sensores: " << n << "\n\n";
+
+        SensorBase* const* lista = sensores.datos();
+        for (int i = 0; i < n; i++) {
+            if (i + DISTANCIA_ANTICIPO < n) {
+                anticipar(lista[i + DISTANCIA_ANTICIPO]);
+            }
+            salida << i + 1 << ". ";
+            std::lock_guard<std::mutex> guardia(lista[i]->obtenerCerrojo());
+            traerHistorialEn(i);
+            lista[i]->escribirInforme(salida, opciones);
         }
     }
-    
+
+    /**
+     * @brief Imprime el resumen de último minuto, 5 minutos y hora de cada sensor
+     *
+     * FORMATO por ventana: cantidad de lecturas y media [mínimo, máximo],
+     * o '-' si no llegó ninguna en ese lapso.
+     */
+    void imprimirVentanas() const {
+        int n = sensores.tamaño();
+        if (n == 0) {
+            return;
+        }
+
+        static const int ventanas[3] = {60, 300, 3600};
+        static const char* const titulos[3] = {"1 min", "5 min", "1 h"};
+
+        std::cout << "\n=== Ventanas de tiempo ===\n";
+        SensorBase* const* lista = sensores.datos();
+        for (int i = 0; i < n; i++) {
+            std::cout << lista[i]->obtenerNombre() << ":";
+            std::lock_guard<std::mutex> guardia(lista[i]->obtenerCerrojo());
+            traerHistorialEn(i);
+            for (int v = 0; v < 3; v++) {
+                ResumenVentana r = lista[i]->consultarVentana(ventanas[v]);
+                std::cout << "  " << titulos[v] << " ";
+                if (r.cantidad == 0) {
+                    std::cout << "-";
+                } else {
+                    std::cout << r.cantidad << " x " << r.media
+                              << " [" << r.minimo << ", " << r.maximo << "]";
+                }
+            }
+            std::cout << '\n';
+        }
+    }
+
     /**
      * @brief Obtiene el número de sensores registrados
      * @return Cantidad de sensores
      */
     int obtenerCantidad() const {
-        return cantidad;
+        return sensores.tamaño();
     }
+
+    GestorSensores(const GestorSensores&) = delete;
+    GestorSensores& operator=(const GestorSensores&) = delete;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,572 @@
+/**
+ * @file HistorialCircular.h
+ * @brief Historial de capacidad fija (buffer circular) con retención configurable
+ * @details Ofrece la misma interfaz que ListaSensor, pero guarda como máximo
+ *          'capacidad' lecturas en un arreglo reservado una sola vez. Al
+ *          llenarse, la lectura más vieja se sobrescribe. Opcionalmente se
+ *          descartan las lecturas más viejas que una ventana de tiempo.
+ */
+
+#ifndef HISTORIAL_CIRCULAR_H
+#define HISTORIAL_CIRCULAR_H
+
+#include "Registro.h"
+#include "EstadisticasLista.h"
+#include "NucleosSimd.h"
+#include "VentanasTiempo.h"
+#include "EscritorInforme.h"
+#include <climits>
+#include <utility>
+
+/**
+ * @class HistorialCircular
+ * @brief Buffer circular de lecturas con la interfaz de ListaSensor
+ * @tparam T Tipo de dato que almacenará el historial
+ *
+ * CONCEPTO - Buffer circular:
+ * Un arreglo donde 'inicio' marca la lectura más vieja y las nuevas se
+ * escriben en (inicio + tamaño) % capacidad. Cuando está lleno, escribir
+ * una nueva lectura pisa la más vieja y 'inicio' avanza una posición.
+ *
+ * RAZÓN:
+ * - La memoria no crece con el tiempo que lleva encendido el sistema
+ * - En régimen estable insertar no pide memoria (cero 'new')
+ *
+ * RETENCIÓN POR TIEMPO:
+ * Si ventanaMs > 0, al insertar se descartan las lecturas con más de
+ * ventanaMs milisegundos de antigüedad (reloj monotónico).
+ */
+template <typename T>
+class HistorialCircular {
+private:
+    T* datos;                  ///< Arreglo circular de lecturas
+    long long* marcas;         ///< Marca de tiempo (ms) por lectura, solo con ventana
+    int capacidad;             ///< Lecturas máximas
+    int inicio;                ///< Índice de la lectura más vieja
+    int tamaño;                ///< Lecturas almacenadas
+    long long ventanaMs;       ///< Antigüedad máxima en ms (0 = sin límite)
+    EstadisticasLista<T> estadisticas;  ///< Agregados incrementales
+    int copiasMinimo;          ///< Lecturas retenidas iguales al mínimo
+    int copiasMaximo;          ///< Lecturas retenidas iguales al máximo
+
+    /**
+     * @brief Convierte una posición lógica (0 = más vieja) a índice del arreglo
+     */
+    int indice(int i) const {
+        int pos = inicio + i;
+        return pos >= capacidad ? pos - capacidad : pos;
+    }
+
+    /**
+     * @brief Largo del primer tramo contiguo (desde 'inicio' hasta el final del arreglo)
+     *
+     * CONCEPTO: Las lecturas ocupan datos[inicio .. inicio+primerTramo) y,
+     * si dieron la vuelta, datos[0 .. tamaño-primerTramo). Cada tramo es
+     * un arreglo común que los núcleos de NucleosSimd.h recorren enteros.
+     */
+    int primerTramo() const {
+        int hastaElFinal = capacidad - inicio;
+        return tamaño < hastaElFinal ? tamaño : hastaElFinal;
+    }
+
+    /**
+     * @brief Recalcula mínimo y máximo (y sus copias) recorriendo el arreglo
+     *
+     * NOTA: Solo se necesita cuando sale del historial la última copia
+     * del mínimo o del máximo, o tras eliminarMinimo.
+     */
+    void recalcularExtremos() {
+        if (tamaño == 0) {
+            return;
+        }
+        T minimo, maximo;
+        int largo1 = primerTramo();
+        buscarExtremos(datos + inicio, largo1, minimo, maximo);
+        if (tamaño > largo1) {
+            T minimo2, maximo2;
+            buscarExtremos(datos, tamaño - largo1, minimo2, maximo2);
+            minimo = minimo2 < minimo ? minimo2 : minimo;
+            maximo = maximo < maximo2 ? maximo2 : maximo;
+        }
+        estadisticas.fijarExtremos(minimo, maximo);
+
+        copiasMinimo = 0;
+        copiasMaximo = 0;
+        for (int i = 0; i < tamaño; i++) {
+            T v = datos[indice(i)];
+            if (!(minimo < v)) {
+                copiasMinimo++;
+            }
+            if (!(v < maximo)) {
+                copiasMaximo++;
+            }
+        }
+    }
+
+    /**
+     * @brief Cuenta las copias de los extremos antes de registrar una lectura
+     * @param valor Lectura que se va a agregar a 'estadisticas'
+     */
+    void contarExtremos(T valor) {
+        if (tamaño == 0) {
+            copiasMinimo = 1;
+            copiasMaximo = 1;
+            return;
+        }
+        T minimo = estadisticas.obtenerMinimo();
+        T maximo = estadisticas.obtenerMaximo();
+        if (valor < minimo) {
+            copiasMinimo = 1;
+        } else if (!(minimo < valor)) {
+            copiasMinimo++;
+        }
+        if (maximo < valor) {
+            copiasMaximo = 1;
+        } else if (!(valor < maximo)) {
+            copiasMaximo++;
+        }
+    }
+
+    /**
+     * @brief Descarta la lectura más vieja
+     *
+     * RAZÓN de contar copias: Con una presión constante o una
+     * temperatura trabada, casi toda lectura que sale es igual al
+     * mínimo y al máximo. Solo cuando sale la ÚLTIMA copia hay que
+     * recorrer el arreglo; antes, cada inserción con el buffer lleno
+     * costaba O(capacidad).
+     */
+    void descartarMasVieja() {
+        T viejo = datos[inicio];
+        inicio = indice(1);
+        tamaño--;
+        bool eraMinimo = !(estadisticas.obtenerMinimo() < viejo);
+        bool eraMaximo = !(viejo < estadisticas.obtenerMaximo());
+        estadisticas.quitar(viejo);
+        if (eraMinimo) {
+            copiasMinimo--;
+        }
+        if (eraMaximo) {
+            copiasMaximo--;
+        }
+        if ((eraMinimo && copiasMinimo == 0) || (eraMaximo && copiasMaximo == 0)) {
+            recalcularExtremos();
+        }
+    }
+
+    /**
+     * @brief Reserva los arreglos para una capacidad y ventana dadas
+     */
+    void reservar(int nuevaCapacidad, long long nuevaVentanaMs) {
+        capacidad = nuevaCapacidad > 0 ? nuevaCapacidad : 1;
+        ventanaMs = nuevaVentanaMs > 0 ? nuevaVentanaMs : 0;
+        datos = new T[capacidad];
+        marcas = ventanaMs > 0 ? new long long[capacidad] : nullptr;
+        inicio = 0;
+        tamaño = 0;
+        estadisticas.reiniciar();
+        copiasMinimo = 0;
+        copiasMaximo = 0;
+    }
+
+    /**
+     * @brief Copia de otro historial ya reservado con la misma capacidad
+     */
+    void copiarDe(const HistorialCircular& otra) {
+        for (int i = 0; i < otra.tamaño; i++) {
+            int pos = otra.indice(i);
+            datos[i] = otra.datos[pos];
+            if (marcas != nullptr) {
+                marcas[i] = otra.marcas[pos];
+            }
+        }
+        tamaño = otra.tamaño;
+        estadisticas = otra.estadisticas;
+        copiasMinimo = otra.copiasMinimo;
+        copiasMaximo = otra.copiasMaximo;
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacidadMaxima Lecturas que se conservan (por defecto 1024)
+     * @param ventanaSegundos Antigüedad máxima de una lectura; 0 = sin límite
+     */
+    explicit HistorialCircular(int capacidadMaxima = 1024, int ventanaSegundos = 0) {
+        reservar(capacidadMaxima, static_cast<long long>(ventanaSegundos) * 1000);
+        REGISTRO_DETALLE("[LOG] Historial circular creado (capacidad " << capacidad << ")");
+    }
+
+    /**
+     * @brief Destructor: libera los arreglos (dos 'delete[]' en total)
+     */
+    ~HistorialCircular() {
+        delete[] datos;
+        delete[] marcas;
+        REGISTRO_DETALLE("\t[LOG] Historial circular destruido");
+    }
+
+    /**
+     * @brief Constructor de copia: misma capacidad, ventana y lecturas
+     */
+    HistorialCircular(const HistorialCircular& otra) {
+        reservar(otra.capacidad, otra.ventanaMs);
+        copiarDe(otra);
+    }
+
+    /**
+     * @brief Operador de asignación
+     * @param otra Historial a asignar
+     * @return Referencia a este historial
+     */
+    HistorialCircular& operator=(const HistorialCircular& otra) {
+        if (this != &otra) {
+            delete[] datos;
+            delete[] marcas;
+            reservar(otra.capacidad, otra.ventanaMs);
+            copiarDe(otra);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Constructor de movimiento: toma los arreglos de 'otra' en O(1)
+     * @param otra Historial que queda sin arreglos
+     *
+     * NOTA: El historial movido solo admite destruirse o recibir una
+     * asignación; reservarle arreglos nuevos haría del movimiento una
+     * petición de memoria más.
+     */
+    HistorialCircular(HistorialCircular&& otra) noexcept
+        : datos(otra.datos), marcas(otra.marcas), capacidad(otra.capacidad),
+          inicio(otra.inicio), tamaño(otra.tamaño), ventanaMs(otra.ventanaMs),
+          estadisticas(otra.estadisticas), copiasMinimo(otra.copiasMinimo),
+          copiasMaximo(otra.copiasMaximo) {
+        otra.datos = nullptr;
+        otra.marcas = nullptr;
+        otra.capacidad = 0;
+        otra.inicio = 0;
+        otra.tamaño = 0;
+        otra.estadisticas.reiniciar();
+        otra.copiasMinimo = 0;
+        otra.copiasMaximo = 0;
+    }
+
+    /**
+     * @brief Asignación por movimiento (intercambio: 'otra' libera lo nuestro)
+     * @param otra Historial que entrega sus arreglos
+     * @return Referencia a este historial
+     */
+    HistorialCircular& operator=(HistorialCircular&& otra) noexcept {
+        intercambiar(otra);
+        return *this;
+    }
+
+    /**
+     * @brief Intercambia lecturas, capacidad y ventana con otro historial en O(1)
+     * @param otra Historial con el que se intercambia
+     */
+    void intercambiar(HistorialCircular& otra) noexcept {
+        std::swap(datos, otra.datos);
+        std::swap(marcas, otra.marcas);
+        std::swap(capacidad, otra.capacidad);
+        std::swap(inicio, otra.inicio);
+        std::swap(tamaño, otra.tamaño);
+        std::swap(ventanaMs, otra.ventanaMs);
+        std::swap(estadisticas, otra.estadisticas);
+        std::swap(copiasMinimo, otra.copiasMinimo);
+        std::swap(copiasMaximo, otra.copiasMaximo);
+    }
+
+    /**
+     * @brief Versión libre para std::swap y algoritmos de la biblioteca
+     */
+    friend void swap(HistorialCircular& a, HistorialCircular& b) noexcept {
+        a.intercambiar(b);
+    }
+
+    /**
+     * @brief Inserta una lectura con la marca actual
+     * @param valor Dato a insertar
+     *
+     * NOTA: Sin ventana no se guardan marcas, así que ni se lee el reloj.
+     */
+    void insertarAlFinal(T valor) {
+        insertarAlFinal(valor, marcas != nullptr ? relojMonotonicoMs() : 0);
+    }
+
+    /**
+     * @brief Inserta una lectura, sobrescribiendo la más vieja si está lleno
+     * @param valor Dato a insertar
+     * @param ahora Marca monotónica (ms) de la lectura
+     *
+     * PROCESO:
+     * 1. Si hay ventana de tiempo, descartar lecturas vencidas
+     * 2. Si está lleno, descartar la más vieja
+     * 3. Escribir la lectura al final
+     */
+    void insertarAlFinal(T valor, long long ahora) {
+        if (marcas != nullptr) {
+            while (tamaño > 0 && ahora - marcas[inicio] > ventanaMs) {
+                descartarMasVieja();
+            }
+        }
+
+        if (tamaño == capacidad) {
+            descartarMasVieja();
+        }
+
+        int pos = indice(tamaño);
+        datos[pos] = valor;
+        if (marcas != nullptr) {
+            marcas[pos] = ahora;
+        }
+        contarExtremos(valor);
+        tamaño++;
+        estadisticas.agregar(valor);
+
+        REGISTRO_DETALLE("[LOG] Lectura guardada en historial circular: " << valor);
+    }
+
+    /**
+     * @brief Inserta un lote de lecturas con la marca actual
+     * @tparam U Tipo de origen (ej: double del parser); se convierte a T
+     */
+    template <typename U>
+    void insertarVarios(const U* valores, int cantidad) {
+        insertarVarios(valores, cantidad, marcas != nullptr ? relojMonotonicoMs() : 0);
+    }
+
+    /**
+     * @brief Inserta un lote de lecturas llegadas al mismo tiempo
+     * @tparam U Tipo de origen (ej: double del parser); se convierte a T
+     * @param valores Primera lectura del lote
+     * @param cantidad Lecturas del lote
+     * @param ahora Marca monotónica (ms) común a todo el lote
+     *
+     * PROCESO:
+     * 1. Todo el lote lleva la misma marca
+     * 2. Si el lote no cabe, sus primeras lecturas se sobrescribirían
+     *    dentro del mismo lote; se saltan sin escribirlas
+     * 3. El resto se escribe como en insertarAlFinal, sin log por lectura
+     */
+    template <typename U>
+    void insertarVarios(const U* valores, int cantidad, long long ahora) {
+        if (cantidad <= 0) {
+            return;
+        }
+
+        if (marcas != nullptr) {
+            while (tamaño > 0 && ahora - marcas[inicio] > ventanaMs) {
+                descartarMasVieja();
+            }
+        }
+
+        int desde = cantidad > capacidad ? cantidad - capacidad : 0;
+        for (int i = desde; i < cantidad; i++) {
+            if (tamaño == capacidad) {
+                descartarMasVieja();
+            }
+            T valor = static_cast<T>(valores[i]);
+            int pos = indice(tamaño);
+            datos[pos] = valor;
+            if (marcas != nullptr) {
+                marcas[pos] = ahora;
+            }
+            contarExtremos(valor);
+            tamaño++;
+            estadisticas.agregar(valor);
+        }
+
+        REGISTRO_DETALLE("[LOG] " << cantidad << " lectura(s) guardadas en historial circular");
+    }
+
+    /**
+     * @brief Promedio de las lecturas retenidas
+     * @return Promedio de tipo T, en O(1)
+     */
+    T calcularPromedio() const {
+        if (tamaño == 0) {
+            REGISTRO_ADVERTENCIA("[ADVERTENCIA] Lista vacía, retornando 0.");
+            return static_cast<T>(0);
+        }
+        return estadisticas.promedio();
+    }
+
+    /**
+     * @brief Elimina la primera ocurrencia del valor más bajo
+     * @return El valor eliminado
+     *
+     * PROCESO:
+     * 1. Buscar el mínimo en el arreglo (acceso contiguo)
+     * 2. Recorrer una posición hacia atrás las lecturas que le siguen
+     */
+    T eliminarMinimo() {
+        if (tamaño == 0) {
+            REGISTRO_ERROR("[ERRROR] No hay elementos para eliminar.");
+            return static_cast<T>(0);
+        }
+
+        // Primer mínimo de cada tramo; ante empate gana el primer tramo (más viejo)
+        int largo1 = primerTramo();
+        int posMin = posicionMinimo(datos + inicio, largo1);
+        if (tamaño > largo1) {
+            int pos2 = posicionMinimo(datos, tamaño - largo1);
+            if (datos[pos2] < datos[inicio + posMin]) {
+                posMin = largo1 + pos2;
+            }
+        }
+
+        T valorMin = datos[indice(posMin)];
+        for (int i = posMin + 1; i < tamaño; i++) {
+            datos[indice(i - 1)] = datos[indice(i)];
+            if (marcas != nullptr) {
+                marcas[indice(i - 1)] = marcas[indice(i)];
+            }
+        }
+        tamaño--;
+
+        estadisticas.quitar(valorMin);
+        recalcularExtremos();
+
+        REGISTRO_DETALLE("[LOG] Valor mínimo eliminado: " << valorMin);
+        return valorMin;
+    }
+
+    /**
+     * @brief Imprime las lecturas de la más vieja a la más nueva
+     */
+    void imprimir() const {
+        EscritorInforme salida(salidaRegistro(), 4096);
+        escribir(salida);
+    }
+
+    /**
+     * @brief Escribe la lista en un informe, de la lectura más vieja a la más nueva
+     * @param salida Escritor con buffer (ver EscritorInforme.h)
+     * @param maximo Últimas lecturas a escribir (-1 = todas); las que se
+     *        omiten se resumen al principio como "… +K anteriores"
+     */
+    void escribir(EscritorInforme& salida, int maximo = -1) const {
+        if (tamaño == 0) {
+            salida << "[WARNING] Lista vacía\n";
+            return;
+        }
+
+        int omitidas = (maximo >= 0 && maximo < tamaño) ? tamaño - maximo : 0;
+        salida << "[Lista: ";
+        if (omitidas > 0) {
+            salida << "… +" << omitidas << " anteriores";
+            if (omitidas < tamaño) {
+                salida << " → ";
+            }
+        }
+        for (int i = omitidas; i < tamaño; i++) {
+            salida << datos[indice(i)];
+            if (i + 1 < tamaño) {
+                salida << " → ";
+            }
+        }
+        salida << "]\n";
+    }
+
+    /**
+     * @brief Suma todas las lecturas retenidas desde cero
+     * @return Suma en el acumulador ancho de T (no depende del redondeo
+     *         acumulado por las estadísticas incrementales)
+     */
+    typename AcumuladorDe<T>::tipo sumarTodo() const {
+        int largo1 = primerTramo();
+        return sumarValores(datos + inicio, largo1) + sumarValores(datos, tamaño - largo1);
+    }
+
+    /**
+     * @brief Cuenta las lecturas retenidas estrictamente mayores que un umbral
+     * @param umbral Valor de comparación
+     * @return Cantidad de lecturas sobre el umbral
+     */
+    int contarMayoresQue(T umbral) const {
+        int largo1 = primerTramo();
+        return contarMayores(datos + inicio, largo1, umbral) +
+               contarMayores(datos, tamaño - largo1, umbral);
+    }
+
+    /**
+     * @brief Pone las lecturas de un lote ANTES de las propias
+     * @tparam Lote Historial con recorrerDesde (ej: ListaSensorBloques<T>)
+     * @param anteriores Lecturas más viejas que las propias; queda vacío
+     *
+     * PROCESO: Se reinsertan en orden las anteriores y luego las propias,
+     * con sus marcas, en arreglos nuevos de la misma capacidad y ventana.
+     * Así rigen los mismos límites que al llegar: quedan las últimas
+     * 'capacidad' y ninguna más vieja que la ventana.
+     *
+     * COMPLEJIDAD: O(anteriores + propias).
+     */
+    template <typename Lote>
+    void anteponer(Lote& anteriores) {
+        T* viejos = datos;
+        long long* marcasViejas = marcas;
+        int inicioViejo = inicio;
+        int tamañoViejo = tamaño;
+        int capacidadVieja = capacidad;
+
+        reservar(capacidad, ventanaMs);
+        anteriores.recorrerDesde(LLONG_MIN, [this](long long marca, T valor) {
+            insertarAlFinal(valor, marca);
+        });
+        for (int i = 0; i < tamañoViejo; i++) {
+            int pos = inicioViejo + i;
+            pos = pos >= capacidadVieja ? pos - capacidadVieja : pos;
+            insertarAlFinal(viejos[pos], marcasViejas != nullptr ? marcasViejas[pos] : 0);
+        }
+        delete[] viejos;
+        delete[] marcasViejas;
+
+        Lote vacio;
+        anteriores.intercambiar(vacio);
+    }
+
+    /**
+     * @brief Índice de mínimos: no aplica a este historial
+     *
+     * RAZÓN: Existe para que HistorialCircular pueda usarse en lugar de
+     * ListaSensorBloques. Como el arreglo es acotado y contiguo,
+     * eliminarMinimo recorre a lo sumo 'capacidad' valores.
+     */
+    void activarIndiceMinimo() {}
+
+    /**
+     * @brief Obtiene el número de lecturas retenidas
+     * @return Número de elementos
+     */
+    int obtenerTamaño() const {
+        return tamaño;
+    }
+
+    /**
+     * @brief Obtiene la capacidad máxima configurada
+     * @return Lecturas máximas que se conservan
+     */
+    int obtenerCapacidad() const {
+        return capacidad;
+    }
+
+    /**
+     * @brief Acceso a los agregados incrementales
+     * @return Suma, mínimo, máximo y varianza de las lecturas retenidas
+     */
+    const EstadisticasLista<T>& obtenerEstadisticas() const {
+        return estadisticas;
+    }
+
+    /**
+     * @brief Verifica si el historial está vacío
+     * @return true si no hay lecturas
+     */
+    bool estaVacia() const {
+        return tamaño == 0;
+    }
+};
+
+#endif
@@ -0,0 +1,326 @@
+/**
+ * @file IngestaSerial.h
+ * @brief Camino de una lectura desde el texto recibido hasta el gestor
+ * @details procesarLinea, registrarLectura, las fábricas de sensores y la
+ *          persistencia de --datos. Separado de main.cpp para que bench/
+ *          mida exactamente el mismo código que corre el programa.
+ */
+
+#ifndef INGESTA_SERIAL_H
+#define INGESTA_SERIAL_H
+
+#include "GestorSensores.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "ParserTramas.h"
+#include "AlmacenSegmentos.h"
+#include "BitacoraEscritura.h"
+
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief Visitante que agrega una lectura según el tipo real del sensor
+ * 
+ * RAZÓN: Con GestorSensores::visitarSensor cada operator() recibe la
+ * clase concreta, así agregarLectura se llama sin tabla virtual.
+ *
+ * NOTA: Los dos campos traen el mismo valor (completarValores), porque
+ * el tipo de la línea no tiene por qué ser el del sensor.
+ */
+struct AgregarLectura {
+    double decimal;  ///< Valor si el sensor es de temperatura
+    int entero;      ///< Valor si el sensor es de presión
+
+    template <typename H>
+    void operator()(SensorTemperaturaCon<H>& sensor) const {
+        METRICA_INICIO(inicio);
+        sensor.agregarLectura(decimal);
+        METRICA_FIN(ETAPA_INSERCION, inicio);
+    }
+
+    template <typename H>
+    void operator()(SensorPresionCon<H>& sensor) const {
+        METRICA_INICIO(inicio);
+        sensor.agregarLectura(entero);
+        METRICA_FIN(ETAPA_INSERCION, inicio);
+    }
+
+    void operator()(SensorBase& sensor) const {
+        METRICA_INICIO(inicio);
+        sensor.agregarLectura(decimal);
+        METRICA_FIN(ETAPA_INSERCION, inicio);
+    }
+};
+
+/**
+ * @brief Límite del historial de cada sensor que se crea (--retencion)
+ *
+ * Con lecturas == 0 los sensores guardan todo (ListaSensorBloques).
+ * Con lecturas > 0 se crean SensorTemperaturaAcotado y
+ * SensorPresionAcotado: conservan las últimas 'lecturas' y, si
+ * segundos > 0, ninguna más vieja que esa ventana (HistorialCircular.h).
+ */
+struct RetencionSensores {
+    int lecturas;
+    int segundos;
+};
+
+/**
+ * @brief Retención que usan todas las fábricas de sensores del proceso
+ *
+ * NOTA: Se fija al leer las opciones, antes de que haya hilos de ingesta.
+ */
+inline RetencionSensores& retencionSensores() {
+    static RetencionSensores retencion = {0, 0};
+    return retencion;
+}
+
+/**
+ * @brief Interpreta "LECTURAS[:SEGUNDOS]" (ej: "3600:600")
+ * @return false (sin tocar 'retencion') si LECTURAS no es un entero
+ *         positivo, SEGUNDOS no es un entero entre 0 y INT_MAX, o
+ *         sobra texto
+ */
+inline bool leerRetencion(const char* texto, RetencionSensores& retencion) {
+    char* fin;
+    long lecturas = strtol(texto, &fin, 10);
+    if (fin == texto || lecturas <= 0 || lecturas > INT_MAX) {
+        return false;
+    }
+    long segundos = 0;
+    if (*fin == ':') {
+        const char* inicioSegundos = fin + 1;
+        segundos = strtol(inicioSegundos, &fin, 10);
+        if (fin == inicioSegundos || segundos < 0 || segundos > INT_MAX) {
+            return false;
+        }
+    }
+    if (*fin != '\0') {
+        return false;
+    }
+    retencion.lecturas = static_cast<int>(lecturas);
+    retencion.segundos = static_cast<int>(segundos);
+    return true;
+}
+
+/**
+ * @brief Crea un sensor vacío de un tipo, con la retención configurada
+ * @return Sensor nuevo sin registrar, o nullptr si el tipo es desconocido
+ */
+inline SensorBase* crearSensorDeTipo(char tipo, const char* nombre) {
+    const RetencionSensores& r = retencionSensores();
+    if (tipo == 'T') {
+        if (r.lecturas > 0) {
+            return new SensorTemperaturaAcotado(nombre, r.lecturas, r.segundos);
+        }
+        return new SensorTemperatura(nombre);
+    }
+    if (tipo == 'P') {
+        if (r.lecturas > 0) {
+            return new SensorPresionAcotado(nombre, r.lecturas, r.segundos);
+        }
+        return new SensorPresion(nombre);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Crea el sensor que corresponde al tipo de una línea
+ * @param tipo 'T' (temperatura) o 'P' (presión)
+ * @param nombre ID terminado en '\0'
+ * @return Sensor nuevo sin registrar, o nullptr si el tipo es desconocido
+ */
+inline SensorBase* crearSensorSerial(char tipo, const char* nombre) {
+    SensorBase* sensor = crearSensorDeTipo(tipo, nombre);
+    if (tipo == 'T') {
+        std::cout << "[Serial] Nuevo sensor de temperatura: " << nombre << "\n";
+    } else if (tipo == 'P') {
+        std::cout << "[Serial] Nuevo sensor de presión: " << nombre << "\n";
+    } else {
+        std::cout << "[Error] Tipo de sensor desconocido: " << tipo << "\n";
+    }
+    return sensor;
+}
+
+/**
+ * @brief Registra una lectura ya convertida en el gestor
+ * @param tipo 'T' (temperatura) o 'P' (presión)
+ * @param id Primer carácter del ID (no necesita terminar en '\0')
+ * @param largoId Cantidad de caracteres del ID (máximo LARGO_MAXIMO_ID)
+ * @param decimal Valor de la lectura como double
+ * @param entero Valor de la lectura como int (ver completarValores)
+ * @param gestor Referencia al gestor de sensores
+ * 
+ * PROCESO:
+ * 1. Agregar la lectura con visitarSensor (busca y despacha por tipo)
+ * 2. Si no existe, crearlo (único momento en que se copia el ID)
+ * 3. Agregar la lectura ya convertida al sensor, con su cerrojo tomado
+ * 
+ * Puede llamarse desde varios hilos de ingesta sobre el mismo gestor.
+ */
+inline void registrarLectura(char tipo, const char* id, int largoId, double decimal, int entero,
+                             GestorSensores& gestor) {
+    AgregarLectura agregar = {decimal, entero};
+
+    // Ruta rápida: el sensor ya existe
+    if (gestor.visitarSensor(id, largoId, agregar)) {
+        METRICA_CONTAR(CONTADOR_LECTURAS, 1);
+        return;
+    }
+
+    // El ID solo se copia (con su '\0') al crear el sensor
+    char nombre[LARGO_MAXIMO_ID + 1];
+    memcpy(nombre, id, largoId);
+    nombre[largoId] = '\0';
+
+    // Sensor no existe, crear uno nuevo
+    SensorBase* sensor = crearSensorSerial(tipo, nombre);
+    if (sensor == nullptr) {
+        return;
+    }
+
+    // Si otro hilo registró el mismo ID mientras tanto, se usa el suyo
+    if (gestor.registrarSiFalta(sensor) != sensor) {
+        delete sensor;
+    }
+    
+    // Agregar lectura al sensor (polimorfismo, sin volver a parsear)
+    if (gestor.visitarSensor(id, largoId, agregar)) {
+        METRICA_CONTAR(CONTADOR_LECTURAS, 1);
+    }
+}
+
+/**
+ * @brief Bitácora y segmentos de --datos, alimentados siempre juntos
+ *
+ * RAZÓN: Los dos tienen que ver los mismos lotes, en el mismo orden y
+ * con la misma marca; si no, la recuperación no sabría qué lecturas de
+ * la bitácora ya estaban en los segmentos.
+ */
+struct Persistencia {
+    BitacoraEscritura bitacora;
+    AlmacenSegmentos almacen;
+
+    bool activa() const {
+        return almacen.activo();
+    }
+
+    /**
+     * @brief Anota un lote en la bitácora y luego en los segmentos
+     *
+     * NOTA: Cuando la bitácora junta varios segmentos, los segmentos se
+     * fuerzan al disco y la bitácora se recorta (punto de control).
+     */
+    void guardar(const LecturaParseada* lecturas, int n) {
+        if (!activa() || n <= 0) {
+            return;
+        }
+        long long marca = bitacora.anotarLote(lecturas, n);
+        almacen.anotarLote(lecturas, n, marca);
+        if (bitacora.pidePuntoDeControl()) {
+            puntoDeControl();
+        }
+    }
+
+    void puntoDeControl() {
+        AlmacenSegmentos& a = almacen;
+        bitacora.puntoDeControl([&a]() { a.sincronizar(true); });
+    }
+};
+
+/**
+ * @brief Procesa una línea recibida del ESP32
+ * @param linea Texto con formato "TIPO,ID,VALOR" (no se modifica)
+ * @param largo Cantidad de caracteres de la línea
+ * @param gestor Referencia al gestor de sensores
+ * @param persistencia Donde se guarda la lectura si se usó --datos
+ * 
+ * FORMATO DE LÍNEA:
+ * "T,T-001,23.5"  -> Temperatura, ID=T-001, Valor=23.5
+ * "P,P-105,1013"  -> Presión, ID=P-105, Valor=1013
+ * 
+ * PROCESO DE PARSING:
+ * 1. Separar los tres campos con parsearTrama (rebanadas, sin copias)
+ * 2. Convertir el valor según el tipo (decimal para T, entero para P)
+ *    y completar el otro campo, por si el sensor es del otro tipo
+ * 3. Registrar la lectura con el ID como rebanada del buffer
+ * 
+ * RAZÓN de no usar strtok + atof:
+ * strtok no es reentrante y escribe en el buffer; además el valor
+ * se convertía a texto y de vuelta en cada sensor.
+ */
+inline void procesarLinea(const char* linea, int largo, GestorSensores& gestor, Persistencia& persistencia) {
+    TramaLectura trama;
+    double decimal = 0.0;
+    int entero = 0;
+
+    // Dividir la línea y convertir el valor según el tipo
+    METRICA_CONTAR(CONTADOR_LINEAS, 1);
+    METRICA_INICIO(inicioParseo);
+    bool valido = parsearTrama(linea, largo, trama);
+    if (valido) {
+        if (trama.tipo == 'T') {
+            valido = convertirDecimal(trama.valor, decimal);
+        } else if (trama.tipo == 'P') {
+            valido = convertirEntero(trama.valor, entero);
+        }
+    }
+    METRICA_FIN(ETAPA_PARSEO, inicioParseo);
+    
+    if (!valido) {
+        METRICA_CONTAR(CONTADOR_MALFORMADAS, 1);
+        std::cout << "[Advertencia] Línea malformada recibida.\n";
+        return;
+    }
+    completarValores(trama.tipo, decimal, entero);
+    
+    registrarLectura(trama.tipo, trama.id.inicio, trama.id.largo, decimal, entero, gestor);
+
+    // Solo al persistir se copia el ID a una LecturaParseada
+    if (persistencia.activa()) {
+        LecturaParseada lectura;
+        lectura.tipo = trama.tipo;
+        copiarIdLectura(lectura, trama.id.inicio, trama.id.largo);
+        lectura.decimal = decimal;
+        lectura.entero = entero;
+        persistencia.guardar(&lectura, 1);
+    }
+}
+
+/**
+ * @brief Fábrica de sensores para GestorSensores::agregarLecturas
+ */
+inline SensorBase* crearSensorDeLectura(const LecturaParseada& lectura) {
+    return crearSensorSerial(lectura.tipo, lectura.id);
+}
+
+/**
+ * @brief Fábrica de AlmacenSegmentos::restaurar (sin mensaje de sensor nuevo)
+ */
+inline SensorBase* crearSensorRestaurado(char tipo, const char* nombre) {
+    return crearSensorDeTipo(tipo, nombre);
+}
+
+/**
+ * @brief Reproductor de BitacoraEscritura::abrir
+ *
+ * PROCESO: Para cada lote recuperado, separar lo que los segmentos ya
+ * tenían (se guardó antes de la caída) y pasar el resto al gestor y a
+ * los segmentos, con la marca original.
+ */
+struct ReproducirEnGestor {
+    GestorSensores& gestor;
+    AlmacenSegmentos& almacen;
+    LecturaParseada* nuevas;  ///< BitacoraEscritura::LECTURAS_POR_REGISTRO lugares
+
+    void operator()(const LecturaParseada* lecturas, int n, long long marca) {
+        int k = almacen.descartarGuardadas(lecturas, n, marca, nuevas);
+        gestor.agregarLecturas(nuevas, k, crearSensorDeLectura);
+        almacen.anotarLote(nuevas, k, marca);
+    }
+};
+
+#endif
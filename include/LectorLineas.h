@@ -0,0 +1,156 @@
+/**
+ * @file LectorLineas.h
+ * @brief Lector de líneas con buffer para el puerto serial
+ * @details Lee bloques grandes del descriptor con una sola llamada a read()
+ *          y separa todas las líneas completas que llegaron, en lugar de
+ *          pedir los datos byte por byte.
+ */
+
+#ifndef LECTOR_LINEAS_H
+#define LECTOR_LINEAS_H
+
+#include "Metricas.h"
+
+#include <cstring>
+#include <unistd.h>
+
+/**
+ * @class LectorLineas
+ * @brief Acumula bytes de un descriptor y entrega líneas terminadas en '\n' o '\r'
+ *
+ * CONCEPTO - Lectura por bloques:
+ * Cada read() es una llamada al sistema (costosa). Pedir 1 byte por
+ * llamada desperdicia casi todo el tiempo en el cambio de contexto.
+ * Aquí pedimos todo lo que quepa en el buffer y luego partimos las
+ * líneas en memoria.
+ *
+ * USO:
+ *   LectorLineas lector(fd);
+ *   if (lector.llenar() > 0) {
+ *       char* linea;
+ *       while (lector.siguienteLinea(linea)) { ... }
+ *   }
+ *
+ * NOTA: La línea entregada apunta dentro del buffer interno y es
+ * válida hasta la siguiente llamada a llenar().
+ */
+class LectorLineas {
+public:
+    static const int CAPACIDAD = 4096;    ///< Bytes del buffer interno
+    static const int LARGO_MAXIMO = 255;  ///< Largo máximo de una línea válida
+
+private:
+    int fd;                    ///< Descriptor del que se lee
+    char buffer[CAPACIDAD + 1];///< Bytes recibidos (+1 para el '\0' final)
+    int inicio;                ///< Primer byte aún no entregado
+    int fin;                   ///< Un byte después del último recibido
+    int escaneado;             ///< Hasta dónde ya se buscó un fin de línea
+    bool descartando;          ///< true mientras se ignora una línea demasiado larga
+
+    /**
+     * @brief Mueve los bytes pendientes al principio del buffer
+     *
+     * RAZÓN: Así siempre queda espacio contiguo para el siguiente read().
+     */
+    void compactar() {
+        if (inicio == 0) {
+            return;
+        }
+        int pendientes = fin - inicio;
+        memmove(buffer, buffer + inicio, pendientes);
+        escaneado -= inicio;
+        fin = pendientes;
+        inicio = 0;
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param descriptor Descriptor abierto (idealmente en modo no bloqueante)
+     */
+    explicit LectorLineas(int descriptor)
+        : fd(descriptor), inicio(0), fin(0), escaneado(0), descartando(false) {}
+
+    /**
+     * @brief Lee todo lo disponible que quepa en el buffer
+     * @return Bytes leídos; 0 si no había datos o el otro extremo cerró;
+     *         -1 si read() falló
+     */
+    int llenar() {
+        compactar();
+
+        int libre = CAPACIDAD - fin;
+        if (libre == 0) {
+            // Buffer lleno sin fin de línea: la línea es demasiado larga
+            descartando = true;
+            inicio = fin = escaneado = 0;
+            libre = CAPACIDAD;
+        }
+
+        METRICA_INICIO(inicioLectura);
+        ssize_t n = read(fd, buffer + fin, libre);
+        METRICA_FIN(ETAPA_LECTURA, inicioLectura);
+        if (n > 0) {
+            fin += static_cast<int>(n);
+            METRICA_CONTAR(CONTADOR_BYTES_LEIDOS, static_cast<unsigned long long>(n));
+        }
+        return static_cast<int>(n);
+    }
+
+    /**
+     * @brief Entrega la siguiente línea completa del buffer
+     * @param linea Recibe un puntero a la línea, terminada en '\0'
+     * @param largo Recibe la cantidad de caracteres de la línea
+     * @return true si había una línea completa, false si falta recibir más
+     *
+     * PROCESO:
+     * 1. Buscar '\n' o '\r' desde donde se quedó la búsqueda anterior
+     * 2. Reemplazarlo por '\0' y entregar la línea
+     * 3. Las líneas vacías (por ejemplo "\r\n") se saltan
+     * 4. Las líneas de más de LARGO_MAXIMO bytes se descartan completas
+     */
+    bool siguienteLinea(char*& linea, int& largo) {
+        while (escaneado < fin) {
+            char c = buffer[escaneado];
+            if (c != '\n' && c != '\r') {
+                escaneado++;
+                continue;
+            }
+
+            buffer[escaneado] = '\0';
+            char* candidata = buffer + inicio;
+            int largoCandidata = escaneado - inicio;
+            bool descartar = descartando || largoCandidata > LARGO_MAXIMO;
+
+            escaneado++;
+            inicio = escaneado;
+            descartando = false;
+
+            if (largoCandidata > 0 && !descartar) {
+                linea = candidata;
+                largo = largoCandidata;
+                return true;
+            }
+            if (descartar) {
+                METRICA_CONTAR(CONTADOR_DESCARTADAS, 1);
+            }
+        }
+
+        // Sin fin de línea: si lo pendiente ya es demasiado largo, se descarta
+        if (fin - inicio > LARGO_MAXIMO) {
+            descartando = true;
+            inicio = escaneado = fin;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Igual que siguienteLinea(linea, largo), sin devolver el largo
+     */
+    bool siguienteLinea(char*& linea) {
+        int largo;
+        return siguienteLinea(linea, largo);
+    }
+};
+
+#endif
@@ -2,14 +2,28 @@
  * @file ListaSensor.h
  * @brief Implementación de la Lista Enlazada Simple Genérica para sensores IoT
  * @details Esta clase maneja la memoria dinámicamente usando punteros.
- *          Implementa la Regla de los Tres para evitar fugas de memoria.
+ *          Implementa la Regla de los Cinco: copia profunda para evitar
+ *          fugas y dobles liberaciones, y movimiento para entregar los
+ *          nodos sin copiarlos.
  */
 
 
 #ifndef LISTA_SENSOR_H
 #define LISTA_SENSOR_H
 
-#include <iostream>
+#include "Registro.h"
+#include "PoolNodos.h"
+#include "EstadisticasLista.h"
+#include "EscritorInforme.h"
+#include <utility>
+
+/**
+ * @brief Marca para construir el dato de un nodo en su lugar
+ *
+ * USO: asignador.crear(EnSitio(), args...) construye el T del nodo
+ * directamente con 'args', sin un T temporal que luego se copie.
+ */
+struct EnSitio {};
 
 /**
  * @brief Nodo genérico para la lista enlazada
@@ -33,24 +47,104 @@ struct Nodo {
      * aun no se sabe cual sera el nodo siguiente
      */
 
-    Nodo(T valor) : dato(valor), siguiente(nullptr) {}
+    explicit Nodo(const T& valor) : dato(valor), siguiente(nullptr) {}
+
+    /**
+     * @brief Constructor que mueve el dato en lugar de copiarlo
+     * @param valor Dato temporal a almacenar
+     */
+    explicit Nodo(T&& valor) : dato(std::move(valor)), siguiente(nullptr) {}
+
+    /**
+     * @brief Constructor que arma el dato con los argumentos de su constructor
+     * @param args Argumentos para T(args...)
+     */
+    template <typename... Args>
+    Nodo(EnSitio, Args&&... args) : dato(std::forward<Args>(args)...), siguiente(nullptr) {}
 };
 
 /**
  * @brief Lista Enlazada Simple Genérica
  * @tparam T Tipo de dato que almacenará la lista
+ * @tparam Asignador Política que crea y libera los nodos
+ *         (por defecto un PoolNodos por bloques)
  * 
  * Ejemplo: En los vagones de tren:
  * - 'cabeza' es el primer vagón
  * - Cada vagón sabe cuál es el siguiente
  * - El último vagón apunta a nullptr (fin de la lista)
+ * 
+ * RAZÓN del Asignador:
+ * Con el pool los nodos se reparten desde bloques contiguos,
+ * en vez de un 'new' suelto por lectura.
+ * Para volver al comportamiento clásico: ListaSensor<T, AsignadorHeap<Nodo<T> > >
+ *
+ * REQUISITOS del Asignador: crear(args...), liberar(nodo), ser movible
+ * y absorber(otro), que empalmarAlFinal usa para adoptar nodos ajenos.
  */
 
-template <typename T>
+template <typename T, typename Asignador = PoolNodos<Nodo<T> > >
 class ListaSensor {
 private:
-    Nodo<T>* cabeza;  ///< Puntero al primer nodo de la lista
-    int tamaño;       ///< Contador de elementos en la lista
+    Nodo<T>* cabeza;      ///< Puntero al primer nodo de la lista
+    Nodo<T>* cola;        ///< Puntero al último nodo (inserción O(1))
+    int tamaño;           ///< Contador de elementos en la lista
+    Asignador asignador;  ///< Crea y libera los nodos de esta lista
+
+    /**
+     * @brief Agregados mantenidos en cada inserción y eliminación
+     * 
+     * RAZÓN: calcularPromedio se consulta en cada pase de procesarTodos;
+     * así responde en O(1) en lugar de recorrer toda la lista.
+     */
+    EstadisticasLista<T> estadisticas;
+
+    /**
+     * @brief Engancha un nodo ya creado después de la cola
+     * @param nuevoNodo Nodo recién pedido al asignador
+     *
+     * PROCESO:
+     * Caso 1: Lista vacía (cabeza == nullptr)
+     *   - El nuevo nodo se convierte en la cabeza y en la cola
+     * 
+     * Caso 2: Lista con elementos
+     *   - Enganchamos el nuevo nodo después de la cola
+     *   - El nuevo nodo pasa a ser la cola
+     * 
+     * RAZÓN de guardar 'cola':
+     * Sin ella habría que recorrer toda la lista en cada inserción,
+     * lo que hace que ingresar N lecturas cueste O(N²).
+     * Con 'cola' cada inserción es O(1) sin importar el tamaño.
+     */
+    void engancharAlFinal(Nodo<T>* nuevoNodo) {
+        // Verificamos si la lista esta vacía
+        if (cabeza == nullptr) {
+            cabeza = nuevoNodo;
+            REGISTRO_DETALLE("[LOG] Primer nodo insertado: " << nuevoNodo->dato);
+        } else {  
+            // Enganchamos al nuevo nodo después del último
+            cola->siguiente = nuevoNodo;
+            REGISTRO_DETALLE("[LOG] Nodo insertado al final: " << nuevoNodo->dato);
+        }
+
+        cola = nuevoNodo;
+        tamaño++;
+        estadisticas.agregar(nuevoNodo->dato);
+    }
+
+    /**
+     * @brief Libera todos los nodos y deja la lista vacía
+     */
+    void vaciar() {
+        while (cabeza != nullptr) {
+            Nodo<T>* temp = cabeza;
+            cabeza = cabeza->siguiente;
+            asignador.liberar(temp);
+        }
+        cola = nullptr;
+        tamaño = 0;
+        estadisticas.reiniciar();
+    }
 
 public: 
     /**
@@ -59,15 +153,15 @@ public:
      * CONCEPTO: Inicializamos la lista vacía.
      * cabeza = nullptr significa "no hay ningún nodo todavía"
      */
-    ListaSensor() : cabeza(nullptr), tamaño(0) {
-        std::cout << "[LOG] Lista genérica creada" << std::endl;
+    ListaSensor() : cabeza(nullptr), cola(nullptr), tamaño(0) {
+        REGISTRO_DETALLE("[LOG] Lista genérica creada");
     }
 
     /**
      * @brief Destructor
      * 
      * RAZÓN: Cuando la lista se destruye, debemos liberar TODOS
-     * los nodos que creamos con 'new'. Si no lo hacemos, la memoria
+     * los nodos que creamos con el asignador. Si no lo hacemos, la memoria
      * queda ocupada y hay fuga de memoria.
      * 
      * PROCESO:
@@ -83,13 +177,13 @@ public:
         while (actual != nullptr) {
             // Guardamos el siguiente
             Nodo<T>* siguiente = actual->siguiente;  
-            std::cout << "\t[LOG] Nodo<T> " << actual->dato << " liberado" << std::endl;
+            REGISTRO_DETALLE("\t[LOG] Nodo<T> " << actual->dato << " liberado");
             // Liberamos memoria
-            delete actual;  
+            asignador.liberar(actual);  
             // Avanzamos
             actual = siguiente;  
         }
-        std::cout << "\t[LOG] Lista genérica destruida" << std::endl;
+        REGISTRO_DETALLE("\t[LOG] Lista genérica destruida");
     }
 
     /**
@@ -104,7 +198,7 @@ public:
      * lo cual causará error
      */
     
-    ListaSensor(const ListaSensor& otra) : cabeza(nullptr), tamaño(0) {
+    ListaSensor(const ListaSensor& otra) : cabeza(nullptr), cola(nullptr), tamaño(0) {
         Nodo<T>* actual = otra.cabeza;
         while (actual != nullptr) {
             // Copiamos cada dato
@@ -127,12 +221,7 @@ public:
         // Verificamos que no haya una autoinsección
         if (this != &otra) {  
             // Limpiar lista actual
-            while (cabeza != nullptr) {
-                Nodo<T>* temp = cabeza;
-                cabeza = cabeza->siguiente;
-                delete temp;
-            }
-            tamaño = 0;
+            vaciar();
             
             // Copiar nueva lista
             Nodo<T>* actual = otra.cabeza;
@@ -144,41 +233,150 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Constructor de movimiento
+     * @param otra Lista que entrega sus nodos y queda vacía
+     *
+     * RAZÓN: Devolver o entregar un historial (por ejemplo, de un buffer
+     * de ingreso a un sensor) no necesita copiar nodos: basta con pasar
+     * cabeza, cola y el asignador que es dueño de su memoria. O(1).
+     */
+    ListaSensor(ListaSensor&& otra) noexcept
+        : cabeza(otra.cabeza), cola(otra.cola), tamaño(otra.tamaño),
+          asignador(std::move(otra.asignador)), estadisticas(otra.estadisticas) {
+        otra.cabeza = nullptr;
+        otra.cola = nullptr;
+        otra.tamaño = 0;
+        otra.estadisticas.reiniciar();
+    }
+
+    /**
+     * @brief Asignación por movimiento
+     * @param otra Lista que entrega sus nodos
+     * @return Referencia a esta lista
+     *
+     * NOTA: Los nodos que teníamos se liberan antes; 'otra' queda vacía.
+     */
+    ListaSensor& operator=(ListaSensor&& otra) noexcept {
+        if (this != &otra) {
+            vaciar();
+            intercambiar(otra);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Intercambia el contenido con otra lista en O(1)
+     * @param otra Lista con la que se intercambia
+     */
+    void intercambiar(ListaSensor& otra) noexcept {
+        std::swap(cabeza, otra.cabeza);
+        std::swap(cola, otra.cola);
+        std::swap(tamaño, otra.tamaño);
+        std::swap(asignador, otra.asignador);
+        std::swap(estadisticas, otra.estadisticas);
+    }
+
+    /**
+     * @brief Versión libre para std::swap y algoritmos de la biblioteca
+     */
+    friend void swap(ListaSensor& a, ListaSensor& b) noexcept {
+        a.intercambiar(b);
+    }
+
     /**
      * @brief Inserta un elemento al final de la lista
+     * @param valor Dato a insertar (se copia una sola vez, en el nodo)
+     */
+    void insertarAlFinal(const T& valor) {
+        engancharAlFinal(asignador.crear(valor));
+    }
+
+    /**
+     * @brief Inserta un elemento temporal al final, moviéndolo al nodo
      * @param valor Dato a insertar
-     * 
-     * PROCESO:
-     * Caso 1: Lista vacía (cabeza == nullptr)
-     *   - El nuevo nodo se convierte en la cabeza
-     * 
-     * Caso 2: Lista con elementos
-     *   - Recorremos hasta el último nodo
-     *   - Enganchamos el nuevo nodo al final
      */
-    void insertarAlFinal(T valor) {
-        // Creamos un nodo en memoria dinámica
-        Nodo<T>* nuevoNodo = new Nodo<T>(valor);
-        
-        // Verificamos si la lista esta vacía
+    void insertarAlFinal(T&& valor) {
+        engancharAlFinal(asignador.crear(std::move(valor)));
+    }
+
+    /**
+     * @brief Construye un elemento directamente en un nodo nuevo al final
+     * @param args Argumentos para el constructor de T
+     *
+     * USO: lista.emplazarAlFinal(args...) equivale a
+     * insertarAlFinal(T(args...)) sin el T intermedio.
+     */
+    template <typename... Args>
+    void emplazarAlFinal(Args&&... args) {
+        engancharAlFinal(asignador.crear(EnSitio(), std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Inserta un lote de valores al final
+     * @tparam U Tipo de origen (ej: double del parser); se convierte a T
+     * @param valores Primer valor del lote
+     * @param cantidad Valores del lote
+     *
+     * RAZÓN: Los nodos se encadenan entre sí y la cola se actualiza una
+     * sola vez; con el pool, las casillas salen seguidas del mismo bloque.
+     */
+    template <typename U>
+    void insertarVarios(const U* valores, int cantidad) {
+        if (cantidad <= 0) {
+            return;
+        }
+
+        Nodo<T>* primero = asignador.crear(static_cast<T>(valores[0]));
+        Nodo<T>* ultimo = primero;
+        estadisticas.agregar(primero->dato);
+        for (int i = 1; i < cantidad; i++) {
+            ultimo->siguiente = asignador.crear(static_cast<T>(valores[i]));
+            ultimo = ultimo->siguiente;
+            estadisticas.agregar(ultimo->dato);
+        }
+
         if (cabeza == nullptr) {
-            cabeza = nuevoNodo;
-            std::cout << "[LOG] Primer nodo insertado: " << valor << std::endl;
-        } else {  
-            // Lista con elementos
-            Nodo<T>* actual = cabeza;
-            
-            // Avanzar hasta el último nodo
-            while (actual->siguiente != nullptr) {
-                actual = actual->siguiente;
-            }
+            cabeza = primero;
+        } else {
+            cola->siguiente = primero;
+        }
+        cola = ultimo;
+        tamaño += cantidad;
+        REGISTRO_DETALLE("[LOG] " << cantidad << " nodo(s) insertados al final");
+    }
 
-            // Enganchamos al nuevo nodo
-            actual->siguiente = nuevoNodo;
-            std::cout << "[LOG] Nodo insertado al final: " << valor << std::endl;
+    /**
+     * @brief Mueve todos los nodos de otra lista al final de esta
+     * @param otra Lista que queda vacía
+     *
+     * PROCESO:
+     * 1. El asignador adopta la memoria de los nodos de 'otra'
+     * 2. La cola apunta a la cabeza de 'otra' (un solo enlace)
+     * 3. Las estadísticas se combinan sin recorrer los valores
+     *
+     * COMPLEJIDAD: O(1) en los nodos; con PoolNodos ver PoolNodos::absorber.
+     */
+    void empalmarAlFinal(ListaSensor& otra) {
+        if (this == &otra || otra.cabeza == nullptr) {
+            return;
         }
 
-        tamaño++;
+        asignador.absorber(otra.asignador);
+        if (cabeza == nullptr) {
+            cabeza = otra.cabeza;
+        } else {
+            cola->siguiente = otra.cabeza;
+        }
+        cola = otra.cola;
+        tamaño += otra.tamaño;
+        estadisticas.combinar(otra.estadisticas);
+        REGISTRO_DETALLE("[LOG] " << otra.tamaño << " nodo(s) empalmados al final");
+
+        otra.cabeza = nullptr;
+        otra.cola = nullptr;
+        otra.tamaño = 0;
+        otra.estadisticas.reiniciar();
     }
 
     /**
@@ -187,26 +385,20 @@ public:
      * 
      * RAZÓN: Necesitamos procesar los datos, que pueden ser int o float.
      * Esta es una operación común en sensores: obtener el valor promedio de las lecturas.
+     * 
+     * COMPLEJIDAD: O(1). La suma se mantiene en un acumulador más ancho
+     * que T (long long o double), así que no se desborda con historiales largos.
      */
     
     T calcularPromedio() const {
 
         // Mandamos una advertencia si la lista esta vacía
         if (cabeza == nullptr) {
-            std::cout << "[ADVERTENCIA] Lista vacía, retornando 0." << std::endl;
+            REGISTRO_ADVERTENCIA("[ADVERTENCIA] Lista vacía, retornando 0.");
             return static_cast<T>(0);
         }
         
-        T suma = 0;
-        Nodo<T>* actual = cabeza;
-        
-        // Sumar todos los valores
-        while (actual != nullptr) {
-            suma += actual->dato;
-            actual = actual->siguiente;
-        }
-        
-        return suma / tamaño;
+        return estadisticas.promedio();
     }
 
     /**
@@ -218,13 +410,16 @@ public:
      * 2. Guardar referencia al nodo anterior
      * 3. Reenlazar: anterior->siguiente = minimo->siguiente
      * 4. Liberar el nodo del mínimo
+     * 
+     * En el mismo recorrido guardamos el segundo valor más bajo,
+     * que será el nuevo mínimo de las estadísticas.
      */
 
     T eliminarMinimo() {
 
         // Avisamos de error si no hay dato
         if (cabeza == nullptr) {
-            std::cout << "[ERRROR] No hay elementos para eliminar." << std::endl;
+            REGISTRO_ERROR("[ERRROR] No hay elementos para eliminar.");
             return static_cast<T>(0);
         }
         
@@ -233,12 +428,20 @@ public:
         Nodo<T>* anterior = nullptr;
         Nodo<T>* anteriorMin = nullptr;
         Nodo<T>* actual = cabeza;
+        T segundo = cabeza->dato;
+        bool haySegundo = false;
         
         // Recorremos para encontrar el valor mìnimo
         while (actual != nullptr) {
             if (actual->dato < minNodo->dato) {
+                // El mínimo anterior pasa a ser el segundo más bajo
+                segundo = minNodo->dato;
+                haySegundo = true;
                 minNodo = actual;
                 anteriorMin = anterior;
+            } else if (actual != minNodo && (!haySegundo || actual->dato < segundo)) {
+                segundo = actual->dato;
+                haySegundo = true;
             }
             anterior = actual;
             actual = actual->siguiente;
@@ -252,11 +455,22 @@ public:
         } else {
             anteriorMin->siguiente = minNodo->siguiente;
         }
+
+        // Si el mínimo era el último, la cola retrocede al anterior
+        if (minNodo == cola) {
+            cola = anteriorMin;
+        }
         
-        delete minNodo;
+        asignador.liberar(minNodo);
         tamaño--;
+
+        // El máximo solo podría cambiar si todos eran iguales, y entonces sigue igual
+        estadisticas.quitar(valorMin);
+        if (haySegundo) {
+            estadisticas.fijarExtremos(segundo, estadisticas.obtenerMaximo());
+        }
         
-        std::cout << "[LOG] Valor mínimo eliminado: " << valorMin << std::endl;
+        REGISTRO_DETALLE("[LOG] Valor mínimo eliminado: " << valorMin);
         return valorMin;
     }
 
@@ -266,23 +480,74 @@ public:
      * RAZÓN: Para depuración y verificación visual de los datos
      */
     void imprimir() const {
+        EscritorInforme salida(salidaRegistro(), 4096);
+        escribir(salida);
+    }
+
+    /**
+     * @brief Escribe la lista en un informe, de la lectura más vieja a la más nueva
+     * @param salida Escritor con buffer (ver EscritorInforme.h)
+     * @param maximo Últimas lecturas a escribir (-1 = todas); las que se
+     *        omiten se resumen al principio como "… +K anteriores"
+     */
+    void escribir(EscritorInforme& salida, int maximo = -1) const {
 
         // Avisamos si la lista esta vacía
         if (cabeza == nullptr) {
-            std::cout << "[WARNING] Lista vacía\n";
+            salida << "[WARNING] Lista vacía\n";
             return;
         }
-        
+
+        int omitidas = (maximo >= 0 && maximo < tamaño) ? tamaño - maximo : 0;
+        salida << "[Lista: ";
+        if (omitidas > 0) {
+            salida << "… +" << omitidas << " anteriores";
+            if (omitidas < tamaño) {
+                salida << " → ";
+            }
+        }
         Nodo<T>* actual = cabeza;
-        std::cout << "[Lista: ";
+        for (int i = 0; i < omitidas; i++) {
+            actual = actual->siguiente;
+        }
         while (actual != nullptr) {
-            std::cout << actual->dato;
+            salida << actual->dato;
             if (actual->siguiente != nullptr) {
-                std::cout << " → ";
+                salida << " → ";
             }
             actual = actual->siguiente;
         }
-        std::cout << "]" << std::endl;
+        salida << "]\n";
+    }
+
+    /**
+     * @brief Suma todos los valores recorriendo la lista desde cero
+     * @return Suma en el acumulador ancho de T
+     *
+     * NOTA: Los nodos no son contiguos, así que aquí no hay versión
+     * vectorizada; ver ListaSensorBloques::sumarTodo.
+     */
+    typename AcumuladorDe<T>::tipo sumarTodo() const {
+        typename AcumuladorDe<T>::tipo suma = 0;
+        for (Nodo<T>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            suma += actual->dato;
+        }
+        return suma;
+    }
+
+    /**
+     * @brief Cuenta los valores estrictamente mayores que un umbral
+     * @param umbral Valor de comparación
+     * @return Cantidad de valores sobre el umbral
+     */
+    int contarMayoresQue(T umbral) const {
+        int cuenta = 0;
+        for (Nodo<T>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            if (umbral < actual->dato) {
+                cuenta++;
+            }
+        }
+        return cuenta;
     }
 
     /**
@@ -293,6 +558,14 @@ public:
         return tamaño;
     }
     
+    /**
+     * @brief Acceso a los agregados incrementales
+     * @return Suma, mínimo, máximo y varianza sin recorrer la lista
+     */
+    const EstadisticasLista<T>& obtenerEstadisticas() const {
+        return estadisticas;
+    }
+
     /**
      * @brief Verifica si la lista está vacía
      * @return true si está vacía, false en caso contrario
@@ -0,0 +1,703 @@
+/**
+ * @file ListaSensorBloques.h
+ * @brief Lista enlazada "desenrollada" (por bloques) para historiales de sensores
+ * @details Alternativa a ListaSensor con la misma interfaz, pero cada nodo
+ *          guarda hasta N valores contiguos. Los recorridos de
+ *          calcularPromedio y eliminarMinimo avanzan por arreglos en lugar
+ *          de saltar de puntero en puntero.
+ */
+
+#ifndef LISTA_SENSOR_BLOQUES_H
+#define LISTA_SENSOR_BLOQUES_H
+
+#include "Registro.h"
+#include "PoolNodos.h"
+#include "EstadisticasLista.h"
+#include "MonticuloBloques.h"
+#include "NucleosSimd.h"
+#include "VentanasTiempo.h"
+#include "EscritorInforme.h"
+#include <utility>
+
+/**
+ * @brief Nodo de la lista por bloques
+ * @tparam T Tipo de dato almacenado
+ * @tparam N Capacidad de valores por nodo
+ *
+ * CONCEPTO: En vez de una caja por valor, cada caja es una
+ * repisa con N lugares. Solo cuando la repisa se llena se
+ * engancha una nueva.
+ *
+ * MARCAS DE TIEMPO (codificación delta):
+ * El bloque guarda la marca completa de su primera lectura y, por
+ * cada valor, solo los milisegundos transcurridos desde ella en 32
+ * bits: 4 bytes por lectura en lugar de 8, con margen de ~49 días
+ * por bloque.
+ */
+template <typename T, int N>
+struct NodoBloque {
+    T datos[N];                  ///< Valores en orden de inserción
+    unsigned int deltas[N];      ///< ms desde 'marcaBase' de cada valor
+    long long marcaBase;         ///< Marca monotónica (ms) de referencia del bloque
+    int usados;                  ///< Cuántas posiciones de 'datos' están ocupadas
+    NodoBloque<T, N>* siguiente; ///< Puntero al siguiente bloque
+    NodoBloque<T, N>* anterior;  ///< Puntero al bloque previo (desenganche O(1))
+    int posMin;                  ///< Posición del primer mínimo dentro de 'datos'
+    int posMonticulo;            ///< Posición en el índice de mínimos
+    unsigned long orden;         ///< Número de creación, para desempatar mínimos
+
+    /**
+     * @brief Constructor: bloque vacío sin vecinos
+     */
+    NodoBloque()
+        : marcaBase(0), usados(0), siguiente(nullptr), anterior(nullptr),
+          posMin(0), posMonticulo(-1), orden(0) {}
+};
+
+/**
+ * @brief Lista enlazada por bloques con la interfaz de ListaSensor
+ * @tparam T Tipo de dato que almacenará la lista
+ * @tparam N Valores por bloque (por defecto 64)
+ * @tparam Asignador Política que crea y libera los bloques
+ *
+ * RAZÓN del asignador por defecto (AsignadorHeap):
+ * Cada bloque ya es un arreglo contiguo grande, así que un 'new'
+ * por bloque se amortiza entre N lecturas.
+ *
+ * INVARIANTE: Ningún bloque enlazado está vacío; así 'cabeza'
+ * es nullptr si y solo si la lista no tiene valores.
+ *
+ * MARCAS: Cada lectura guarda cuándo llegó (ver NodoBloque). Las
+ * inserciones sin marca usan relojMonotonicoMs().
+ *
+ * ÍNDICE DE MÍNIMOS (opcional, ver activarIndiceMinimo):
+ * Un montículo de bloques ordenado por el mínimo de cada uno.
+ * eliminarMinimo pasa de recorrer toda la lista a O(log B + N),
+ * con B bloques, sin alterar el orden de inserción de imprimir.
+ */
+template <typename T, int N = 64, typename Asignador = AsignadorHeap<NodoBloque<T, N> > >
+class ListaSensorBloques {
+private:
+    NodoBloque<T, N>* cabeza;  ///< Primer bloque de la lista
+    NodoBloque<T, N>* cola;    ///< Último bloque (inserción O(1))
+    int tamaño;                ///< Total de valores en la lista
+    Asignador asignador;       ///< Crea y libera los bloques
+    EstadisticasLista<T> estadisticas;  ///< Agregados incrementales (promedio O(1))
+
+    MonticuloBloques<NodoBloque<T, N> > indiceMinimo;  ///< Bloques ordenados por su mínimo
+    bool usarIndice;                ///< true si indiceMinimo se mantiene al día
+    unsigned long siguienteOrden;   ///< Contador para NodoBloque::orden
+
+    /**
+     * @brief Recalcula la posición del primer mínimo de un bloque
+     * @param b Bloque con al menos un valor
+     *
+     * NOTA: Para float e int se usa el recorrido vectorizado (NucleosSimd.h).
+     */
+    static void recalcularMinimo(NodoBloque<T, N>* b) {
+        b->posMin = posicionMinimo(b->datos, b->usados);
+    }
+
+    /**
+     * @brief Busca el bloque con el primer mínimo global
+     * @return Bloque más antiguo entre los de menor mínimo
+     *
+     * RAZÓN: Cada bloque ya conoce su mínimo (posMin), así que basta
+     * comparar un valor por bloque en lugar de todos los valores.
+     */
+    NodoBloque<T, N>* bloqueConMinimo() const {
+        NodoBloque<T, N>* mejor = cabeza;
+        NodoBloque<T, N>* actual = cabeza->siguiente;
+        while (actual != nullptr) {
+            if (actual->datos[actual->posMin] < mejor->datos[mejor->posMin]) {
+                mejor = actual;
+            }
+            actual = actual->siguiente;
+        }
+        return mejor;
+    }
+
+    /**
+     * @brief Indica si una marca entra en la cola sin bloque nuevo
+     * @param marcaMs Marca de la lectura a insertar
+     *
+     * RAZÓN: El delta es de 32 bits; la cola debe tener lugar y la
+     * marca no puede alejarse más de ~49 días de su base.
+     */
+    bool colaAdmite(long long marcaMs) const {
+        return cola != nullptr && cola->usados < N
+            && marcaMs - cola->marcaBase <= 0xFFFFFFFFLL;
+    }
+
+    /**
+     * @brief Delta de una marca respecto de la base de un bloque
+     *
+     * NOTA: Una marca anterior a la base (solo posible con marcas
+     * explícitas desordenadas) se guarda como la base misma.
+     */
+    static unsigned int deltaDe(const NodoBloque<T, N>* b, long long marcaMs) {
+        return marcaMs > b->marcaBase ? static_cast<unsigned int>(marcaMs - b->marcaBase) : 0u;
+    }
+
+    /**
+     * @brief Pide un bloque vacío y lo engancha después de la cola
+     * @param marcaBase Marca de la primera lectura que recibirá
+     *
+     * NOTA: El bloque queda vacío hasta que quien llama le escribe
+     * al menos un valor (invariante de bloques no vacíos).
+     */
+    void engancharBloque(long long marcaBase) {
+        NodoBloque<T, N>* nuevo = asignador.crear();
+        nuevo->marcaBase = marcaBase;
+        nuevo->orden = siguienteOrden++;
+        nuevo->anterior = cola;
+        if (cola == nullptr) {
+            cabeza = nuevo;
+        } else {
+            cola->siguiente = nuevo;
+        }
+        cola = nuevo;
+    }
+
+    /**
+     * @brief Desengancha un bloque de la lista y lo libera
+     * @param b Bloque a quitar
+     */
+    void liberarBloque(NodoBloque<T, N>* b) {
+        if (b->anterior == nullptr) {
+            cabeza = b->siguiente;
+        } else {
+            b->anterior->siguiente = b->siguiente;
+        }
+        if (b->siguiente == nullptr) {
+            cola = b->anterior;
+        } else {
+            b->siguiente->anterior = b->anterior;
+        }
+        asignador.liberar(b);
+    }
+
+    /**
+     * @brief Libera todos los bloques y deja la lista vacía
+     */
+    void vaciar() {
+        while (cabeza != nullptr) {
+            NodoBloque<T, N>* siguiente = cabeza->siguiente;
+            asignador.liberar(cabeza);
+            cabeza = siguiente;
+        }
+        cola = nullptr;
+        tamaño = 0;
+        estadisticas.reiniciar();
+        indiceMinimo.vaciar();
+    }
+
+    /**
+     * @brief Copia todos los valores de otra lista al final de esta
+     * @param otra Lista origen
+     *
+     * NOTA: Las lecturas copiadas conservan su marca original.
+     */
+    void copiarDe(const ListaSensorBloques& otra) {
+        NodoBloque<T, N>* actual = otra.cabeza;
+        while (actual != nullptr) {
+            for (int i = 0; i < actual->usados; i++) {
+                insertarAlFinal(actual->datos[i], actual->marcaBase + actual->deltas[i]);
+            }
+            actual = actual->siguiente;
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor por defecto: lista vacía
+     */
+    ListaSensorBloques()
+        : cabeza(nullptr), cola(nullptr), tamaño(0), usarIndice(false), siguienteOrden(0) {
+        REGISTRO_DETALLE("[LOG] Lista por bloques creada");
+    }
+
+    /**
+     * @brief Destructor: libera todos los bloques
+     */
+    ~ListaSensorBloques() {
+        NodoBloque<T, N>* actual = cabeza;
+        while (actual != nullptr) {
+            NodoBloque<T, N>* siguiente = actual->siguiente;
+            REGISTRO_DETALLE("\t[LOG] Bloque de " << actual->usados << " valor(es) liberado");
+            asignador.liberar(actual);
+            actual = siguiente;
+        }
+        REGISTRO_DETALLE("\t[LOG] Lista por bloques destruida");
+    }
+
+    /**
+     * @brief Constructor de copia (copia profunda de los valores)
+     * @param otra Lista a copiar
+     */
+    ListaSensorBloques(const ListaSensorBloques& otra)
+        : cabeza(nullptr), cola(nullptr), tamaño(0), usarIndice(otra.usarIndice), siguienteOrden(0) {
+        copiarDe(otra);
+    }
+
+    /**
+     * @brief Operador de asignación
+     * @param otra Lista a asignar
+     * @return Referencia a esta lista
+     */
+    ListaSensorBloques& operator=(const ListaSensorBloques& otra) {
+        if (this != &otra) {
+            vaciar();
+            usarIndice = otra.usarIndice;
+            copiarDe(otra);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Constructor de movimiento: toma los bloques de 'otra' en O(1)
+     * @param otra Lista que queda vacía
+     *
+     * NOTA: El índice de mínimos viaja con los bloques; cada bloque
+     * conserva su posición en él.
+     */
+    ListaSensorBloques(ListaSensorBloques&& otra) noexcept
+        : cabeza(nullptr), cola(nullptr), tamaño(0),
+          usarIndice(otra.usarIndice), siguienteOrden(0) {
+        intercambiar(otra);
+    }
+
+    /**
+     * @brief Asignación por movimiento
+     * @param otra Lista que entrega sus bloques
+     * @return Referencia a esta lista
+     */
+    ListaSensorBloques& operator=(ListaSensorBloques&& otra) noexcept {
+        if (this != &otra) {
+            vaciar();
+            intercambiar(otra);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Intercambia el contenido con otra lista en O(1)
+     * @param otra Lista con la que se intercambia
+     */
+    void intercambiar(ListaSensorBloques& otra) noexcept {
+        std::swap(cabeza, otra.cabeza);
+        std::swap(cola, otra.cola);
+        std::swap(tamaño, otra.tamaño);
+        std::swap(asignador, otra.asignador);
+        std::swap(estadisticas, otra.estadisticas);
+        indiceMinimo.intercambiar(otra.indiceMinimo);
+        std::swap(usarIndice, otra.usarIndice);
+        std::swap(siguienteOrden, otra.siguienteOrden);
+    }
+
+    /**
+     * @brief Versión libre para std::swap y algoritmos de la biblioteca
+     */
+    friend void swap(ListaSensorBloques& a, ListaSensorBloques& b) noexcept {
+        a.intercambiar(b);
+    }
+
+    /**
+     * @brief Mueve todos los bloques de otra lista al final de esta
+     * @param otra Lista que queda vacía
+     *
+     * PROCESO:
+     * 1. Se reenlazan los bloques: cola <-> cabeza de 'otra'
+     * 2. Cada bloque recibido toma un 'orden' posterior a los nuestros,
+     *    para que los mínimos repetidos sigan desempatando por antigüedad
+     * 3. Con índice activo, los bloques recibidos entran al montículo
+     *
+     * COMPLEJIDAD: O(B) en los bloques de 'otra' (O(B log B) con índice);
+     * ningún valor se copia. El último bloque propio puede quedar a medio
+     * llenar, lo cual no rompe la invariante de bloques no vacíos.
+     */
+    void empalmarAlFinal(ListaSensorBloques& otra) {
+        if (this == &otra || otra.cabeza == nullptr) {
+            return;
+        }
+
+        asignador.absorber(otra.asignador);
+        for (NodoBloque<T, N>* b = otra.cabeza; b != nullptr; b = b->siguiente) {
+            b->orden = siguienteOrden++;
+            if (usarIndice) {
+                indiceMinimo.insertar(b);
+            }
+        }
+
+        otra.cabeza->anterior = cola;
+        if (cabeza == nullptr) {
+            cabeza = otra.cabeza;
+        } else {
+            cola->siguiente = otra.cabeza;
+        }
+        cola = otra.cola;
+        tamaño += otra.tamaño;
+        estadisticas.combinar(otra.estadisticas);
+        REGISTRO_DETALLE("[LOG] " << otra.tamaño << " valor(es) empalmados al final");
+
+        otra.cabeza = nullptr;
+        otra.cola = nullptr;
+        otra.tamaño = 0;
+        otra.estadisticas.reiniciar();
+        otra.indiceMinimo.vaciar();
+    }
+
+    /**
+     * @brief Inserta un elemento al final de la lista, con la marca actual
+     * @param valor Dato a insertar
+     */
+    void insertarAlFinal(T valor) {
+        insertarAlFinal(valor, relojMonotonicoMs());
+    }
+
+    /**
+     * @brief Inserta un elemento al final de la lista
+     * @param valor Dato a insertar
+     * @param marcaMs Marca monotónica de la lectura
+     *
+     * PROCESO:
+     * - Si el último bloque tiene espacio, el valor va ahí
+     * - Si no (o la lista está vacía), se engancha un bloque nuevo
+     */
+    void insertarAlFinal(T valor, long long marcaMs) {
+        bool bloqueNuevo = false;
+        if (!colaAdmite(marcaMs)) {
+            engancharBloque(marcaMs);
+            bloqueNuevo = true;
+        }
+
+        cola->deltas[cola->usados] = deltaDe(cola, marcaMs);
+        cola->datos[cola->usados++] = valor;
+        tamaño++;
+        estadisticas.agregar(valor);
+
+        // Solo un valor estrictamente menor cambia el primer mínimo del bloque
+        bool cambioMinimo = valor < cola->datos[cola->posMin];
+        if (cambioMinimo) {
+            cola->posMin = cola->usados - 1;
+        }
+        if (usarIndice) {
+            if (bloqueNuevo) {
+                indiceMinimo.insertar(cola);
+            } else if (cambioMinimo) {
+                indiceMinimo.actualizar(cola);
+            }
+        }
+
+        if (tamaño == 1) {
+            REGISTRO_DETALLE("[LOG] Primer nodo insertado: " << valor);
+        } else {
+            REGISTRO_DETALLE("[LOG] Nodo insertado al final: " << valor);
+        }
+    }
+
+    /**
+     * @brief Inserta un lote de valores al final, con la marca actual
+     * @tparam U Tipo de origen (ej: double del parser); se convierte a T
+     */
+    template <typename U>
+    void insertarVarios(const U* valores, int cantidad) {
+        insertarVarios(valores, cantidad, relojMonotonicoMs());
+    }
+
+    /**
+     * @brief Inserta un lote de valores al final, bloque por bloque
+     * @tparam U Tipo de origen (ej: double del parser); se convierte a T
+     * @param valores Primer valor del lote
+     * @param cantidad Valores del lote
+     * @param marcaMs Marca común a todo el lote (llegó en la misma ráfaga)
+     *
+     * PROCESO:
+     * 1. Se llena el espacio libre de la cola con un tramo del lote
+     * 2. El mínimo del tramo se busca con un solo recorrido vectorizado
+     *    y se compara una vez con el mínimo que ya tenía el bloque
+     * 3. El índice de mínimos se toca una vez por bloque, no por valor
+     * 4. Se repite con bloques nuevos hasta agotar el lote
+     *
+     * RAZÓN: Equivale a llamar insertarAlFinal por cada valor, pero sin
+     * una línea de log ni una reacomodación del montículo por lectura.
+     */
+    template <typename U>
+    void insertarVarios(const U* valores, int cantidad, long long marcaMs) {
+        int i = 0;
+        while (i < cantidad) {
+            bool bloqueNuevo = false;
+            if (!colaAdmite(marcaMs)) {
+                engancharBloque(marcaMs);
+                bloqueNuevo = true;
+            }
+
+            int desde = cola->usados;
+            int tramo = N - desde;
+            if (tramo > cantidad - i) {
+                tramo = cantidad - i;
+            }
+            unsigned int delta = deltaDe(cola, marcaMs);
+            for (int j = 0; j < tramo; j++) {
+                T valor = static_cast<T>(valores[i + j]);
+                cola->datos[desde + j] = valor;
+                cola->deltas[desde + j] = delta;
+                estadisticas.agregar(valor);
+            }
+            cola->usados += tramo;
+            tamaño += tramo;
+            i += tramo;
+
+            // Como en insertarAlFinal, solo un valor estrictamente menor desplaza al primer mínimo
+            int posTramo = desde + posicionMinimo(cola->datos + desde, tramo);
+            bool cambioMinimo = bloqueNuevo || cola->datos[posTramo] < cola->datos[cola->posMin];
+            if (cambioMinimo) {
+                cola->posMin = posTramo;
+            }
+            if (usarIndice) {
+                if (bloqueNuevo) {
+                    indiceMinimo.insertar(cola);
+                } else if (cambioMinimo) {
+                    indiceMinimo.actualizar(cola);
+                }
+            }
+        }
+
+        REGISTRO_DETALLE("[LOG] " << cantidad << " valor(es) insertados al final");
+    }
+
+    /**
+     * @brief Calcula el promedio de todos los valores
+     * @return Promedio de tipo T
+     *
+     * COMPLEJIDAD: O(1), a partir de EstadisticasLista.
+     */
+    T calcularPromedio() const {
+        if (cabeza == nullptr) {
+            REGISTRO_ADVERTENCIA("[ADVERTENCIA] Lista vacía, retornando 0.");
+            return static_cast<T>(0);
+        }
+
+        return estadisticas.promedio();
+    }
+
+    /**
+     * @brief Encuentra y elimina el valor más bajo
+     * @return El valor eliminado
+     *
+     * PROCESO:
+     * 1. Ubicar el primer mínimo:
+     *    - Con índice: es el mínimo del bloque en la raíz del montículo
+     *    - Sin índice: se comparan los mínimos guardados de cada bloque
+     * 2. Recorrer hacia la izquierda los valores que le siguen
+     *    dentro de su bloque (como máximo N-1 movimientos)
+     * 3. Si el bloque queda vacío, desengancharlo y liberarlo;
+     *    si no, recalcular su mínimo (recorrido de un solo arreglo)
+     *
+     * COMPLEJIDAD: O(B + N) sin índice y O(log B + N) con índice,
+     * siendo B la cantidad de bloques.
+     */
+    T eliminarMinimo() {
+        if (cabeza == nullptr) {
+            REGISTRO_ERROR("[ERRROR] No hay elementos para eliminar.");
+            return static_cast<T>(0);
+        }
+
+        NodoBloque<T, N>* bloqueMin = usarIndice ? indiceMinimo.raiz() : bloqueConMinimo();
+
+        int posMin = bloqueMin->posMin;
+        T valorMin = bloqueMin->datos[posMin];
+
+        // Cerramos el hueco dentro del bloque (el valor se lleva su marca)
+        for (int i = posMin + 1; i < bloqueMin->usados; i++) {
+            bloqueMin->datos[i - 1] = bloqueMin->datos[i];
+            bloqueMin->deltas[i - 1] = bloqueMin->deltas[i];
+        }
+        bloqueMin->usados--;
+        tamaño--;
+
+        // Mantenemos la invariante: no hay bloques vacíos
+        if (bloqueMin->usados == 0) {
+            if (usarIndice) {
+                indiceMinimo.quitar(bloqueMin);
+            }
+            liberarBloque(bloqueMin);
+        } else {
+            recalcularMinimo(bloqueMin);
+            if (usarIndice) {
+                indiceMinimo.actualizar(bloqueMin);
+            }
+        }
+
+        // El nuevo mínimo es el del bloque que ahora va primero
+        estadisticas.quitar(valorMin);
+        if (tamaño > 0) {
+            NodoBloque<T, N>* nuevoMin = usarIndice ? indiceMinimo.raiz() : bloqueConMinimo();
+            estadisticas.fijarExtremos(nuevoMin->datos[nuevoMin->posMin], estadisticas.obtenerMaximo());
+        }
+
+        REGISTRO_DETALLE("[LOG] Valor mínimo eliminado: " << valorMin);
+        return valorMin;
+    }
+
+    /**
+     * @brief Mantiene un índice de mínimos junto a la lista
+     *
+     * RAZÓN: Para sensores que eliminan el mínimo con frecuencia
+     * (ver SensorTemperatura::procesarLectura). Cada inserción paga
+     * O(log B) como máximo y cada eliminarMinimo deja de recorrer
+     * toda la lista.
+     */
+    void activarIndiceMinimo() {
+        if (usarIndice) {
+            return;
+        }
+        usarIndice = true;
+        NodoBloque<T, N>* actual = cabeza;
+        while (actual != nullptr) {
+            indiceMinimo.insertar(actual);
+            actual = actual->siguiente;
+        }
+    }
+
+    /**
+     * @brief Imprime todos los elementos de la lista
+     */
+    void imprimir() const {
+        EscritorInforme salida(salidaRegistro(), 4096);
+        escribir(salida);
+    }
+
+    /**
+     * @brief Escribe la lista en un informe, de la lectura más vieja a la más nueva
+     * @param salida Escritor con buffer (ver EscritorInforme.h)
+     * @param maximo Últimas lecturas a escribir (-1 = todas); las que se
+     *        omiten se resumen al principio como "… +K anteriores"
+     */
+    void escribir(EscritorInforme& salida, int maximo = -1) const {
+        if (cabeza == nullptr) {
+            salida << "[WARNING] Lista vacía\n";
+            return;
+        }
+
+        int omitidas = (maximo >= 0 && maximo < tamaño) ? tamaño - maximo : 0;
+        salida << "[Lista: ";
+        if (omitidas > 0) {
+            salida << "… +" << omitidas << " anteriores";
+            if (omitidas < tamaño) {
+                salida << " → ";
+            }
+        }
+        // Los bloques enteros que caen antes del corte se saltan sin leerlos
+        int impresos = omitidas;
+        int saltar = omitidas;
+        NodoBloque<T, N>* actual = cabeza;
+        while (actual != nullptr && saltar >= actual->usados) {
+            saltar -= actual->usados;
+            actual = actual->siguiente;
+        }
+        while (actual != nullptr) {
+            for (int i = saltar; i < actual->usados; i++) {
+                salida << actual->datos[i];
+                if (++impresos < tamaño) {
+                    salida << " → ";
+                }
+            }
+            saltar = 0;
+            actual = actual->siguiente;
+        }
+        salida << "]\n";
+    }
+
+    /**
+     * @brief Suma todos los valores recorriendo los bloques
+     * @return Suma en el acumulador ancho de T
+     *
+     * RAZÓN: Las estadísticas incrementales acumulan redondeo con
+     * meses de inserciones y eliminaciones; esta suma parte de cero.
+     * Cada bloque se suma con el núcleo vectorizado.
+     */
+    typename AcumuladorDe<T>::tipo sumarTodo() const {
+        typename AcumuladorDe<T>::tipo suma = 0;
+        for (NodoBloque<T, N>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            suma += sumarValores(actual->datos, actual->usados);
+        }
+        return suma;
+    }
+
+    /**
+     * @brief Cuenta las lecturas estrictamente mayores que un umbral
+     * @param umbral Valor de comparación (ej: temperatura de alarma)
+     * @return Cantidad de lecturas sobre el umbral
+     */
+    int contarMayoresQue(T umbral) const {
+        int cuenta = 0;
+        for (NodoBloque<T, N>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            cuenta += contarMayores(actual->datos, actual->usados, umbral);
+        }
+        return cuenta;
+    }
+
+    /**
+     * @brief Pone las lecturas de otra lista ANTES de las propias
+     * @param anteriores Lista más vieja que esta; queda vacía
+     *
+     * COMPLEJIDAD: La de empalmarAlFinal sobre los bloques propios;
+     * ningún valor se copia.
+     */
+    void anteponer(ListaSensorBloques& anteriores) {
+        anteriores.empalmarAlFinal(*this);
+        intercambiar(anteriores);
+    }
+
+    /**
+     * @brief Visita, en orden de llegada, las lecturas desde una marca
+     * @tparam Visitante Invocable como f(long long marcaMs, T valor)
+     * @param desdeMs Marca mínima (inclusive), ej: relojMonotonicoMs() - 60000
+     * @param f Función que recibe cada lectura
+     *
+     * RAZÓN: Las inserciones llegan en orden de tiempo, así que la
+     * última marca de un bloque es la más nueva; un bloque entero
+     * anterior a 'desdeMs' se salta sin mirar sus valores.
+     */
+    template <typename Visitante>
+    void recorrerDesde(long long desdeMs, Visitante f) const {
+        for (NodoBloque<T, N>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            if (actual->marcaBase + actual->deltas[actual->usados - 1] < desdeMs) {
+                continue;
+            }
+            for (int i = 0; i < actual->usados; i++) {
+                long long marca = actual->marcaBase + actual->deltas[i];
+                if (marca >= desdeMs) {
+                    f(marca, actual->datos[i]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Obtiene el tamaño de la lista
+     * @return Número de elementos
+     */
+    int obtenerTamaño() const {
+        return tamaño;
+    }
+
+    /**
+     * @brief Acceso a los agregados incrementales
+     * @return Suma, mínimo, máximo y varianza sin recorrer la lista
+     */
+    const EstadisticasLista<T>& obtenerEstadisticas() const {
+        return estadisticas;
+    }
+
+    /**
+     * @brief Verifica si la lista está vacía
+     * @return true si está vacía, false en caso contrario
+     */
+    bool estaVacia() const {
+        return cabeza == nullptr;
+    }
+};
+
+#endif
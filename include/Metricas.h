@@ -0,0 +1,359 @@
+/**
+ * @file Metricas.h
+ * @brief Contadores e histogramas de latencia del camino de ingesta
+ * @details Cada hilo escribe en su propio fragmento, sin cerrojos ni
+ *          instrucciones atómicas de lectura-modificación-escritura;
+ *          quien informa suma los fragmentos (tomarFoto). Se compila
+ *          con METRICAS=0 para que las macros no generen código.
+ */
+
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief 1 = instrumentación compilada (por defecto), 0 = sin código
+ *
+ * Se define desde CMake (-DMETRICAS=OFF). Igual que NIVEL_REGISTRO en
+ * Registro.h: con 0 las macros METRICA_* quedan vacías.
+ */
+#ifndef METRICAS
+#define METRICAS 1
+#endif
+
+/**
+ * @brief Eventos que solo se cuentan
+ */
+enum ContadorMetrica {
+    CONTADOR_BYTES_LEIDOS,       ///< Bytes devueltos por read() en los puertos
+    CONTADOR_LINEAS,             ///< Líneas de texto que llegaron a procesarLinea
+    CONTADOR_MALFORMADAS,        ///< Líneas rechazadas por el parser ("[Advertencia] Línea malformada")
+    CONTADOR_DESCARTADAS,        ///< Líneas demasiado largas que LectorLineas tiró enteras
+    CONTADOR_LECTURAS,           ///< Lecturas entregadas a un sensor (texto y binario)
+    CONTADOR_SENSORES_NUEVOS,    ///< Sensores creados al recibir un ID desconocido
+    CANTIDAD_CONTADORES
+};
+
+/**
+ * @brief Etapas cuya duración se mide
+ */
+enum EtapaMetrica {
+    ETAPA_LECTURA,     ///< Un read() de un puerto (LectorLineas / DecodificadorTramas)
+    ETAPA_PARSEO,      ///< parsearTrama + conversión del valor de una línea
+    ETAPA_BUSQUEDA,    ///< Búsqueda de un ID en el índice del gestor
+    ETAPA_INSERCION,   ///< agregarLectura(s) de un sensor, con su cerrojo tomado
+    ETAPA_PROCESO,     ///< Una pasada completa de procesarTodos
+    CANTIDAD_ETAPAS
+};
+
+/**
+ * @brief Marca de tiempo en la unidad más barata disponible
+ *
+ * RAZÓN de rdtsc: steady_clock::now() cuesta ~20 ns aun por vDSO; el
+ * contador de ciclos, menos de 10. Los ciclos se pasan a nanosegundos
+ * solo al informar (ver Metricas::nanosegundosPorCiclo).
+ */
+inline unsigned long long marcaCiclos() {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    return __rdtsc();
+#else
+    return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @class HistogramaLatencia
+ * @brief Histograma logarítmico-lineal (estilo HDR) de un solo escritor
+ *
+ * CONCEPTO - Cubetas:
+ * Cada potencia de dos se parte en 8 cubetas iguales, así el error de
+ * ubicar un valor es como mucho 12.5% sea de 30 ns o de 30 ms. Los
+ * valores 0 a 7 tienen cubeta propia. Con 8 * 46 cubetas se cubre
+ * hasta 2^48 ciclos (un día a varios GHz) en menos de 3 KB.
+ *
+ * HILOS: Solo el hilo dueño escribe; por eso store(load() + 1) con
+ * memory_order_relaxed alcanza y compila a un incremento común. El
+ * atómico es para que leer desde otro hilo no sea una carrera.
+ */
+class HistogramaLatencia {
+public:
+    static const int SUBCUBETAS = 8;
+    static const int BITS_SUBCUBETA = 3;
+    static const int CUBETAS = SUBCUBETAS * 46;
+
+private:
+    std::atomic<unsigned long long> cubetas[CUBETAS];
+    std::atomic<unsigned long long> cantidad;
+    std::atomic<unsigned long long> suma;
+    std::atomic<unsigned long long> maximo;
+
+    static void sumarUno(std::atomic<unsigned long long>& a, unsigned long long v) {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+public:
+    HistogramaLatencia() : cantidad(0), suma(0), maximo(0) {
+        for (int i = 0; i < CUBETAS; i++) {
+            cubetas[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Cubeta de un valor
+     */
+    static int cubetaDe(unsigned long long v) {
+        if (v < SUBCUBETAS) {
+            return static_cast<int>(v);
+        }
+        int exponente = 63 - __builtin_clzll(v);
+        int i = (exponente - BITS_SUBCUBETA + 1) * SUBCUBETAS +
+                static_cast<int>((v >> (exponente - BITS_SUBCUBETA)) & (SUBCUBETAS - 1));
+        return i < CUBETAS ? i : CUBETAS - 1;
+    }
+
+    /**
+     * @brief Menor valor que cae en la cubeta 'i'
+     */
+    static unsigned long long limiteInferior(int i) {
+        if (i < SUBCUBETAS) {
+            return static_cast<unsigned long long>(i);
+        }
+        int exponente = i / SUBCUBETAS + BITS_SUBCUBETA - 1;
+        unsigned long long sub = static_cast<unsigned long long>(i % SUBCUBETAS);
+        return (SUBCUBETAS + sub) << (exponente - BITS_SUBCUBETA);
+    }
+
+    void registrar(unsigned long long ciclos) {
+        sumarUno(cubetas[cubetaDe(ciclos)], 1);
+        sumarUno(cantidad, 1);
+        sumarUno(suma, ciclos);
+        if (ciclos > maximo.load(std::memory_order_relaxed)) {
+            maximo.store(ciclos, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Suma este histograma a los arreglos de una foto
+     */
+    void acumularEn(unsigned long long* destino, unsigned long long& n, unsigned long long& s,
+                    unsigned long long& m) const {
+        for (int i = 0; i < CUBETAS; i++) {
+            destino[i] += cubetas[i].load(std::memory_order_relaxed);
+        }
+        n += cantidad.load(std::memory_order_relaxed);
+        s += suma.load(std::memory_order_relaxed);
+        unsigned long long mx = maximo.load(std::memory_order_relaxed);
+        if (mx > m) {
+            m = mx;
+        }
+    }
+};
+
+/**
+ * @brief Contadores e histogramas de un hilo
+ */
+struct FragmentoMetricas {
+    std::atomic<unsigned long long> contadores[CANTIDAD_CONTADORES];
+    HistogramaLatencia etapas[CANTIDAD_ETAPAS];
+
+    FragmentoMetricas() {
+        for (int i = 0; i < CANTIDAD_CONTADORES; i++) {
+            contadores[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void contar(ContadorMetrica c, unsigned long long n) {
+        contadores[c].store(contadores[c].load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Suma de todos los fragmentos en un instante, en nanosegundos
+ */
+struct FotoMetricas {
+    unsigned long long contadores[CANTIDAD_CONTADORES];
+    unsigned long long cubetas[CANTIDAD_ETAPAS][HistogramaLatencia::CUBETAS];
+    unsigned long long cantidad[CANTIDAD_ETAPAS];
+    unsigned long long sumaCiclos[CANTIDAD_ETAPAS];
+    unsigned long long maximoCiclos[CANTIDAD_ETAPAS];
+    double nanosegundosPorCiclo;
+    long long tomadaMs;  ///< Reloj monótono al tomarla
+
+    /**
+     * @brief Latencia del percentil 'p' (0 a 100) de una etapa, en ns
+     *
+     * NOTA: Devuelve el límite inferior de la cubeta donde cae el
+     * percentil; el valor real está a menos de 12.5% por encima.
+     */
+    double percentilNs(EtapaMetrica etapa, double p) const {
+        unsigned long long n = cantidad[etapa];
+        if (n == 0) {
+            return 0.0;
+        }
+        unsigned long long objetivo = static_cast<unsigned long long>(p / 100.0 * static_cast<double>(n));
+        if (objetivo >= n) {
+            objetivo = n - 1;
+        }
+        unsigned long long acumulado = 0;
+        for (int i = 0; i < HistogramaLatencia::CUBETAS; i++) {
+            acumulado += cubetas[etapa][i];
+            if (acumulado > objetivo) {
+                return static_cast<double>(HistogramaLatencia::limiteInferior(i)) * nanosegundosPorCiclo;
+            }
+        }
+        return static_cast<double>(maximoCiclos[etapa]) * nanosegundosPorCiclo;
+    }
+
+    double promedioNs(EtapaMetrica etapa) const {
+        return cantidad[etapa] == 0 ? 0.0
+                                    : static_cast<double>(sumaCiclos[etapa]) * nanosegundosPorCiclo /
+                                          static_cast<double>(cantidad[etapa]);
+    }
+
+    double maximoNs(EtapaMetrica etapa) const {
+        return static_cast<double>(maximoCiclos[etapa]) * nanosegundosPorCiclo;
+    }
+};
+
+/**
+ * @class Metricas
+ * @brief Registro de los fragmentos de todos los hilos del proceso
+ *
+ * PROCESO:
+ * 1. La primera vez que un hilo mide algo, delHilo() le crea un
+ *    fragmento y lo publica en el arreglo (un cerrojo, una sola vez)
+ * 2. Desde ahí cada evento es un acceso thread_local y un incremento
+ * 3. tomarFoto() recorre los fragmentos publicados y los suma
+ *
+ * NOTA: Los fragmentos viven hasta el final del proceso (lo contado por
+ * un hilo que terminó sigue en los totales). Pasados MAXIMO_HILOS, los
+ * hilos nuevos comparten el último fragmento y pueden perder cuentas.
+ */
+class Metricas {
+public:
+    static const int MAXIMO_HILOS = 64;
+
+private:
+    FragmentoMetricas* fragmentos[MAXIMO_HILOS];
+    std::atomic<int> cantidad;
+    std::mutex cerrojoAlta;
+    unsigned long long ciclosInicio;
+    long long nanosInicio;
+
+    static long long nanosMonotonicos() {
+        return static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    Metricas() : cantidad(0), ciclosInicio(marcaCiclos()), nanosInicio(nanosMonotonicos()) {}
+
+    FragmentoMetricas* darDeAlta() {
+        std::lock_guard<std::mutex> guardia(cerrojoAlta);
+        int n = cantidad.load(std::memory_order_relaxed);
+        if (n == MAXIMO_HILOS) {
+            return fragmentos[MAXIMO_HILOS - 1];
+        }
+        fragmentos[n] = new FragmentoMetricas();
+        cantidad.store(n + 1, std::memory_order_release);
+        return fragmentos[n];
+    }
+
+public:
+    ~Metricas() {
+        int n = cantidad.load(std::memory_order_acquire);
+        for (int i = 0; i < n; i++) {
+            delete fragmentos[i];
+        }
+    }
+
+    Metricas(const Metricas&) = delete;
+    Metricas& operator=(const Metricas&) = delete;
+
+    static Metricas& global() {
+        static Metricas instancia;
+        return instancia;
+    }
+
+    /**
+     * @brief Fragmento del hilo actual (creado la primera vez)
+     */
+    static FragmentoMetricas& delHilo() {
+        static thread_local FragmentoMetricas* propio = nullptr;
+        if (propio == nullptr) {
+            propio = global().darDeAlta();
+        }
+        return *propio;
+    }
+
+    /**
+     * @brief Relación entre marcaCiclos() y nanosegundos, medida desde el arranque
+     *
+     * RAZÓN: Calibrar contra steady_clock en el intervalo más largo
+     * disponible evita una espera al arrancar y mejora con el tiempo.
+     */
+    double nanosegundosPorCiclo() const {
+        unsigned long long ciclos = marcaCiclos() - ciclosInicio;
+        long long nanos = nanosMonotonicos() - nanosInicio;
+        return ciclos > 0 && nanos > 0 ? static_cast<double>(nanos) / static_cast<double>(ciclos) : 1.0;
+    }
+
+    /**
+     * @brief Suma los fragmentos de todos los hilos
+     */
+    void tomarFoto(FotoMetricas& foto) const {
+        for (int c = 0; c < CANTIDAD_CONTADORES; c++) {
+            foto.contadores[c] = 0;
+        }
+        for (int e = 0; e < CANTIDAD_ETAPAS; e++) {
+            for (int i = 0; i < HistogramaLatencia::CUBETAS; i++) {
+                foto.cubetas[e][i] = 0;
+            }
+            foto.cantidad[e] = 0;
+            foto.sumaCiclos[e] = 0;
+            foto.maximoCiclos[e] = 0;
+        }
+
+        int n = cantidad.load(std::memory_order_acquire);
+        for (int f = 0; f < n; f++) {
+            const FragmentoMetricas* fragmento = fragmentos[f];
+            for (int c = 0; c < CANTIDAD_CONTADORES; c++) {
+                foto.contadores[c] += fragmento->contadores[c].load(std::memory_order_relaxed);
+            }
+            for (int e = 0; e < CANTIDAD_ETAPAS; e++) {
+                fragmento->etapas[e].acumularEn(foto.cubetas[e], foto.cantidad[e], foto.sumaCiclos[e],
+                                                foto.maximoCiclos[e]);
+            }
+        }
+        foto.nanosegundosPorCiclo = nanosegundosPorCiclo();
+        foto.tomadaMs = nanosMonotonicos() / 1000000;
+    }
+};
+
+/**
+ * @brief Macros de instrumentación (vacías con METRICAS=0)
+ *
+ * USO:
+ *   METRICA_INICIO(t);
+ *   ... trabajo ...
+ *   METRICA_FIN(ETAPA_PARSEO, t);
+ *   METRICA_CONTAR(CONTADOR_LINEAS, 1);
+ */
+#if METRICAS
+#define METRICA_CONTAR(contador, n) Metricas::delHilo().contar((contador), (n))
+#define METRICA_INICIO(variable) const unsigned long long variable = marcaCiclos()
+#define METRICA_FIN(etapa, variable) Metricas::delHilo().etapas[(etapa)].registrar(marcaCiclos() - (variable))
+#else
+#define METRICA_CONTAR(contador, n) ((void)0)
+#define METRICA_INICIO(variable) ((void)0)
+#define METRICA_FIN(etapa, variable) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * @file MonticuloBloques.h
+ * @brief Índice de mínimos (montículo binario) sobre los bloques de una lista
+ * @details Cada bloque de ListaSensorBloques conoce la posición de su valor
+ *          más bajo. Este montículo ordena los bloques por ese valor, de modo
+ *          que el mínimo global está siempre en la raíz.
+ */
+
+#ifndef MONTICULO_BLOQUES_H
+#define MONTICULO_BLOQUES_H
+
+#include <utility>
+
+/**
+ * @class MonticuloBloques
+ * @brief Montículo binario de mínimos cuyas entradas son bloques
+ * @tparam Bloque Tipo de bloque; debe tener los campos
+ *         'datos', 'posMin', 'posMonticulo' y 'orden'
+ *
+ * CONCEPTO - Montículo (heap):
+ * Es un árbol guardado en un arreglo donde cada padre es menor o igual
+ * que sus hijos. La raíz (posición 0) es siempre el menor.
+ * - Hijos de i: 2i+1 y 2i+2
+ * - Padre de i: (i-1)/2
+ *
+ * RAZÓN de indexar bloques y no valores:
+ * Los valores se mueven dentro de su bloque al eliminar, pero el bloque
+ * no. Cada bloque guarda su posición en el montículo ('posMonticulo'),
+ * así se puede reacomodar o quitar cualquiera en O(log B).
+ *
+ * DESEMPATE: Con mínimos iguales gana el bloque más antiguo ('orden'),
+ * para eliminar siempre la primera ocurrencia como el recorrido lineal.
+ */
+template <typename Bloque>
+class MonticuloBloques {
+private:
+    Bloque** elementos;  ///< Arreglo dinámico de bloques
+    int cantidad;        ///< Bloques en el montículo
+    int capacidad;       ///< Tamaño reservado de 'elementos'
+
+    /**
+     * @brief Indica si el bloque a debe ir antes que b
+     */
+    static bool antes(const Bloque* a, const Bloque* b) {
+        const auto& minA = a->datos[a->posMin];
+        const auto& minB = b->datos[b->posMin];
+        if (minA < minB) {
+            return true;
+        }
+        if (minB < minA) {
+            return false;
+        }
+        return a->orden < b->orden;
+    }
+
+    /**
+     * @brief Coloca un bloque en una posición y actualiza su índice
+     */
+    void colocar(int pos, Bloque* b) {
+        elementos[pos] = b;
+        b->posMonticulo = pos;
+    }
+
+    void subir(int pos) {
+        Bloque* b = elementos[pos];
+        while (pos > 0) {
+            int padre = (pos - 1) / 2;
+            if (!antes(b, elementos[padre])) {
+                break;
+            }
+            colocar(pos, elementos[padre]);
+            pos = padre;
+        }
+        colocar(pos, b);
+    }
+
+    void bajar(int pos) {
+        Bloque* b = elementos[pos];
+        while (true) {
+            int hijo = 2 * pos + 1;
+            if (hijo >= cantidad) {
+                break;
+            }
+            if (hijo + 1 < cantidad && antes(elementos[hijo + 1], elementos[hijo])) {
+                hijo++;
+            }
+            if (!antes(elementos[hijo], b)) {
+                break;
+            }
+            colocar(pos, elementos[hijo]);
+            pos = hijo;
+        }
+        colocar(pos, b);
+    }
+
+public:
+    /**
+     * @brief Constructor: montículo vacío sin memoria reservada
+     */
+    MonticuloBloques() : elementos(nullptr), cantidad(0), capacidad(0) {}
+
+    /**
+     * @brief Destructor: libera el arreglo (los bloques no son suyos)
+     */
+    ~MonticuloBloques() {
+        delete[] elementos;
+    }
+
+    MonticuloBloques(const MonticuloBloques&) = delete;
+    MonticuloBloques& operator=(const MonticuloBloques&) = delete;
+
+    /**
+     * @brief Intercambia el contenido con otro montículo en O(1)
+     *
+     * NOTA: Cada bloque conserva su 'posMonticulo', porque las
+     * posiciones dentro de cada arreglo no cambian.
+     */
+    void intercambiar(MonticuloBloques& otro) noexcept {
+        std::swap(elementos, otro.elementos);
+        std::swap(cantidad, otro.cantidad);
+        std::swap(capacidad, otro.capacidad);
+    }
+
+    /**
+     * @brief Agrega un bloque al montículo
+     * @param b Bloque con 'posMin' ya calculado
+     */
+    void insertar(Bloque* b) {
+        if (cantidad == capacidad) {
+            int nuevaCapacidad = capacidad == 0 ? 16 : capacidad * 2;
+            Bloque** nuevo = new Bloque*[nuevaCapacidad];
+            for (int i = 0; i < cantidad; i++) {
+                nuevo[i] = elementos[i];
+            }
+            delete[] elementos;
+            elementos = nuevo;
+            capacidad = nuevaCapacidad;
+        }
+        colocar(cantidad, b);
+        cantidad++;
+        subir(cantidad - 1);
+    }
+
+    /**
+     * @brief Reacomoda un bloque cuyo mínimo cambió
+     * @param b Bloque que ya está en el montículo
+     */
+    void actualizar(Bloque* b) {
+        subir(b->posMonticulo);
+        bajar(b->posMonticulo);
+    }
+
+    /**
+     * @brief Quita un bloque cualquiera del montículo
+     * @param b Bloque que ya está en el montículo
+     */
+    void quitar(Bloque* b) {
+        int pos = b->posMonticulo;
+        cantidad--;
+        if (pos != cantidad) {
+            colocar(pos, elementos[cantidad]);
+            actualizar(elementos[pos]);
+        }
+    }
+
+    /**
+     * @brief Bloque que contiene el mínimo global
+     * @return Raíz del montículo, o nullptr si está vacío
+     */
+    Bloque* raiz() const {
+        return cantidad > 0 ? elementos[0] : nullptr;
+    }
+
+    /**
+     * @brief Vacía el montículo sin liberar memoria
+     */
+    void vaciar() {
+        cantidad = 0;
+    }
+};
+
+#endif
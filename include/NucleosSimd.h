@@ -0,0 +1,445 @@
+/**
+ * @file NucleosSimd.h
+ * @brief Recorridos vectorizados (SIMD) sobre arreglos de lecturas
+ * @details Suma, mínimo/máximo, posición del primer mínimo y conteo sobre
+ *          un umbral, para arreglos contiguos de float (temperatura) e int
+ *          (presión). En x86 se elige AVX2 al ejecutar si el procesador lo
+ *          tiene; en ARM de 64 bits se usa NEON; si no, la versión escalar.
+ */
+
+#ifndef NUCLEOS_SIMD_H
+#define NUCLEOS_SIMD_H
+
+#include "EstadisticasLista.h"
+
+#if !defined(NUCLEOS_SIN_SIMD) && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NUCLEOS_AVX2 1
+#include <immintrin.h>
+#elif !defined(NUCLEOS_SIN_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#define NUCLEOS_NEON 1
+#include <arm_neon.h>
+#endif
+
+/**
+ * CONCEPTO - SIMD (una instrucción, varios datos):
+ * Un registro AVX2 de 256 bits contiene 8 float u 8 int. Una sola
+ * instrucción suma, compara o calcula el mínimo de los 8 a la vez.
+ *
+ * USO: Mismo nombre para cualquier tipo; float e int usan la versión
+ * vectorizada, los demás tipos caen en la plantilla escalar.
+ *   float minimo, maximo;
+ *   buscarExtremos(datos, n, minimo, maximo);
+ *   int pos = posicionMinimo(datos, n);
+ *
+ * NOTA: Se asume que no hay NaN (convertirDecimal nunca los produce).
+ * Para desactivar la versión vectorizada: -DNUCLEOS_SIN_SIMD.
+ */
+
+// ============================================================================
+// VERSIONES ESCALARES (referencia y respaldo)
+// ============================================================================
+
+/**
+ * @brief Suma de n valores en el acumulador ancho de T
+ */
+template <typename T>
+typename AcumuladorDe<T>::tipo sumarValores(const T* datos, int n) {
+    typename AcumuladorDe<T>::tipo suma = 0;
+    for (int i = 0; i < n; i++) {
+        suma += datos[i];
+    }
+    return suma;
+}
+
+/**
+ * @brief Mínimo y máximo de n valores (n > 0)
+ */
+template <typename T>
+void buscarExtremos(const T* datos, int n, T& minimo, T& maximo) {
+    minimo = datos[0];
+    maximo = datos[0];
+    for (int i = 1; i < n; i++) {
+        if (datos[i] < minimo) {
+            minimo = datos[i];
+        }
+        if (maximo < datos[i]) {
+            maximo = datos[i];
+        }
+    }
+}
+
+/**
+ * @brief Posición del PRIMER mínimo de n valores (n > 0)
+ */
+template <typename T>
+int posicionMinimo(const T* datos, int n) {
+    int pos = 0;
+    for (int i = 1; i < n; i++) {
+        if (datos[i] < datos[pos]) {
+            pos = i;
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief Cantidad de valores estrictamente mayores que 'umbral'
+ */
+template <typename T>
+int contarMayores(const T* datos, int n, T umbral) {
+    int cuenta = 0;
+    for (int i = 0; i < n; i++) {
+        if (umbral < datos[i]) {
+            cuenta++;
+        }
+    }
+    return cuenta;
+}
+
+/**
+ * @brief Posición del primer valor igual a 'objetivo' (debe existir)
+ *
+ * RAZÓN: posicionMinimo vectorizado calcula primero el mínimo a lo
+ * ancho y después ubica su primera aparición con este recorrido.
+ */
+template <typename T>
+int primeraPosicionDe(const T* datos, int n, T objetivo) {
+    for (int i = 0; i < n; i++) {
+        if (datos[i] == objetivo) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// ============================================================================
+// x86: AVX2 CON DETECCIÓN AL EJECUTAR
+// ============================================================================
+
+#if defined(NUCLEOS_AVX2)
+
+/**
+ * @brief ¿El procesador actual soporta AVX2?
+ *
+ * RAZÓN de preguntarlo al ejecutar:
+ * El mismo binario debe funcionar en una Raspberry con x86 viejo y en
+ * un servidor nuevo. Compilar todo con -mavx2 rompería el primero.
+ * La respuesta se calcula una sola vez.
+ */
+inline bool hayAvx2() {
+    static const bool soportado = __builtin_cpu_supports("avx2");
+    return soportado;
+}
+
+__attribute__((target("avx2")))
+inline double sumarAvx2(const float* datos, int n) {
+    __m256d bajos = _mm256_setzero_pd();
+    __m256d altos = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(datos + i);
+        // Se acumula en double para no perder precisión con millones de lecturas
+        bajos = _mm256_add_pd(bajos, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+        altos = _mm256_add_pd(altos, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    }
+    double parciales[4];
+    _mm256_storeu_pd(parciales, _mm256_add_pd(bajos, altos));
+    double suma = parciales[0] + parciales[1] + parciales[2] + parciales[3];
+    for (; i < n; i++) {
+        suma += datos[i];
+    }
+    return suma;
+}
+
+__attribute__((target("avx2")))
+inline long long sumarAvx2(const int* datos, int n) {
+    __m256i bajos = _mm256_setzero_si256();
+    __m256i altos = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i));
+        bajos = _mm256_add_epi64(bajos, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        altos = _mm256_add_epi64(altos, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    long long parciales[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(parciales), _mm256_add_epi64(bajos, altos));
+    long long suma = parciales[0] + parciales[1] + parciales[2] + parciales[3];
+    for (; i < n; i++) {
+        suma += datos[i];
+    }
+    return suma;
+}
+
+__attribute__((target("avx2")))
+inline void extremosAvx2(const float* datos, int n, float& minimo, float& maximo) {
+    __m256 vMin = _mm256_set1_ps(datos[0]);
+    __m256 vMax = vMin;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(datos + i);
+        vMin = _mm256_min_ps(vMin, v);
+        vMax = _mm256_max_ps(vMax, v);
+    }
+    float carriles[8];
+    _mm256_storeu_ps(carriles, vMin);
+    minimo = carriles[0];
+    for (int k = 1; k < 8; k++) {
+        minimo = carriles[k] < minimo ? carriles[k] : minimo;
+    }
+    _mm256_storeu_ps(carriles, vMax);
+    maximo = carriles[0];
+    for (int k = 1; k < 8; k++) {
+        maximo = maximo < carriles[k] ? carriles[k] : maximo;
+    }
+    for (; i < n; i++) {
+        minimo = datos[i] < minimo ? datos[i] : minimo;
+        maximo = maximo < datos[i] ? datos[i] : maximo;
+    }
+}
+
+__attribute__((target("avx2")))
+inline void extremosAvx2(const int* datos, int n, int& minimo, int& maximo) {
+    __m256i vMin = _mm256_set1_epi32(datos[0]);
+    __m256i vMax = vMin;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i));
+        vMin = _mm256_min_epi32(vMin, v);
+        vMax = _mm256_max_epi32(vMax, v);
+    }
+    int carriles[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(carriles), vMin);
+    minimo = carriles[0];
+    for (int k = 1; k < 8; k++) {
+        minimo = carriles[k] < minimo ? carriles[k] : minimo;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(carriles), vMax);
+    maximo = carriles[0];
+    for (int k = 1; k < 8; k++) {
+        maximo = maximo < carriles[k] ? carriles[k] : maximo;
+    }
+    for (; i < n; i++) {
+        minimo = datos[i] < minimo ? datos[i] : minimo;
+        maximo = maximo < datos[i] ? datos[i] : maximo;
+    }
+}
+
+__attribute__((target("avx2")))
+inline int contarAvx2(const float* datos, int n, float umbral) {
+    __m256 u = _mm256_set1_ps(umbral);
+    int cuenta = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 mayor = _mm256_cmp_ps(_mm256_loadu_ps(datos + i), u, _CMP_GT_OQ);
+        cuenta += __builtin_popcount(static_cast<unsigned int>(_mm256_movemask_ps(mayor)));
+    }
+    for (; i < n; i++) {
+        cuenta += umbral < datos[i] ? 1 : 0;
+    }
+    return cuenta;
+}
+
+__attribute__((target("avx2")))
+inline int contarAvx2(const int* datos, int n, int umbral) {
+    __m256i u = _mm256_set1_epi32(umbral);
+    int cuenta = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i));
+        __m256i mayor = _mm256_cmpgt_epi32(v, u);
+        cuenta += __builtin_popcount(static_cast<unsigned int>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(mayor))));
+    }
+    for (; i < n; i++) {
+        cuenta += umbral < datos[i] ? 1 : 0;
+    }
+    return cuenta;
+}
+
+#define NUCLEO_DESPACHAR(avx2, escalar) (hayAvx2() ? (avx2) : (escalar))
+
+// ============================================================================
+// ARM de 64 bits: NEON (siempre presente, no hace falta detectarlo)
+// ============================================================================
+
+#elif defined(NUCLEOS_NEON)
+
+inline double sumarNeon(const float* datos, int n) {
+    float64x2_t bajos = vdupq_n_f64(0.0);
+    float64x2_t altos = vdupq_n_f64(0.0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vld1q_f32(datos + i);
+        bajos = vaddq_f64(bajos, vcvt_f64_f32(vget_low_f32(v)));
+        altos = vaddq_f64(altos, vcvt_high_f64_f32(v));
+    }
+    double suma = vaddvq_f64(vaddq_f64(bajos, altos));
+    for (; i < n; i++) {
+        suma += datos[i];
+    }
+    return suma;
+}
+
+inline long long sumarNeon(const int* datos, int n) {
+    int64x2_t acumulado = vdupq_n_s64(0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acumulado = vpadalq_s32(acumulado, vld1q_s32(datos + i));
+    }
+    long long suma = vaddvq_s64(acumulado);
+    for (; i < n; i++) {
+        suma += datos[i];
+    }
+    return suma;
+}
+
+inline void extremosNeon(const float* datos, int n, float& minimo, float& maximo) {
+    float32x4_t vMin = vdupq_n_f32(datos[0]);
+    float32x4_t vMax = vMin;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vld1q_f32(datos + i);
+        vMin = vminq_f32(vMin, v);
+        vMax = vmaxq_f32(vMax, v);
+    }
+    minimo = vminvq_f32(vMin);
+    maximo = vmaxvq_f32(vMax);
+    for (; i < n; i++) {
+        minimo = datos[i] < minimo ? datos[i] : minimo;
+        maximo = maximo < datos[i] ? datos[i] : maximo;
+    }
+}
+
+inline void extremosNeon(const int* datos, int n, int& minimo, int& maximo) {
+    int32x4_t vMin = vdupq_n_s32(datos[0]);
+    int32x4_t vMax = vMin;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t v = vld1q_s32(datos + i);
+        vMin = vminq_s32(vMin, v);
+        vMax = vmaxq_s32(vMax, v);
+    }
+    minimo = vminvq_s32(vMin);
+    maximo = vmaxvq_s32(vMax);
+    for (; i < n; i++) {
+        minimo = datos[i] < minimo ? datos[i] : minimo;
+        maximo = maximo < datos[i] ? datos[i] : maximo;
+    }
+}
+
+inline int contarNeon(const float* datos, int n, float umbral) {
+    float32x4_t u = vdupq_n_f32(umbral);
+    uint32x4_t cuentas = vdupq_n_u32(0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        // La comparación deja 0xFFFFFFFF (= -1) en cada carril verdadero
+        cuentas = vsubq_u32(cuentas, vcgtq_f32(vld1q_f32(datos + i), u));
+    }
+    int cuenta = static_cast<int>(vaddvq_u32(cuentas));
+    for (; i < n; i++) {
+        cuenta += umbral < datos[i] ? 1 : 0;
+    }
+    return cuenta;
+}
+
+inline int contarNeon(const int* datos, int n, int umbral) {
+    int32x4_t u = vdupq_n_s32(umbral);
+    uint32x4_t cuentas = vdupq_n_u32(0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        cuentas = vsubq_u32(cuentas, vcgtq_s32(vld1q_s32(datos + i), u));
+    }
+    int cuenta = static_cast<int>(vaddvq_u32(cuentas));
+    for (; i < n; i++) {
+        cuenta += umbral < datos[i] ? 1 : 0;
+    }
+    return cuenta;
+}
+
+#endif
+
+// ============================================================================
+// PUNTOS DE ENTRADA PARA float E int
+// ============================================================================
+// Al no ser plantillas, el compilador los prefiere sobre las versiones
+// escalares cuando el tipo coincide exactamente.
+
+#if defined(NUCLEOS_AVX2)
+
+inline double sumarValores(const float* datos, int n) {
+    return NUCLEO_DESPACHAR(sumarAvx2(datos, n), sumarValores<float>(datos, n));
+}
+
+inline long long sumarValores(const int* datos, int n) {
+    return NUCLEO_DESPACHAR(sumarAvx2(datos, n), sumarValores<int>(datos, n));
+}
+
+inline void buscarExtremos(const float* datos, int n, float& minimo, float& maximo) {
+    NUCLEO_DESPACHAR(extremosAvx2(datos, n, minimo, maximo),
+                     buscarExtremos<float>(datos, n, minimo, maximo));
+}
+
+inline void buscarExtremos(const int* datos, int n, int& minimo, int& maximo) {
+    NUCLEO_DESPACHAR(extremosAvx2(datos, n, minimo, maximo),
+                     buscarExtremos<int>(datos, n, minimo, maximo));
+}
+
+inline int contarMayores(const float* datos, int n, float umbral) {
+    return NUCLEO_DESPACHAR(contarAvx2(datos, n, umbral), contarMayores<float>(datos, n, umbral));
+}
+
+inline int contarMayores(const int* datos, int n, int umbral) {
+    return NUCLEO_DESPACHAR(contarAvx2(datos, n, umbral), contarMayores<int>(datos, n, umbral));
+}
+
+#elif defined(NUCLEOS_NEON)
+
+inline double sumarValores(const float* datos, int n) { return sumarNeon(datos, n); }
+inline long long sumarValores(const int* datos, int n) { return sumarNeon(datos, n); }
+
+inline void buscarExtremos(const float* datos, int n, float& minimo, float& maximo) {
+    extremosNeon(datos, n, minimo, maximo);
+}
+
+inline void buscarExtremos(const int* datos, int n, int& minimo, int& maximo) {
+    extremosNeon(datos, n, minimo, maximo);
+}
+
+inline int contarMayores(const float* datos, int n, float umbral) { return contarNeon(datos, n, umbral); }
+inline int contarMayores(const int* datos, int n, int umbral) { return contarNeon(datos, n, umbral); }
+
+#endif
+
+#if defined(NUCLEOS_AVX2) || defined(NUCLEOS_NEON)
+
+/**
+ * @brief Posición del primer mínimo, en dos pasadas
+ *
+ * PROCESO:
+ * 1. Mínimo a lo ancho (buscarExtremos vectorizado)
+ * 2. Primera posición con ese valor (suele cortar antes del final)
+ *
+ * RAZÓN del umbral de 16: en arreglos cortos las dos pasadas
+ * cuestan más que una sola escalar.
+ */
+inline int posicionMinimo(const float* datos, int n) {
+    if (n < 16) {
+        return posicionMinimo<float>(datos, n);
+    }
+    float minimo, maximo;
+    buscarExtremos(datos, n, minimo, maximo);
+    return primeraPosicionDe(datos, n, minimo);
+}
+
+inline int posicionMinimo(const int* datos, int n) {
+    if (n < 16) {
+        return posicionMinimo<int>(datos, n);
+    }
+    int minimo, maximo;
+    buscarExtremos(datos, n, minimo, maximo);
+    return primeraPosicionDe(datos, n, minimo);
+}
+
+#endif
+
+#endif
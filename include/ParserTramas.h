@@ -0,0 +1,366 @@
+/**
+ * @file ParserTramas.h
+ * @brief Parser sin copias de las tramas "TIPO,ID,VALOR" del ESP32
+ * @details Divide la línea en rebanadas que apuntan dentro del buffer de
+ *          recepción (sin modificarlo ni copiarlo) y convierte los números
+ *          con rutinas propias que no dependen del locale.
+ */
+
+#ifndef PARSER_TRAMAS_H
+#define PARSER_TRAMAS_H
+
+#include "TablaIdentificadores.h"
+
+#include <cmath>
+#include <cstring>
+
+/**
+ * @brief Vista de una porción de texto (puntero + largo)
+ *
+ * CONCEPTO - Rebanada (string view):
+ * No es dueña de la memoria ni termina en '\0'. Solo indica
+ * "desde aquí, tantos caracteres". Copiarla es gratis.
+ */
+struct Rebanada {
+    const char* inicio;  ///< Primer carácter
+    int largo;           ///< Cantidad de caracteres
+
+    Rebanada() : inicio(nullptr), largo(0) {}
+    Rebanada(const char* p, int n) : inicio(p), largo(n) {}
+};
+
+/**
+ * @brief Campos de una trama ya separada
+ */
+struct TramaLectura {
+    char tipo;       ///< 'T' (temperatura) o 'P' (presión)
+    Rebanada id;     ///< Identificador del sensor
+    Rebanada valor;  ///< Texto del valor, sin convertir
+};
+
+/**
+ * @brief Largo máximo de un ID en una trama (cabe en LecturaParseada::id con su '\0')
+ */
+const int LARGO_MAXIMO_ID = 49;
+
+/**
+ * @brief Indica si un ID puede viajar en una línea "TIPO,ID,VALOR"
+ * @param id Primer carácter (no necesita terminar en '\0')
+ * @param largo Cantidad de caracteres
+ * @return true si mide entre 1 y LARGO_MAXIMO_ID, no empieza con '#'
+ *         y no tiene ',', '\n' ni '\r'
+ *
+ * RAZÓN: Es la misma regla para todo ID que entra (texto, tabla del
+ * protocolo binario). Un ID con esos caracteres, vuelto a escribir como
+ * línea para un fragmento, partiría la línea o inyectaría una orden '#'.
+ */
+inline bool idValido(const char* id, int largo) {
+    if (largo <= 0 || largo > LARGO_MAXIMO_ID || id[0] == '#') {
+        return false;
+    }
+    for (int i = 0; i < largo; i++) {
+        if (id[i] == ',' || id[i] == '\n' || id[i] == '\r') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Separa una línea "TIPO,ID,VALOR" en sus tres campos
+ * @param linea Inicio de la línea (no necesita terminar en '\0')
+ * @param largo Cantidad de caracteres de la línea
+ * @param trama Recibe los campos si la línea es válida
+ * @return true si la línea tiene exactamente tres campos válidos
+ *
+ * REGLAS:
+ * - TIPO es un único carácter: 'T' o 'P'
+ * - ID cumple idValido (no vacío, hasta LARGO_MAXIMO_ID, sin '#' inicial)
+ * - VALOR no está vacío
+ *
+ * RAZÓN de no usar strtok:
+ * strtok guarda estado global (no es reentrante) y escribe '\0'
+ * dentro del buffer. Aquí solo leemos.
+ */
+inline bool parsearTrama(const char* linea, int largo, TramaLectura& trama) {
+    const char* fin = linea + largo;
+
+    // Campo 1: tipo de un carácter seguido de coma
+    // RAZÓN: Un tipo desconocido no tiene valor que convertir; aceptarlo
+    // dejaría pasar "X,T-001,99.9" como una lectura en 0
+    if (largo < 2 || linea[1] != ',' || (linea[0] != 'T' && linea[0] != 'P')) {
+        return false;
+    }
+    trama.tipo = linea[0];
+
+    // Campo 2: ID hasta la siguiente coma
+    const char* p = linea + 2;
+    const char* inicioId = p;
+    while (p < fin && *p != ',') {
+        p++;
+    }
+    if (p == fin) {
+        return false;
+    }
+    trama.id = Rebanada(inicioId, static_cast<int>(p - inicioId));
+    if (!idValido(trama.id.inicio, trama.id.largo)) {
+        return false;
+    }
+
+    // Campo 3: el resto es el valor (no se permite una cuarta coma)
+    p++;
+    const char* inicioValor = p;
+    while (p < fin) {
+        if (*p == ',') {
+            return false;
+        }
+        p++;
+    }
+    trama.valor = Rebanada(inicioValor, static_cast<int>(fin - inicioValor));
+    return trama.valor.largo > 0;
+}
+
+/**
+ * @brief Convierte texto decimal a double sin depender del locale
+ * @param texto Rebanada con el número (ej: "-23.45", "1e3")
+ * @param resultado Recibe el valor convertido
+ * @return true si toda la rebanada es un número válido y finito
+ *
+ * RAZÓN: atof/strtod respetan el locale (en algunos el separador
+ * decimal es ','), revisan espacios y aceptan formatos que el ESP32
+ * nunca envía. Este recorrido hace un solo paso sobre los dígitos.
+ */
+inline bool convertirDecimal(Rebanada texto, double& resultado) {
+    const char* p = texto.inicio;
+    const char* fin = p + texto.largo;
+    if (p == fin) {
+        return false;
+    }
+
+    bool negativo = false;
+    if (*p == '-' || *p == '+') {
+        negativo = (*p == '-');
+        p++;
+    }
+
+    // Acumulamos todos los dígitos como entero y al final dividimos
+    // una sola vez por la potencia de 10 (más preciso que sumar 0.1s)
+    double valor = 0.0;
+    int digitos = 0;
+    int exponente10 = 0;
+    while (p < fin && *p >= '0' && *p <= '9') {
+        valor = valor * 10.0 + (*p - '0');
+        p++;
+        digitos++;
+    }
+
+    if (p < fin && *p == '.') {
+        p++;
+        while (p < fin && *p >= '0' && *p <= '9') {
+            valor = valor * 10.0 + (*p - '0');
+            exponente10--;
+            p++;
+            digitos++;
+        }
+    }
+
+    if (digitos == 0) {
+        return false;
+    }
+
+    if (p < fin && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool expNegativo = false;
+        if (p < fin && (*p == '-' || *p == '+')) {
+            expNegativo = (*p == '-');
+            p++;
+        }
+        if (p == fin) {
+            return false;
+        }
+        int exponente = 0;
+        while (p < fin && *p >= '0' && *p <= '9') {
+            if (exponente < 400) {
+                exponente = exponente * 10 + (*p - '0');
+            }
+            p++;
+        }
+        exponente10 += expNegativo ? -exponente : exponente;
+    }
+
+    if (p != fin) {
+        return false;
+    }
+
+    int magnitud = exponente10 < 0 ? -exponente10 : exponente10;
+    double potencia = 1.0;
+    for (int i = 0; i < magnitud; i++) {
+        potencia *= 10.0;
+    }
+    valor = exponente10 < 0 ? valor / potencia : valor * potencia;
+
+    // "1e400" daría infinito y "0e400" NaN: ninguno es una lectura
+    if (!std::isfinite(valor)) {
+        return false;
+    }
+
+    resultado = negativo ? -valor : valor;
+    return true;
+}
+
+/**
+ * @brief Convierte texto a int sin depender del locale
+ * @param texto Rebanada con el número (ej: "1013", "-5", "1013.6")
+ * @param resultado Recibe el valor convertido
+ * @return true si la rebanada es un entero válido (o decimal, truncado)
+ *
+ * NOTA: Una parte decimal se trunca, igual que hacía atoi("1013.6").
+ */
+inline bool convertirEntero(Rebanada texto, int& resultado) {
+    const char* p = texto.inicio;
+    const char* fin = p + texto.largo;
+    if (p == fin) {
+        return false;
+    }
+
+    bool negativo = false;
+    if (*p == '-' || *p == '+') {
+        negativo = (*p == '-');
+        p++;
+    }
+
+    long long valor = 0;
+    int digitos = 0;
+    while (p < fin && *p >= '0' && *p <= '9') {
+        valor = valor * 10 + (*p - '0');
+        if (valor > 2147483648LL) {
+            return false;  // Fuera del rango de int
+        }
+        p++;
+        digitos++;
+    }
+    if (digitos == 0) {
+        return false;
+    }
+
+    if (p < fin && *p == '.') {
+        p++;
+        while (p < fin && *p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+    if (p != fin) {
+        return false;
+    }
+
+    if (negativo) {
+        valor = -valor;
+    }
+    if (valor > 2147483647LL) {
+        return false;
+    }
+    resultado = static_cast<int>(valor);
+    return true;
+}
+
+/**
+ * @brief Completa el campo que el tipo de la línea no llenó
+ * @param tipo 'T' (el valor está en 'decimal') o 'P' (está en 'entero')
+ * @param decimal Valor como double
+ * @param entero Valor como int
+ *
+ * RAZÓN: Quien agrega la lectura elige el campo por el tipo REAL del
+ * sensor (AgregarLectura, AgregarLote, AlmacenSegmentos), que puede no
+ * coincidir con el de la línea: "P,T-001,50" va a un sensor de
+ * temperatura. Con los dos campos llenos recibe 50 y no 0.
+ *
+ * NOTA: El decimal se trunca hacia cero como hacía atoi("7.5"), y se
+ * satura en los límites de int.
+ */
+inline void completarValores(char tipo, double& decimal, int& entero) {
+    if (tipo == 'P') {
+        decimal = static_cast<double>(entero);
+    } else if (decimal >= 2147483647.0) {
+        entero = 2147483647;
+    } else if (decimal <= -2147483648.0) {
+        entero = -2147483647 - 1;
+    } else if (decimal == decimal) {
+        entero = static_cast<int>(decimal);
+    } else {
+        entero = 0;
+    }
+}
+
+/**
+ * @brief Lectura ya parseada y convertida, lista para viajar entre hilos
+ *
+ * RAZÓN de copiar el ID aquí:
+ * Las rebanadas apuntan al buffer del lector, que se reutiliza en la
+ * siguiente lectura. Para pasar la lectura a otro hilo (ColaSPSC)
+ * necesitamos una copia autocontenida de tamaño fijo.
+ *
+ * 'identificador' es el mismo ID ya internado, o IDENTIFICADOR_DESCONOCIDO
+ * si al parsear todavía no existía. Con él, el gestor ubica al sensor
+ * sin volver a mirar el texto. Ocupa el relleno que dejaba 'id' antes
+ * de 'decimal': la estructura no crece.
+ */
+struct LecturaParseada {
+    char tipo;                       ///< 'T' o 'P'
+    unsigned char largoId;           ///< Caracteres de 'id' sin contar el '\0'
+    char id[LARGO_MAXIMO_ID + 1];    ///< ID terminado en '\0'
+    unsigned int identificador;      ///< ID internado, o IDENTIFICADOR_DESCONOCIDO
+    double decimal;                  ///< Valor como double (completarValores)
+    int entero;                      ///< Valor como int (completarValores)
+
+    /**
+     * RAZÓN: Quien arma una lectura a mano (sin copiarIdLectura) no deja
+     * un identificador basura; el gestor buscará el ID por su texto.
+     */
+    LecturaParseada() : identificador(IDENTIFICADOR_DESCONOCIDO) {}
+};
+
+/**
+ * @brief Copia un ID a una lectura y resuelve su identificador
+ * @param lectura Recibe 'id', 'largoId' e 'identificador'
+ * @param id Primer carácter del ID (largo entre 1 y LARGO_MAXIMO_ID)
+ * @param largo Cantidad de caracteres
+ *
+ * NOTA: Solo busca, no interna: un ID sin sensor (p. ej., de un tipo
+ * desconocido) no ocupa lugar en la tabla. El sensor se interna al crearse.
+ */
+inline void copiarIdLectura(LecturaParseada& lectura, const char* id, int largo) {
+    lectura.largoId = static_cast<unsigned char>(largo);
+    memcpy(lectura.id, id, largo);
+    lectura.id[largo] = '\0';
+    lectura.identificador = TablaIdentificadores::global().buscar(id, largo);
+}
+
+/**
+ * @brief Parsea una línea y convierte su valor según el tipo
+ * @param linea Inicio de la línea
+ * @param largo Cantidad de caracteres
+ * @param lectura Recibe tipo, ID y valor convertido
+ * @return true si la línea es válida (tipo 'T' o 'P' y valor convertible)
+ */
+inline bool interpretarLinea(const char* linea, int largo, LecturaParseada& lectura) {
+    TramaLectura trama;
+    if (!parsearTrama(linea, largo, trama)) {
+        return false;
+    }
+
+    lectura.tipo = trama.tipo;
+    lectura.decimal = 0.0;
+    lectura.entero = 0;
+    if (trama.tipo == 'T' && !convertirDecimal(trama.valor, lectura.decimal)) {
+        return false;
+    }
+    if (trama.tipo == 'P' && !convertirEntero(trama.valor, lectura.entero)) {
+        return false;
+    }
+    completarValores(trama.tipo, lectura.decimal, lectura.entero);
+
+    copiarIdLectura(lectura, trama.id.inicio, trama.id.largo);
+    return true;
+}
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * @file PoolHilos.h
+ * @brief Grupo fijo de hilos trabajadores con robo de trabajo
+ * @details Reparte los índices 0..total-1 en tramos, uno por hilo. Cada
+ *          hilo consume su tramo por el frente y, cuando se le acaba,
+ *          roba índices del final del tramo de otro hilo.
+ */
+
+#ifndef POOL_HILOS_H
+#define POOL_HILOS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class PoolHilos
+ * @brief Ejecuta una tarea por índice repartiendo el trabajo entre hilos
+ *
+ * CONCEPTO - Robo de trabajo (work stealing):
+ * Repartir en partes iguales no basta cuando unas tareas tardan mucho
+ * más que otras (un sensor con 100.000 lecturas contra uno con 3). El
+ * hilo que termina primero no se queda esperando: toma tareas pendientes
+ * de los demás. El dueño saca desde el frente y el ladrón desde el
+ * final, así casi nunca compiten por el mismo índice.
+ *
+ * RAZÓN de hilos fijos:
+ * Los hilos se crean una sola vez y duermen entre rondas; crear y
+ * destruir hilos en cada procesamiento costaría más que el trabajo
+ * de muchos sensores pequeños.
+ *
+ * USO:
+ *   PoolHilos pool(4);
+ *   pool.ejecutar(n, [&](int i) { procesar(elementos[i]); });
+ */
+class PoolHilos {
+private:
+    /**
+     * @brief Tramo de índices pendientes de un hilo: [inicio, fin)
+     */
+    struct Tramo {
+        std::mutex cerrojo;  ///< Protege inicio y fin
+        int inicio;          ///< Próximo índice para el dueño
+        int fin;             ///< Un índice después del último pendiente
+        char relleno[64];    ///< Separa los cerrojos en líneas de caché distintas
+    };
+
+    int cantidadHilos;
+    std::thread* hilos;
+    Tramo* tramos;
+
+    std::mutex estado;                          ///< Protege ronda, pendientes y cerrando
+    std::condition_variable hayTrabajo;         ///< Despierta a los trabajadores
+    std::condition_variable rondaTerminada;     ///< Despierta a quien llamó ejecutar()
+    unsigned long ronda;                        ///< Aumenta con cada ejecutar()
+    int pendientes;                             ///< Hilos que no terminan la ronda actual
+    bool cerrando;                              ///< true al destruir el pool
+
+    std::function<void(int)> tarea;             ///< Tarea de la ronda actual
+    std::atomic<unsigned long> robadas;         ///< Tareas tomadas de otro hilo
+
+    /**
+     * @brief Toma el siguiente índice: primero el propio, si no, uno ajeno
+     * @param propio Número del hilo que pide trabajo
+     * @param indice Recibe el índice a procesar
+     * @return false si ya no queda trabajo en ningún tramo
+     */
+    bool tomarTarea(int propio, int& indice) {
+        {
+            Tramo& t = tramos[propio];
+            std::lock_guard<std::mutex> guardia(t.cerrojo);
+            if (t.inicio < t.fin) {
+                indice = t.inicio++;
+                return true;
+            }
+        }
+
+        for (int k = 1; k < cantidadHilos; k++) {
+            Tramo& victima = tramos[(propio + k) % cantidadHilos];
+            std::lock_guard<std::mutex> guardia(victima.cerrojo);
+            if (victima.inicio < victima.fin) {
+                indice = --victima.fin;
+                robadas.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Bucle de cada hilo trabajador
+     * @param propio Número del hilo (índice de su tramo)
+     */
+    void trabajar(int propio) {
+        unsigned long rondaVista = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guardia(estado);
+                while (!cerrando && ronda == rondaVista) {
+                    hayTrabajo.wait(guardia);
+                }
+                if (cerrando) {
+                    return;
+                }
+                rondaVista = ronda;
+            }
+
+            int indice;
+            while (tomarTarea(propio, indice)) {
+                tarea(indice);
+            }
+
+            std::lock_guard<std::mutex> guardia(estado);
+            if (--pendientes == 0) {
+                rondaTerminada.notify_one();
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor: crea los hilos, que quedan dormidos
+     * @param numHilos Hilos trabajadores; 0 = uno por núcleo
+     */
+    explicit PoolHilos(int numHilos = 0)
+        : ronda(0), pendientes(0), cerrando(false), robadas(0) {
+        if (numHilos <= 0) {
+            numHilos = static_cast<int>(std::thread::hardware_concurrency());
+        }
+        cantidadHilos = numHilos > 0 ? numHilos : 1;
+        tramos = new Tramo[cantidadHilos];
+        hilos = new std::thread[cantidadHilos];
+        for (int i = 0; i < cantidadHilos; i++) {
+            hilos[i] = std::thread(&PoolHilos::trabajar, this, i);
+        }
+    }
+
+    /**
+     * @brief Destructor: despierta a los hilos para que terminen y los espera
+     */
+    ~PoolHilos() {
+        {
+            std::lock_guard<std::mutex> guardia(estado);
+            cerrando = true;
+        }
+        hayTrabajo.notify_all();
+        for (int i = 0; i < cantidadHilos; i++) {
+            hilos[i].join();
+        }
+        delete[] hilos;
+        delete[] tramos;
+    }
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    /**
+     * @brief Ejecuta tarea(i) para cada i en [0, total) y espera a que terminen
+     * @param total Cantidad de índices
+     * @param f Invocable como f(int); debe poder correr en paralelo consigo mismo
+     *
+     * PROCESO:
+     * 1. Partir [0, total) en un tramo contiguo por hilo
+     * 2. Avanzar la ronda y despertar a los trabajadores
+     * 3. Esperar a que todos declaren que no queda trabajo
+     *
+     * NOTA: Solo un hilo a la vez debe llamar ejecutar().
+     */
+    template <typename Funcion>
+    void ejecutar(int total, Funcion f) {
+        if (total <= 0) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> guardia(estado);
+        tarea = f;
+        for (int i = 0; i < cantidadHilos; i++) {
+            std::lock_guard<std::mutex> guardiaTramo(tramos[i].cerrojo);
+            tramos[i].inicio = static_cast<int>(static_cast<long long>(total) * i / cantidadHilos);
+            tramos[i].fin = static_cast<int>(static_cast<long long>(total) * (i + 1) / cantidadHilos);
+        }
+        pendientes = cantidadHilos;
+        ronda++;
+        hayTrabajo.notify_all();
+
+        while (pendientes > 0) {
+            rondaTerminada.wait(guardia);
+        }
+        tarea = nullptr;
+    }
+
+    /**
+     * @brief Obtiene la cantidad de hilos trabajadores
+     */
+    int obtenerCantidadHilos() const {
+        return cantidadHilos;
+    }
+
+    /**
+     * @brief Tareas que un hilo tomó del tramo de otro (desde que se creó el pool)
+     */
+    unsigned long obtenerRobadas() const {
+        return robadas.load(std::memory_order_relaxed);
+    }
+};
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file PoolNodos.h
+ * @brief Asignadores de nodos para las listas enlazadas del sistema
+ * @details Define un pool por bloques (slab) con lista libre y un asignador
+ *          simple basado en new/delete. ListaSensor y GestorSensores reciben
+ *          el asignador para crear y liberar sus nodos.
+ */
+
+#ifndef POOL_NODOS_H
+#define POOL_NODOS_H
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Asignador trivial que usa new/delete por cada nodo
+ * @tparam N Tipo de nodo a crear
+ *
+ * RAZÓN: Sirve como alternativa al pool cuando se prefiere el
+ * comportamiento original (un 'new' por nodo), por ejemplo para
+ * depurar con herramientas como valgrind.
+ */
+template <typename N>
+class AsignadorHeap {
+public:
+    /**
+     * @brief Crea un nodo en memoria dinámica
+     * @param args Argumentos para el constructor del nodo
+     * @return Puntero al nodo creado
+     */
+    template <typename... Args>
+    N* crear(Args&&... args) {
+        return new N(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Libera un nodo creado con crear()
+     * @param nodo Nodo a liberar
+     */
+    void liberar(N* nodo) {
+        delete nodo;
+    }
+
+    /**
+     * @brief Acepta nodos creados por otro asignador
+     *
+     * NOTA: Con new/delete cualquier nodo se puede liberar desde
+     * cualquier asignador, así que no hay nada que transferir.
+     */
+    void absorber(AsignadorHeap&) {}
+};
+
+/**
+ * @brief Pool de nodos por bloques con lista libre
+ * @tparam N Tipo de nodo a crear
+ * @tparam TAM_BLOQUE Cantidad de nodos por bloque
+ *
+ * CONCEPTO - Slab / Pool:
+ * En lugar de pedir memoria al sistema por cada nodo, pedimos
+ * un bloque grande con espacio para TAM_BLOQUE nodos y los vamos
+ * repartiendo. Los nodos liberados se guardan en una "lista libre"
+ * para reutilizarlos sin volver a llamar a 'new'.
+ *
+ * VENTAJAS:
+ * - Muchas menos llamadas a malloc/free
+ * - Nodos contiguos en memoria: mejor uso de la caché al recorrer
+ * - Al destruir el pool, todos los bloques se liberan de golpe
+ */
+template <typename N, int TAM_BLOQUE = 64>
+class PoolNodos {
+private:
+    /**
+     * @brief Casilla que guarda un nodo o, si está libre, el enlace
+     * a la siguiente casilla libre
+     */
+    union Casilla {
+        Casilla* siguienteLibre;
+        typename std::aligned_storage<sizeof(N), alignof(N)>::type datos;
+    };
+
+    /**
+     * @brief Bloque contiguo de casillas
+     */
+    struct Bloque {
+        Bloque* siguiente;
+        Casilla casillas[TAM_BLOQUE];
+    };
+
+    Bloque* bloques;        ///< Lista de bloques pedidos al sistema
+    Casilla* libres;        ///< Casillas liberadas listas para reutilizar
+    int usadasEnBloque;     ///< Casillas repartidas del bloque más reciente
+
+    /**
+     * @brief Obtiene una casilla sin construir
+     *
+     * PROCESO:
+     * 1. Si hay casillas en la lista libre, tomamos la primera
+     * 2. Si el bloque actual se llenó, pedimos uno nuevo
+     * 3. Repartimos la siguiente casilla del bloque actual
+     */
+    void* obtenerCasilla() {
+        if (libres != nullptr) {
+            Casilla* c = libres;
+            libres = c->siguienteLibre;
+            return c;
+        }
+
+        if (bloques == nullptr || usadasEnBloque == TAM_BLOQUE) {
+            Bloque* nuevo = new Bloque;
+            nuevo->siguiente = bloques;
+            bloques = nuevo;
+            usadasEnBloque = 0;
+        }
+
+        return &bloques->casillas[usadasEnBloque++];
+    }
+
+public:
+    /**
+     * @brief Constructor: el pool empieza sin bloques
+     */
+    PoolNodos() : bloques(nullptr), libres(nullptr), usadasEnBloque(0) {}
+
+    /**
+     * @brief Destructor: libera todos los bloques en bloque
+     *
+     * NOTA: Los nodos deben haberse liberado con liberar() antes,
+     * para que se ejecuten sus destructores.
+     */
+    ~PoolNodos() {
+        while (bloques != nullptr) {
+            Bloque* siguiente = bloques->siguiente;
+            delete bloques;
+            bloques = siguiente;
+        }
+    }
+
+    /**
+     * RAZÓN de prohibir la copia:
+     * Dos pools no pueden ser dueños de los mismos bloques.
+     * Cada lista copiada crea su propio pool.
+     */
+    PoolNodos(const PoolNodos&) = delete;
+    PoolNodos& operator=(const PoolNodos&) = delete;
+
+    /**
+     * @brief Constructor de movimiento: se lleva los bloques de 'otro'
+     *
+     * RAZÓN: Los nodos de una lista viven en los bloques de su pool;
+     * al mover la lista, el pool tiene que viajar con ellos.
+     */
+    PoolNodos(PoolNodos&& otro) noexcept
+        : bloques(otro.bloques), libres(otro.libres), usadasEnBloque(otro.usadasEnBloque) {
+        otro.bloques = nullptr;
+        otro.libres = nullptr;
+        otro.usadasEnBloque = 0;
+    }
+
+    /**
+     * @brief Asignación por movimiento (intercambio: 'otro' libera lo nuestro)
+     */
+    PoolNodos& operator=(PoolNodos&& otro) noexcept {
+        intercambiar(otro);
+        return *this;
+    }
+
+    /**
+     * @brief Intercambia bloques y lista libre con otro pool en O(1)
+     */
+    void intercambiar(PoolNodos& otro) noexcept {
+        std::swap(bloques, otro.bloques);
+        std::swap(libres, otro.libres);
+        std::swap(usadasEnBloque, otro.usadasEnBloque);
+    }
+
+    /**
+     * @brief Adopta todos los bloques de otro pool, con sus nodos vivos
+     * @param otro Pool que queda vacío
+     *
+     * RAZÓN: Permite pasar nodos de una lista a otra sin copiarlos.
+     * Desde aquí, esos nodos se liberan con este pool.
+     *
+     * PROCESO:
+     * 1. Si este pool no tiene bloques, basta con intercambiar
+     * 2. Si no, las casillas nunca repartidas del bloque vigente de
+     *    'otro' pasan a la lista libre (solo se reparte del nuestro)
+     * 3. Los bloques y la lista libre de 'otro' se enganchan a los nuestros
+     *
+     * COMPLEJIDAD: O(1) en el primer caso; si no, proporcional a los
+     * bloques y casillas libres de 'otro', sin construir ningún nodo.
+     */
+    void absorber(PoolNodos& otro) {
+        if (otro.bloques == nullptr) {
+            return;
+        }
+        if (bloques == nullptr) {
+            intercambiar(otro);
+            return;
+        }
+
+        for (int i = otro.usadasEnBloque; i < TAM_BLOQUE; i++) {
+            Casilla* c = &otro.bloques->casillas[i];
+            c->siguienteLibre = otro.libres;
+            otro.libres = c;
+        }
+
+        Bloque* ultimo = otro.bloques;
+        while (ultimo->siguiente != nullptr) {
+            ultimo = ultimo->siguiente;
+        }
+        ultimo->siguiente = bloques->siguiente;
+        bloques->siguiente = otro.bloques;
+
+        if (otro.libres != nullptr) {
+            Casilla* ultimaLibre = otro.libres;
+            while (ultimaLibre->siguienteLibre != nullptr) {
+                ultimaLibre = ultimaLibre->siguienteLibre;
+            }
+            ultimaLibre->siguienteLibre = libres;
+            libres = otro.libres;
+        }
+
+        otro.bloques = nullptr;
+        otro.libres = nullptr;
+        otro.usadasEnBloque = 0;
+    }
+
+    /**
+     * @brief Construye un nodo dentro del pool
+     * @param args Argumentos para el constructor del nodo
+     * @return Puntero al nodo creado
+     */
+    template <typename... Args>
+    N* crear(Args&&... args) {
+        return new (obtenerCasilla()) N(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Destruye un nodo y devuelve su casilla a la lista libre
+     * @param nodo Nodo creado con crear()
+     */
+    void liberar(N* nodo) {
+        nodo->~N();
+        Casilla* c = reinterpret_cast<Casilla*>(nodo);
+        c->siguienteLibre = libres;
+        libres = c;
+    }
+};
+
+#endif
@@ -0,0 +1,488 @@
+/**
+ * @file ProtocoloBinario.h
+ * @brief Tramas binarias compactas entre el ESP32 y el sistema principal
+ * @details Alternativa opcional a las líneas "TIPO,ID,VALOR". El host
+ *          la pide al arrancar; si el ESP32 no responde, se sigue
+ *          usando texto. Ver SimuladorSensores.ino para el emisor.
+ */
+
+#ifndef PROTOCOLO_BINARIO_H
+#define PROTOCOLO_BINARIO_H
+
+#include "ParserTramas.h"
+#include "Metricas.h"
+
+#include <cmath>
+#include <cstring>
+#include <unistd.h>
+
+/**
+ * FORMATO DE TRAMA (todos los enteros en little-endian):
+ *
+ *   +------+------+-----------+-------+-------------+-----------+
+ *   | 0xA5 | tipo | secuencia | largo |    carga    |  CRC-16   |
+ *   |  1 B |  1 B |    2 B    |  1 B  | 'largo' B   |    2 B    |
+ *   +------+------+-----------+-------+-------------+-----------+
+ *
+ * - El CRC cubre desde 'tipo' hasta el final de la carga
+ * - 'secuencia' aumenta en 1 por trama; un salto indica tramas perdidas
+ *
+ * NEGOCIACIÓN:
+ * 1. El host escribe la línea de texto "#BIN <versión>\n"
+ * 2. Si el ESP32 la entiende, responde TRAMA_HOLA con la versión elegida
+ *    (la menor entre ambas) y desde ahí envía solo tramas
+ * 3. Luego envía TRAMA_TABLA: a cada ID le asigna un índice de 1 byte,
+ *    así las lecturas no repiten el texto del ID
+ *
+ * CARGAS:
+ * - TRAMA_HOLA:     [versión]
+ * - TRAMA_TABLA:    repetido [índice][tipo 'T'/'P'][largoId][ID...]
+ * - TRAMA_LECTURAS: repetido [índice][valor 4 B]; float IEEE-754 si el
+ *                   sensor es 'T', entero con signo si es 'P'
+ */
+const unsigned char SINCRONIA_TRAMA = 0xA5;    ///< Primer byte de toda trama
+const unsigned char VERSION_PROTOCOLO = 1;     ///< Versión más alta que entiende el host
+const int CABECERA_TRAMA = 5;                  ///< Sincronía + tipo + secuencia + largo
+const int COLA_TRAMA = 2;                      ///< CRC-16
+const int LARGO_MAXIMO_CARGA = 255;            ///< 'largo' ocupa un byte
+const int BYTES_POR_LECTURA = 5;               ///< Índice + valor
+
+/**
+ * @brief Tipos de trama
+ */
+enum TipoTrama {
+    TRAMA_HOLA = 1,      ///< Respuesta a la negociación
+    TRAMA_TABLA = 2,     ///< Índice -> (tipo, ID)
+    TRAMA_LECTURAS = 3   ///< Una o más lecturas
+};
+
+/**
+ * @brief Tabla de CRC-16/CCITT (polinomio 0x1021), calculada una sola vez
+ *
+ * RAZÓN de la tabla:
+ * El cálculo bit a bit hace 8 desplazamientos y saltos por byte; con
+ * la tabla es una consulta y un XOR, sin ramas.
+ */
+struct TablaCrc16 {
+    unsigned short valores[256];
+
+    TablaCrc16() {
+        for (int i = 0; i < 256; i++) {
+            unsigned short crc = static_cast<unsigned short>(i << 8);
+            for (int b = 0; b < 8; b++) {
+                crc = static_cast<unsigned short>((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+            }
+            valores[i] = crc;
+        }
+    }
+};
+
+/**
+ * @brief CRC-16/CCITT-FALSE (valor inicial 0xFFFF)
+ * @param datos Bytes a cubrir
+ * @param largo Cantidad de bytes
+ * @return CRC; para "123456789" da 0x29B1
+ */
+inline unsigned short calcularCrc16(const unsigned char* datos, int largo) {
+    static const TablaCrc16 tabla;
+    unsigned short crc = 0xFFFF;
+    for (int i = 0; i < largo; i++) {
+        crc = static_cast<unsigned short>((crc << 8) ^ tabla.valores[((crc >> 8) ^ datos[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+/**
+ * @brief Lee un entero de 16 bits little-endian (independiente del procesador)
+ */
+inline unsigned short leerU16(const unsigned char* p) {
+    return static_cast<unsigned short>(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Lee un entero de 32 bits little-endian
+ */
+inline unsigned int leerU32(const unsigned char* p) {
+    return static_cast<unsigned int>(p[0]) | (static_cast<unsigned int>(p[1]) << 8) |
+           (static_cast<unsigned int>(p[2]) << 16) | (static_cast<unsigned int>(p[3]) << 24);
+}
+
+/**
+ * @brief Escribe un entero de 32 bits little-endian
+ */
+inline void escribirU32(unsigned char* p, unsigned int valor) {
+    p[0] = static_cast<unsigned char>(valor);
+    p[1] = static_cast<unsigned char>(valor >> 8);
+    p[2] = static_cast<unsigned char>(valor >> 16);
+    p[3] = static_cast<unsigned char>(valor >> 24);
+}
+
+/**
+ * @brief Arma una trama completa
+ * @param destino Recibe la trama (al menos CABECERA_TRAMA + largo + COLA_TRAMA bytes)
+ * @param tipo Uno de TipoTrama
+ * @param secuencia Número de trama
+ * @param carga Bytes de la carga
+ * @param largo Bytes de la carga (máximo LARGO_MAXIMO_CARGA)
+ * @return Bytes escritos en 'destino'
+ */
+inline int armarTrama(unsigned char* destino, unsigned char tipo, unsigned short secuencia,
+                      const unsigned char* carga, int largo) {
+    destino[0] = SINCRONIA_TRAMA;
+    destino[1] = tipo;
+    destino[2] = static_cast<unsigned char>(secuencia);
+    destino[3] = static_cast<unsigned char>(secuencia >> 8);
+    destino[4] = static_cast<unsigned char>(largo);
+    memcpy(destino + CABECERA_TRAMA, carga, largo);
+
+    unsigned short crc = calcularCrc16(destino + 1, CABECERA_TRAMA - 1 + largo);
+    destino[CABECERA_TRAMA + largo] = static_cast<unsigned char>(crc);
+    destino[CABECERA_TRAMA + largo + 1] = static_cast<unsigned char>(crc >> 8);
+    return CABECERA_TRAMA + largo + COLA_TRAMA;
+}
+
+/**
+ * @class DecodificadorTramas
+ * @brief Convierte los bytes de un puerto en lecturas, sean tramas o texto
+ *
+ * CONCEPTO - Resincronización:
+ * Un 0xA5 solo se toma como inicio de trama si la trama completa
+ * pasa el CRC. Si no, ese byte se trata como texto y la búsqueda
+ * sigue en el siguiente; así un byte perdido cuesta una trama, no
+ * el resto de la conexión.
+ *
+ * TEXTO:
+ * Los bytes fuera de tramas se juntan en líneas y las válidas se
+ * interpretan como "TIPO,ID,VALOR". Un ESP32 sin soporte binario (o
+ * que se reinició y aún no negoció) sigue funcionando.
+ *
+ * NOTA: Hay un decodificador por puerto: la tabla de índices es de
+ * cada ESP32.
+ */
+class DecodificadorTramas {
+public:
+    static const int CAPACIDAD = 4096;   ///< Bytes del buffer de recepción
+    static const int LOTE_SALIDA = 64;   ///< Lecturas entregadas por llamada al manejador
+
+private:
+    /**
+     * @brief Sensor anunciado en TRAMA_TABLA
+     */
+    struct EntradaTabla {
+        char tipo;                       ///< 0 = índice sin anunciar
+        unsigned char largoId;
+        char id[LARGO_MAXIMO_ID + 1];
+        unsigned int identificador;      ///< Internado, o IDENTIFICADOR_DESCONOCIDO si aún no hay sensor
+    };
+
+    int fd;                                  ///< Descriptor del que se lee
+    unsigned char buffer[CAPACIDAD];         ///< Bytes recibidos sin decodificar
+    int pendientes;                          ///< Bytes válidos en 'buffer'
+
+    char texto[LARGO_MAXIMO_ID + 64];        ///< Línea de texto en construcción
+    int largoTexto;
+    bool textoDesbordado;                    ///< La línea actual es demasiado larga
+
+    EntradaTabla tabla[256];                 ///< Índice -> sensor
+    int version;                             ///< 0 = sin negociar
+    unsigned short esperada;                 ///< Secuencia de la próxima trama
+    bool haySecuencia;                       ///< Ya llegó alguna trama numerada
+
+    LecturaParseada salida[LOTE_SALIDA];     ///< Lecturas aún no entregadas
+    int enSalida;
+
+    // Contadores para informar al final
+    unsigned long tramasValidas;
+    unsigned long erroresCrc;
+    unsigned long tramasPerdidas;
+    unsigned long lecturasSinTabla;
+    unsigned long tramasInvalidas;
+
+    /**
+     * @brief Entrega al manejador las lecturas acumuladas
+     */
+    template <typename Manejador>
+    void entregar(Manejador& manejador) {
+        if (enSalida > 0) {
+            manejador(salida, enSalida);
+            enSalida = 0;
+        }
+    }
+
+    /**
+     * @brief Reserva la próxima casilla de 'salida', vaciándola si está llena
+     */
+    template <typename Manejador>
+    LecturaParseada& siguienteSalida(Manejador& manejador) {
+        if (enSalida == LOTE_SALIDA) {
+            entregar(manejador);
+        }
+        return salida[enSalida++];
+    }
+
+    /**
+     * @brief Agrega un byte a la línea de texto; al terminarla, la interpreta
+     */
+    template <typename Manejador>
+    void agregarTexto(unsigned char c, Manejador& manejador) {
+        if (c != '\n' && c != '\r') {
+            if (largoTexto < static_cast<int>(sizeof(texto))) {
+                texto[largoTexto++] = static_cast<char>(c);
+            } else {
+                textoDesbordado = true;
+            }
+            return;
+        }
+
+        if (largoTexto > 0 && !textoDesbordado) {
+            LecturaParseada& lectura = siguienteSalida(manejador);
+            if (!interpretarLinea(texto, largoTexto, lectura)) {
+                enSalida--;  // Mensajes del ESP32 como "[ESP32] Enviado ..."
+            }
+        }
+        largoTexto = 0;
+        textoDesbordado = false;
+    }
+
+    /**
+     * @brief Indica si todas las temperaturas de una trama de lecturas son finitas
+     *
+     * RAZÓN: Los bits del float se toman tal cual. Una trama corrupta
+     * puede pasar el CRC de 16 bits y una placa con fallas puede mandar
+     * NaN o infinito; ninguno debe llegar a EstadisticasLista ni a los
+     * mínimos de NucleosSimd, que asumen que no hay NaN.
+     */
+    bool valoresFinitos(const unsigned char* carga, int largo) const {
+        for (int i = 0; i + BYTES_POR_LECTURA <= largo; i += BYTES_POR_LECTURA) {
+            if (tabla[carga[i]].tipo != 'T') {
+                continue;
+            }
+            unsigned int bits = leerU32(carga + i + 1);
+            float decimal;
+            memcpy(&decimal, &bits, sizeof(decimal));
+            if (!std::isfinite(decimal)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Indica si todas las entradas de una trama de tabla son aceptables
+     *
+     * REGLAS: tipo 'T' o 'P' e ID que cumple idValido, las mismas que
+     * parsearTrama exige a una línea de texto. Sin esto, un tipo 'X'
+     * mandaría cada lectura de ese índice a un sensor que no se puede crear.
+     */
+    static bool tablaValida(const unsigned char* carga, int largo) {
+        int i = 0;
+        while (i + 3 <= largo) {
+            int largoId = carga[i + 2];
+            if (i + 3 + largoId > largo) {
+                return false;
+            }
+            char tipoSensor = static_cast<char>(carga[i + 1]);
+            if ((tipoSensor != 'T' && tipoSensor != 'P') ||
+                !idValido(reinterpret_cast<const char*>(carga + i + 3), largoId)) {
+                return false;
+            }
+            i += 3 + largoId;
+        }
+        return i == largo;
+    }
+
+    /**
+     * @brief Aplica una trama que ya pasó el CRC
+     *
+     * NOTA: Una trama de lecturas con una temperatura no finita, o una
+     * de tabla con una entrada inválida (tablaValida), se descarta
+     * entera y se cuenta en 'tramasInvalidas'; como no avanza la
+     * secuencia, la siguiente la cuenta además como perdida.
+     */
+    template <typename Manejador>
+    void aplicarTrama(unsigned char tipo, unsigned short secuencia,
+                      const unsigned char* carga, int largo, Manejador& manejador) {
+        if ((tipo == TRAMA_LECTURAS && !valoresFinitos(carga, largo)) ||
+            (tipo == TRAMA_TABLA && !tablaValida(carga, largo))) {
+            tramasInvalidas++;
+            return;
+        }
+        tramasValidas++;
+
+        if (tipo == TRAMA_HOLA) {
+            if (largo >= 1 && carga[0] >= 1 && carga[0] <= VERSION_PROTOCOLO) {
+                version = carga[0];
+                haySecuencia = false;
+                for (int i = 0; i < 256; i++) {
+                    tabla[i].tipo = 0;
+                }
+            }
+            return;
+        }
+
+        if (haySecuencia && secuencia != esperada) {
+            tramasPerdidas += static_cast<unsigned short>(secuencia - esperada);
+        }
+        esperada = static_cast<unsigned short>(secuencia + 1);
+        haySecuencia = true;
+
+        if (tipo == TRAMA_TABLA) {
+            // tablaValida ya comprobó cada entrada
+            int i = 0;
+            while (i + 3 <= largo) {
+                int largoId = carga[i + 2];
+                EntradaTabla& entrada = tabla[carga[i]];
+                entrada.tipo = static_cast<char>(carga[i + 1]);
+                entrada.largoId = static_cast<unsigned char>(largoId);
+                memcpy(entrada.id, carga + i + 3, largoId);
+                entrada.id[largoId] = '\0';
+                entrada.identificador = TablaIdentificadores::global().buscar(entrada.id, largoId);
+                i += 3 + largoId;
+            }
+        } else if (tipo == TRAMA_LECTURAS) {
+            // Recorrido de largo fijo: sin separadores que buscar ni números que parsear
+            for (int i = 0; i + BYTES_POR_LECTURA <= largo; i += BYTES_POR_LECTURA) {
+                EntradaTabla& entrada = tabla[carga[i]];
+                if (entrada.tipo == 0) {
+                    lecturasSinTabla++;
+                    continue;
+                }
+                // El sensor se crea con la primera lectura: desde ahí
+                // el identificador queda guardado en la entrada
+                if (entrada.identificador == IDENTIFICADOR_DESCONOCIDO) {
+                    entrada.identificador = TablaIdentificadores::global().buscar(entrada.id, entrada.largoId);
+                }
+
+                unsigned int bits = leerU32(carga + i + 1);
+                float decimal;
+                memcpy(&decimal, &bits, sizeof(decimal));
+                bool esTemperatura = entrada.tipo == 'T';
+
+                LecturaParseada& lectura = siguienteSalida(manejador);
+                lectura.tipo = entrada.tipo;
+                lectura.largoId = entrada.largoId;
+                memcpy(lectura.id, entrada.id, entrada.largoId + 1);
+                lectura.identificador = entrada.identificador;
+                lectura.decimal = esTemperatura ? static_cast<double>(decimal) : 0.0;
+                lectura.entero = esTemperatura ? 0 : static_cast<int>(bits);
+                completarValores(lectura.tipo, lectura.decimal, lectura.entero);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param descriptor Puerto del que se leerá (no se vuelve dueño)
+     */
+    explicit DecodificadorTramas(int descriptor)
+        : fd(descriptor), pendientes(0), largoTexto(0), textoDesbordado(false),
+          version(0), esperada(0), haySecuencia(false), enSalida(0),
+          tramasValidas(0), erroresCrc(0), tramasPerdidas(0), lecturasSinTabla(0), tramasInvalidas(0) {
+        for (int i = 0; i < 256; i++) {
+            tabla[i].tipo = 0;
+        }
+    }
+
+    DecodificadorTramas(const DecodificadorTramas&) = delete;
+    DecodificadorTramas& operator=(const DecodificadorTramas&) = delete;
+
+    /**
+     * @brief Pide al ESP32 que pase al protocolo binario
+     * @return true si la solicitud se escribió completa
+     */
+    bool solicitarBinario() {
+        char solicitud[16];
+        int largo = 0;
+        const char* prefijo = "#BIN ";
+        while (prefijo[largo] != '\0') {
+            solicitud[largo] = prefijo[largo];
+            largo++;
+        }
+        solicitud[largo++] = static_cast<char>('0' + VERSION_PROTOCOLO);
+        solicitud[largo++] = '\n';
+        return write(fd, solicitud, largo) == largo;
+    }
+
+    /**
+     * @brief Lee todo lo disponible que quepa en el buffer
+     * @return Bytes leídos; 0 en fin de archivo; -1 si read() falló
+     */
+    int llenar() {
+        if (pendientes == CAPACIDAD) {
+            // No puede pasar con tramas válidas (miden menos de 300 B): se descarta
+            pendientes = 0;
+        }
+        METRICA_INICIO(inicioLectura);
+        ssize_t n = read(fd, buffer + pendientes, CAPACIDAD - pendientes);
+        METRICA_FIN(ETAPA_LECTURA, inicioLectura);
+        if (n > 0) {
+            pendientes += static_cast<int>(n);
+            METRICA_CONTAR(CONTADOR_BYTES_LEIDOS, static_cast<unsigned long long>(n));
+        }
+        return static_cast<int>(n);
+    }
+
+    /**
+     * @brief Decodifica todo lo recibido y entrega las lecturas por lotes
+     * @tparam Manejador Invocable como manejador(const LecturaParseada* lecturas, int cantidad)
+     * @param manejador Recibe hasta LOTE_SALIDA lecturas por llamada
+     *
+     * PROCESO:
+     * 1. Avanzar byte a byte mientras no aparezca 0xA5 (texto)
+     * 2. Con 0xA5, esperar a tener la trama completa y verificar su CRC
+     * 3. Trama válida: aplicarla y saltarla entera; inválida: el 0xA5 es texto
+     * 4. Conservar al principio del buffer la trama incompleta, si la hay
+     */
+    template <typename Manejador>
+    void decodificar(Manejador manejador) {
+        int i = 0;
+        while (i < pendientes) {
+            unsigned char c = buffer[i];
+            if (c != SINCRONIA_TRAMA) {
+                agregarTexto(c, manejador);
+                i++;
+                continue;
+            }
+
+            if (pendientes - i < CABECERA_TRAMA) {
+                break;
+            }
+            int largo = buffer[i + 4];
+            int total = CABECERA_TRAMA + largo + COLA_TRAMA;
+            if (pendientes - i < total) {
+                break;
+            }
+
+            const unsigned char* trama = buffer + i;
+            unsigned short crc = leerU16(trama + CABECERA_TRAMA + largo);
+            if (calcularCrc16(trama + 1, CABECERA_TRAMA - 1 + largo) != crc) {
+                erroresCrc++;
+                agregarTexto(c, manejador);
+                i++;
+                continue;
+            }
+
+            aplicarTrama(trama[1], leerU16(trama + 2), trama + CABECERA_TRAMA, largo, manejador);
+            i += total;
+        }
+
+        pendientes -= i;
+        memmove(buffer, buffer + i, pendientes);
+        entregar(manejador);
+    }
+
+    /**
+     * @brief Versión negociada
+     * @return 0 si el ESP32 aún no respondió (solo texto)
+     */
+    int obtenerVersion() const { return version; }
+
+    unsigned long obtenerTramasValidas() const { return tramasValidas; }        ///< Tramas con CRC correcto
+    unsigned long obtenerErroresCrc() const { return erroresCrc; }              ///< Candidatas descartadas
+    unsigned long obtenerTramasPerdidas() const { return tramasPerdidas; }      ///< Saltos de secuencia
+    unsigned long obtenerLecturasSinTabla() const { return lecturasSinTabla; }  ///< Índices no anunciados
+    unsigned long obtenerTramasInvalidas() const { return tramasInvalidas; }    ///< NaN/infinito o tabla inválida
+};
+
+#endif
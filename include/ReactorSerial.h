@@ -0,0 +1,264 @@
+/**
+ * @file ReactorSerial.h
+ * @brief Atención de varios puertos seriales desde un solo hilo con epoll
+ * @details Cada puerto registrado tiene su propio LectorLineas. Un único
+ *          epoll_wait() avisa qué puertos tienen datos y se procesan todas
+ *          sus líneas completas, sin un hilo por puerto.
+ */
+
+#ifndef REACTOR_SERIAL_H
+#define REACTOR_SERIAL_H
+
+#include "LectorLineas.h"
+#include "ProtocoloBinario.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <iostream>
+
+/**
+ * @class ReactorSerial
+ * @brief Multiplexa hasta MAX_PUERTOS descriptores en un epoll
+ *
+ * CONCEPTO - Patrón Reactor:
+ * En vez de preguntarle a cada puerto "¿tienes datos?", le pedimos al
+ * sistema operativo que nos despierte cuando alguno los tenga. epoll
+ * devuelve la lista de descriptores listos y solo atendemos esos.
+ *
+ * USO:
+ *   ReactorSerial reactor;
+ *   reactor.agregarPuerto(fd1, "/dev/ttyUSB0");
+ *   reactor.agregarPuerto(fd2, "/dev/ttyUSB1");
+ *   reactor.atender(100, [&](const char* linea, int largo) { ... });
+ *
+ * PROPIEDAD: El reactor cierra los descriptores registrados al destruirse.
+ */
+class ReactorSerial {
+public:
+    static const int MAX_PUERTOS = 32;  ///< Puertos que se pueden registrar
+
+private:
+    /**
+     * @brief Estado de un puerto registrado
+     */
+    struct Puerto {
+        int fd;                 ///< Descriptor abierto
+        const char* nombre;     ///< Ruta, para los mensajes
+        LectorLineas* lector;   ///< Buffer de líneas propio del puerto
+        DecodificadorTramas* decodificador;  ///< Solo en modo binario (activarBinario)
+    };
+
+    int epollFd;                    ///< Descriptor de epoll
+    Puerto puertos[MAX_PUERTOS];    ///< Puertos registrados
+    int cantidad;                   ///< Puertos registrados
+    int activos;                    ///< Puertos que siguen abiertos
+
+    /**
+     * @brief Da de baja un puerto que se cerró o falló
+     */
+    void cerrarPuerto(Puerto& p) {
+        if (p.fd < 0) {
+            return;
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, p.fd, nullptr);
+        close(p.fd);
+        std::cout << "[Reactor] Puerto " << p.nombre << " cerrado.\n";
+        p.fd = -1;
+        activos--;
+    }
+
+public:
+    /**
+     * @brief Constructor: crea el epoll sin puertos
+     */
+    ReactorSerial() : epollFd(epoll_create1(0)), cantidad(0), activos(0) {
+        if (epollFd == -1) {
+            std::cerr << "[Error] No se pudo crear epoll." << std::endl;
+        }
+    }
+
+    /**
+     * @brief Destructor: cierra los puertos y libera los lectores
+     */
+    ~ReactorSerial() {
+        for (int i = 0; i < cantidad; i++) {
+            if (puertos[i].fd >= 0) {
+                close(puertos[i].fd);
+            }
+            delete puertos[i].lector;
+            delete puertos[i].decodificador;
+        }
+        if (epollFd != -1) {
+            close(epollFd);
+        }
+    }
+
+    ReactorSerial(const ReactorSerial&) = delete;
+    ReactorSerial& operator=(const ReactorSerial&) = delete;
+
+    /**
+     * @brief Registra un puerto ya abierto y configurado
+     * @param fd Descriptor del puerto (el reactor pasa a ser su dueño)
+     * @param nombre Ruta del puerto; debe seguir viva mientras exista el reactor
+     * @return true si se registró; si falla, el descriptor se cierra
+     */
+    bool agregarPuerto(int fd, const char* nombre) {
+        if (epollFd == -1 || cantidad == MAX_PUERTOS) {
+            close(fd);
+            return false;
+        }
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u32 = static_cast<unsigned int>(cantidad);
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+            close(fd);
+            return false;
+        }
+
+        puertos[cantidad].fd = fd;
+        puertos[cantidad].nombre = nombre;
+        puertos[cantidad].lector = new LectorLineas(fd);
+        puertos[cantidad].decodificador = nullptr;
+        cantidad++;
+        activos++;
+        return true;
+    }
+
+    /**
+     * @brief Obtiene cuántos puertos siguen abiertos
+     * @return Puertos activos
+     */
+    int puertosActivos() const {
+        return activos;
+    }
+
+    /**
+     * @brief Pasa todos los puertos al protocolo binario (ProtocoloBinario.h)
+     *
+     * Cada puerto recibe su decodificador y se le escribe la solicitud
+     * de negociación. Desde aquí se debe usar atenderTramas en lugar de
+     * atender; un ESP32 que no responda sigue entregando texto.
+     */
+    void activarBinario() {
+        for (int i = 0; i < cantidad; i++) {
+            Puerto& p = puertos[i];
+            if (p.fd < 0 || p.decodificador != nullptr) {
+                continue;
+            }
+            p.decodificador = new DecodificadorTramas(p.fd);
+            if (!p.decodificador->solicitarBinario()) {
+                std::cout << "[Reactor] No se pudo pedir modo binario a " << p.nombre << std::endl;
+            }
+        }
+    }
+
+    /**
+     * @brief Espera datos en cualquier puerto y entrega sus lecturas ya decodificadas
+     * @tparam Manejador Invocable como manejador(const LecturaParseada* lecturas, int cantidad)
+     * @param esperaMs Tiempo máximo de espera en milisegundos
+     * @param manejador Se llama por cada lote de lecturas (tramas o texto)
+     * @return Puertos atendidos en esta vuelta
+     *
+     * NOTA: Requiere activarBinario(). Al negociarse un puerto se avisa una vez.
+     */
+    template <typename Manejador>
+    int atenderTramas(int esperaMs, Manejador manejador) {
+        struct epoll_event eventos[MAX_PUERTOS];
+        int listos = epoll_wait(epollFd, eventos, MAX_PUERTOS, esperaMs);
+        if (listos <= 0) {
+            return 0;
+        }
+
+        for (int e = 0; e < listos; e++) {
+            Puerto& p = puertos[eventos[e].data.u32];
+            if (p.fd < 0 || p.decodificador == nullptr) {
+                continue;
+            }
+
+            int n = p.decodificador->llenar();
+            bool cerrado = n == 0 ||
+                           (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+
+            int versionAntes = p.decodificador->obtenerVersion();
+            p.decodificador->decodificar(manejador);
+            if (p.decodificador->obtenerVersion() != versionAntes) {
+                std::cout << "[Reactor] " << p.nombre << ": protocolo binario v"
+                          << p.decodificador->obtenerVersion() << "\n";
+            }
+
+            if (cerrado) {
+                cerrarPuerto(p);
+            }
+        }
+        return listos;
+    }
+
+    /**
+     * @brief Imprime los contadores de tramas de cada puerto en modo binario
+     */
+    void informarTramas() const {
+        for (int i = 0; i < cantidad; i++) {
+            const DecodificadorTramas* d = puertos[i].decodificador;
+            if (d == nullptr) {
+                continue;
+            }
+            std::cout << "[Reactor] " << puertos[i].nombre
+                      << " | Tramas: " << d->obtenerTramasValidas()
+                      << " | Errores CRC: " << d->obtenerErroresCrc()
+                      << " | Inválidas: " << d->obtenerTramasInvalidas()
+                      << " | Perdidas: " << d->obtenerTramasPerdidas()
+                      << " | Sin tabla: " << d->obtenerLecturasSinTabla() << '\n';
+        }
+    }
+
+    /**
+     * @brief Espera datos en cualquier puerto y entrega sus líneas
+     * @tparam Manejador Invocable como manejador(const char* linea, int largo)
+     * @param esperaMs Tiempo máximo de espera en milisegundos
+     * @param manejador Se llama una vez por cada línea completa recibida
+     * @return Líneas entregadas en esta vuelta
+     *
+     * PROCESO:
+     * 1. epoll_wait() bloquea hasta que algún puerto tenga datos
+     * 2. Para cada puerto listo, leer su bloque (LectorLineas::llenar)
+     * 3. Entregar todas sus líneas completas al manejador
+     * 4. Dar de baja los puertos que se cerraron o fallaron
+     */
+    template <typename Manejador>
+    int atender(int esperaMs, Manejador manejador) {
+        struct epoll_event eventos[MAX_PUERTOS];
+        int listos = epoll_wait(epollFd, eventos, MAX_PUERTOS, esperaMs);
+        if (listos <= 0) {
+            return 0;
+        }
+
+        int entregadas = 0;
+        for (int e = 0; e < listos; e++) {
+            Puerto& p = puertos[eventos[e].data.u32];
+            if (p.fd < 0) {
+                continue;
+            }
+
+            int n = p.lector->llenar();
+            // read() = 0 con EPOLLIN activo significa fin de archivo
+            bool cerrado = n == 0 ||
+                           (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+
+            char* linea;
+            int largo;
+            while (p.lector->siguienteLinea(linea, largo)) {
+                manejador(linea, largo);
+                entregadas++;
+            }
+
+            if (cerrado) {
+                cerrarPuerto(p);
+            }
+        }
+        return entregadas;
+    }
+};
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file Registro.h
+ * @brief Destino y niveles de los mensajes [LOG] de sensores e historiales
+ * @details Por defecto todo va a std::cout. Un hilo puede desviar
+ *          temporalmente sus mensajes a otro flujo (por ejemplo un
+ *          std::ostringstream) sin afectar a los demás hilos. El nivel
+ *          de detalle se fija al compilar con NIVEL_REGISTRO.
+ */
+
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include <iostream>
+
+/**
+ * @brief Niveles de registro, de menos a más detallado
+ */
+#define NIVEL_REGISTRO_NINGUNO      0  ///< Sin mensajes de log
+#define NIVEL_REGISTRO_ERROR        1  ///< Solo errores
+#define NIVEL_REGISTRO_ADVERTENCIA  2  ///< Errores y advertencias
+#define NIVEL_REGISTRO_DETALLE      3  ///< Todo: creación, inserciones, liberaciones
+
+/**
+ * @brief Nivel máximo que se compila
+ *
+ * Se define desde CMake (-DNIVEL_REGISTRO=0 para producción). Los
+ * mensajes de un nivel mayor no generan código: la condición es una
+ * constante y el compilador elimina la rama completa, incluido el
+ * formateo de los valores.
+ */
+#ifndef NIVEL_REGISTRO
+#define NIVEL_REGISTRO NIVEL_REGISTRO_DETALLE
+#endif
+
+/**
+ * @brief Flujo desviado del hilo actual (nullptr = std::cout)
+ *
+ * RAZÓN de thread_local:
+ * Cada hilo trabajador procesa un sensor distinto y guarda su salida
+ * aparte; el desvío de uno no debe cambiar lo que escriben los otros.
+ */
+inline std::ostream*& flujoRegistroDelHilo() {
+    static thread_local std::ostream* flujo = nullptr;
+    return flujo;
+}
+
+/**
+ * @brief Flujo donde deben escribir los mensajes de log
+ * @return El flujo desviado del hilo, o std::cout si no hay desvío
+ */
+inline std::ostream& salidaRegistro() {
+    std::ostream* flujo = flujoRegistroDelHilo();
+    return flujo != nullptr ? *flujo : std::cout;
+}
+
+/**
+ * @class DesvioRegistro
+ * @brief Desvía los mensajes del hilo actual mientras exista el objeto
+ *
+ * USO:
+ *   std::ostringstream texto;
+ *   {
+ *       DesvioRegistro desvio(texto);
+ *       sensor->procesarLectura();   // escribe en 'texto'
+ *   }                                // vuelve al flujo anterior
+ */
+class DesvioRegistro {
+private:
+    std::ostream* anterior;  ///< Flujo que había antes del desvío
+
+public:
+    explicit DesvioRegistro(std::ostream& destino) : anterior(flujoRegistroDelHilo()) {
+        flujoRegistroDelHilo() = &destino;
+    }
+
+    ~DesvioRegistro() {
+        flujoRegistroDelHilo() = anterior;
+    }
+
+    DesvioRegistro(const DesvioRegistro&) = delete;
+    DesvioRegistro& operator=(const DesvioRegistro&) = delete;
+};
+
+/**
+ * @brief Escribe una línea de log si 'nivel' está compilado
+ * @param nivel Uno de los NIVEL_REGISTRO_*
+ * @param mensaje Expresión para operator<< (ej: "Valor: " << x)
+ *
+ * RAZÓN de '\n' y no std::endl:
+ * std::endl vacía el buffer en cada línea (una llamada al sistema por
+ * lectura). El flujo se vacía solo cuando se llena o cuando alguien
+ * lo pide, por ejemplo antes de escribir en std::cerr.
+ */
+#define REGISTRAR(nivel, mensaje)                           \
+    do {                                                    \
+        if ((nivel) <= NIVEL_REGISTRO) {                    \
+            salidaRegistro() << mensaje << '\n';            \
+        }                                                   \
+    } while (0)
+
+#define REGISTRO_ERROR(mensaje)       REGISTRAR(NIVEL_REGISTRO_ERROR, mensaje)
+#define REGISTRO_ADVERTENCIA(mensaje) REGISTRAR(NIVEL_REGISTRO_ADVERTENCIA, mensaje)
+#define REGISTRO_DETALLE(mensaje)     REGISTRAR(NIVEL_REGISTRO_DETALLE, mensaje)
+
+#endif
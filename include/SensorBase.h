@@ -10,7 +10,13 @@
 #define SENSOR_BASE_H
 
 #include <cstring>
-#include <iostream>
+#include <mutex>
+#include <sstream>
+#include "Registro.h"
+#include "EscritorInforme.h"
+#include "SensoresPendientes.h"
+#include "TablaIdentificadores.h"
+#include "VentanasTiempo.h"
 
 
 /**
@@ -33,26 +39,78 @@
 class SensorBase {
 protected:
     /**
-     * @brief Identificador único del sensor
+     * @brief Identificador único del sensor, como texto
      * 
      * RAZÓN del protected:
      * - Las clases hijas pueden accederlo
      * - El mundo exterior NO puede modificarlo directamente
+     *
+     * Apunta al texto internado en TablaIdentificadores::global(); el
+     * sensor no guarda copia propia ni limita el largo del ID.
      */
-    char nombre[50];
-    
+    const char* nombre;
+
+    /**
+     * @brief El mismo ID como número denso (ver TablaIdentificadores.h)
+     */
+    unsigned int identificador;
+
+private:
+    /**
+     * @brief Cerrojo propio del sensor
+     * 
+     * RAZÓN de uno por sensor:
+     * Con varios hilos, agregar lecturas a T-001 no debe frenar a
+     * quien procesa P-105. Solo compiten los hilos del mismo sensor.
+     */
+    mutable std::mutex cerrojo;
+
+    // Seguimiento de cambios (protegido por 'cerrojo', ver marcarCambio)
+    unsigned long long generacion;    ///< Sube con cada lectura agregada
+    bool pendiente;                   ///< true si ya está anotado en 'pendientes'
+    SensoresPendientes* pendientes;   ///< Lista del gestor, o nullptr si no está registrado
+    int posicionRegistro;             ///< Posición en el gestor, para anotarse
+    bool historialGuardado;           ///< true si aún falta traer su historial (FuenteHistorial.h)
+
+protected:
+    /**
+     * @brief Avisa que el sensor recibió lecturas nuevas
+     *
+     * agregarLectura y agregarLecturas lo llaman siempre, después del
+     * guardarLectura(s) de la clase hija: un sensor nuevo no puede
+     * olvidarse de avisar. Solo los métodos de ingreso propios de una
+     * clase hija (adoptarLecturas...) lo llaman por su cuenta.
+     *
+     * COMPLEJIDAD: O(1). Solo la primera lectura después de una pasada
+     * toma el cerrojo de la lista; las demás ven 'pendiente' y salen.
+     *
+     * NOTA: Con el cerrojo del sensor tomado, como el resto de la ingesta.
+     */
+    void marcarCambio() {
+        generacion++;
+        if (!pendiente && pendientes != nullptr) {
+            pendiente = true;
+            pendientes->anotar(posicionRegistro);
+        }
+    }
+
 public:
     /**
      * @brief Constructor que inicializa el nombre del sensor
      * @param id Identificador del sensor (ej: "T-001", "P-105")
      * 
-     * RAZÓN de usar strcpy:
-     * - Copia cadenas de caracteres al estilo C
-     * - strcpy(destino, origen)
+     * RAZÓN de internar en vez de copiar:
+     * - Un sensor no reserva espacio para el nombre más largo posible
+     * - Todos los sensores con el mismo nombre comparten identificador,
+     *   y el gestor los busca comparando enteros
      */
-    SensorBase(const char* id) {
-        strcpy(nombre, id);
-        std::cout << "[SensorBase] Sensor '" << nombre << "' creado" << std::endl;
+    SensorBase(const char* id)
+        : generacion(0), pendiente(false), pendientes(nullptr), posicionRegistro(-1),
+          historialGuardado(false) {
+        TablaIdentificadores& tabla = TablaIdentificadores::global();
+        identificador = tabla.internar(id, static_cast<int>(strlen(id)));
+        nombre = tabla.texto(identificador);
+        REGISTRO_DETALLE("[SensorBase] Sensor '" << nombre << "' creado");
     }
     
     /**
@@ -62,7 +120,7 @@ public:
      * Si una clase tiene métodos virtuales, su destructor DEBE ser virtual.
      */
     virtual ~SensorBase() {
-        std::cout << "[SensorBase] Destructor base llamado para '" << nombre << "'.\n";
+        REGISTRO_DETALLE("[SensorBase] Destructor base llamado para '" << nombre << "'.");
     }
     
     /**
@@ -87,6 +145,28 @@ public:
      * Cada sensor mostrará su información específica
      */
     virtual void imprimirInfo() const = 0;
+
+    /**
+     * @brief Escribe la información del sensor en un informe con buffer
+     * @param salida Escritor que junta todo el listado (ver EscritorInforme.h)
+     * @param opciones Resumen o lecturas completas / últimas N
+     *
+     * RAZÓN de no ser virtual pura: Un sensor que solo sabe imprimirInfo()
+     * sigue apareciendo en los listados; su texto se captura con
+     * DesvioRegistro y se copia al informe tal cual (las opciones no
+     * lo recortan). Los sensores del proyecto la redefinen y escriben
+     * directo en el buffer.
+     */
+    virtual void escribirInforme(EscritorInforme& salida, const OpcionesInforme& opciones) const {
+        (void)opciones;
+        std::ostringstream texto;
+        {
+            DesvioRegistro desvio(texto);
+            imprimirInfo();
+        }
+        const std::string capturado = texto.str();
+        salida.texto(capturado.data(), static_cast<int>(capturado.size()));
+    }
     
     /**
      * @brief Agrega una lectura al sensor
@@ -95,9 +175,127 @@ public:
      * RAZÓN de recibir const char*:
      * - Podemos recibir "45.3" o "80"
      * - La clase hija convierte al tipo correcto, float o int
+     *
+     * PATRÓN - Interfaz no virtual: Los agregarLectura(s) públicos no
+     * son virtuales. Guardan con el guardarLectura(s) de la clase hija
+     * y luego marcan el cambio, así toda lectura (serial, lotes, disco,
+     * demo) deja al sensor pendiente para el próximo procesarTodos.
      */
-    virtual void agregarLectura(const char* valor) = 0;
-    
+    void agregarLectura(const char* valor) {
+        guardarLectura(valor);
+        marcarCambio();
+    }
+
+    /**
+     * @brief Agrega una lectura ya convertida a número decimal
+     * @param valor Valor de la lectura
+     * 
+     * RAZÓN: En la ruta de ingesta el parser ya convirtió el texto;
+     * así evitamos volver a formatear y parsear un string.
+     * Cada sensor lo guarda en su propio tipo (float, int, ...).
+     */
+    void agregarLectura(double valor) {
+        guardarLectura(valor);
+        marcarCambio();
+    }
+
+    /**
+     * @brief Agrega una lectura ya convertida a número entero
+     * @param valor Valor de la lectura
+     */
+    void agregarLectura(int valor) {
+        guardarLectura(valor);
+        marcarCambio();
+    }
+
+    /**
+     * @brief Agrega un lote de lecturas decimales, en orden
+     * @param valores Primera lectura del lote
+     * @param cantidad Lecturas del lote
+     *
+     * RAZÓN: Con una ráfaga de líneas para el mismo sensor, el gestor
+     * paga una búsqueda, un cerrojo y un despacho por lote, no por
+     * lectura. El cambio se marca una vez por lote.
+     */
+    void agregarLecturas(const double* valores, int cantidad) {
+        guardarLecturas(valores, cantidad);
+        marcarCambio();
+    }
+
+    /**
+     * @brief Agrega un lote de lecturas enteras, en orden
+     * @param valores Primera lectura del lote
+     * @param cantidad Lecturas del lote
+     */
+    void agregarLecturas(const int* valores, int cantidad) {
+        guardarLecturas(valores, cantidad);
+        marcarCambio();
+    }
+
+protected:
+    /**
+     * @brief Guarda una lectura en texto en el historial (lo implementa cada sensor)
+     *
+     * NOTA: Ni esta ni las demás guardarLectura(s) marcan el cambio; de
+     * eso se encarga el agregarLectura(s) público que las llama.
+     */
+    virtual void guardarLectura(const char* valor) = 0;
+
+    /**
+     * @brief Guarda una lectura decimal en el historial (lo implementa cada sensor)
+     */
+    virtual void guardarLectura(double valor) = 0;
+
+    /**
+     * @brief Guarda una lectura entera
+     * 
+     * Por defecto se trata como decimal; los sensores enteros
+     * lo sobrescriben para guardarlo sin conversión.
+     */
+    virtual void guardarLectura(int valor) {
+        guardarLectura(static_cast<double>(valor));
+    }
+
+    /**
+     * @brief Guarda un lote decimal
+     *
+     * Por defecto se guarda una a una; los sensores concretos lo
+     * sobrescriben para insertar en bloque en su historial.
+     */
+    virtual void guardarLecturas(const double* valores, int cantidad) {
+        for (int i = 0; i < cantidad; i++) {
+            guardarLectura(valores[i]);
+        }
+    }
+
+    /**
+     * @brief Guarda un lote entero (por defecto, una a una)
+     */
+    virtual void guardarLecturas(const int* valores, int cantidad) {
+        for (int i = 0; i < cantidad; i++) {
+            guardarLectura(valores[i]);
+        }
+    }
+
+public:
+    /**
+     * @brief Resume las lecturas recibidas en los últimos segundos
+     * @param segundos Largo de la ventana (ej: 60, 300, 3600)
+     * @return Cantidad, media, mínimo y máximo; cantidad 0 si no hay datos
+     *
+     * RAZÓN de no ser virtual pura: Un sensor propio sin resúmenes por
+     * tiempo sigue compilando y simplemente informa una ventana vacía.
+     * Los sensores concretos responden desde sus cubetas (VentanasTiempo),
+     * sin recorrer el historial. Tomar obtenerCerrojo() alrededor.
+     *
+     * NOTA: Cuenta lo que llegó en la ventana, aunque procesarLectura
+     * haya eliminado después alguna de esas lecturas del historial.
+     */
+    virtual ResumenVentana consultarVentana(int segundos) const {
+        (void)segundos;
+        return ResumenVentana();
+    }
+
     /**
      * @brief Obtiene el nombre del sensor
      * @return Puntero al nombre
@@ -108,6 +306,92 @@ public:
     const char* obtenerNombre() const {
         return nombre;
     }
+
+    /**
+     * @brief Obtiene el identificador internado del sensor
+     * @return Número denso; igual al de cualquier otro sensor con el mismo nombre
+     */
+    unsigned int obtenerIdentificador() const {
+        return identificador;
+    }
+
+    /**
+     * @brief Obtiene el cerrojo que protege las lecturas del sensor
+     * @return Referencia al mutex del sensor
+     * 
+     * USO: tomarlo alrededor de agregarLectura, procesarLectura o
+     * imprimirInfo cuando varios hilos comparten el sensor.
+     *   std::lock_guard<std::mutex> guardia(sensor->obtenerCerrojo());
+     */
+    std::mutex& obtenerCerrojo() const {
+        return cerrojo;
+    }
+
+    /**
+     * @brief Cantidad de cambios recibidos desde que se creó el sensor
+     * @return Contador que solo crece; dos valores iguales = sin lecturas nuevas
+     *
+     * USO: Quien guarda un resultado derivado (un reporte, un promedio)
+     * anota la generación y lo recalcula solo si cambió.
+     */
+    unsigned long long obtenerGeneracion() const {
+        return generacion;
+    }
+
+    /**
+     * @brief Conecta el sensor con la lista de pendientes de su gestor
+     * @param lista Lista donde anotarse al cambiar
+     * @param posicion Posición del sensor en el registro del gestor
+     *
+     * Si el sensor ya traía lecturas (p. ej., cargadas antes de
+     * registrarlo) se anota en el momento. Lo llama GestorSensores.
+     */
+    void vincularPendientes(SensoresPendientes* lista, int posicion) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        pendientes = lista;
+        posicionRegistro = posicion;
+        if (generacion > 0 && !pendiente) {
+            pendiente = true;
+            lista->anotar(posicion);
+        }
+    }
+
+    /**
+     * @brief Marca el sensor como al día, antes de procesarlo
+     * @return true si estaba anotado (tenía lecturas sin procesar)
+     *
+     * NOTA: Con el cerrojo del sensor tomado. Lo que llegue después
+     * vuelve a anotarlo para la próxima pasada.
+     */
+    bool limpiarPendiente() {
+        bool estaba = pendiente;
+        pendiente = false;
+        return estaba;
+    }
+
+    /**
+     * @brief Avisa que el sensor tiene un historial guardado sin traer
+     *
+     * Cuenta como un cambio: la primera pasada de proceso lo visita
+     * aunque no reciba lecturas nuevas, igual que si el historial ya
+     * estuviera en memoria. Se llama antes de registrarlo.
+     */
+    void marcarHistorialGuardado() {
+        historialGuardado = true;
+        marcarCambio();
+    }
+
+    /**
+     * @brief Consulta y borra la marca de marcarHistorialGuardado
+     * @return true solo la primera vez: quien llama debe hidratarlo
+     *
+     * NOTA: Con el cerrojo del sensor tomado.
+     */
+    bool tomarHistorialGuardado() {
+        bool estaba = historialGuardado;
+        historialGuardado = false;
+        return estaba;
+    }
 };
 
 #endif
\ No newline at end of file
@@ -8,41 +8,70 @@
 #define SENSOR_PRESION_H
 
 #include "SensorBase.h"
-#include "ListaSensor.h"
+#include "ListaSensorBloques.h"
+#include "HistorialCircular.h"
+#include <utility>
 
 // para convertir de string a int
-#include <cstdlib> 
+#include "ParserTramas.h"
 
 /**
- * @class SensorPresion
+ * @class SensorPresionCon
  * @brief Sensor que maneja presiones en formato enteros
+ * @tparam Historial Contenedor de lecturas int (ver SensorTemperaturaCon)
  * 
  * DIFERENCIAS CON SensorTemperatura:
- * - Usa ListaSensor<int> en lugar de ListaSensor<float>
+ * - Usa un historial de int en lugar de float
  * - El procesamiento es diferente, cuando promedia no elimina al chiquita
  * 
  * VENTAJA DEL POLIMORFISMO:
  * Ambos sensores tienen la misma interfaz pero comportamientos distintos. 
  * El código cliente no necesita saber cuál es cuál
+ * 
+ * Es 'final' igual que SensorTemperaturaCon, para el mismo despacho directo.
  */
 
-class SensorPresion : public SensorBase {
+template <typename Historial>
+class SensorPresionCon final : public SensorBase {
 private:
     /**
      * @brief Lista enlazada que almacena lecturas de presión
      * 
      * RAZÓN de usar int:
      * - Las presiones suelen medirse en valores enteros
+     * - Se guarda por bloques igual que en SensorTemperatura
+     */
+    Historial historial;
+
+    /**
+     * @brief Cubetas de resumen por tiempo, como en SensorTemperaturaCon
+     */
+    VentanasTiempo<int> ventanas;
+
+    /**
+     * @brief Suma a las cubetas las lecturas de un lote que trae sus marcas
+     *
+     * NOTA: Solo la última hora puede caer en alguna cubeta.
      */
-    ListaSensor<int> historial;
+    template <typename Lote>
+    void sumarAVentanas(const Lote& lote) {
+        VentanasTiempo<int>& destino = ventanas;
+        lote.recorrerDesde(relojMonotonicoMs() - 3600000LL, [&destino](long long marca, int valor) {
+            destino.agregar(valor, marca);
+        });
+    }
     
 public:
     /**
      * @brief Constructor del sensor de presión
      * @param id Identificador único del sensor
+     * @param args Parámetros opcionales para el historial, o un
+     *        historial ya lleno pasado con std::move (se adopta sin copiarlo)
      */
-    SensorPresion(const char* id) : SensorBase(id) {
-        std::cout << "[SensorPresion] Sensor de presión '" << nombre << "' inicializado." << std::endl;
+    template <typename... Args>
+    explicit SensorPresionCon(const char* id, Args&&... args)
+        : SensorBase(id), historial(std::forward<Args>(args)...) {
+        REGISTRO_DETALLE("[SensorPresion] Sensor de presión '" << nombre << "' inicializado.");
     }
     
     /**
@@ -52,26 +81,112 @@ public:
      * de 'historial' se llama automáticamente, liberando
      * todos los nodos de la lista.
      */
-    ~SensorPresion() {
-        std::cout << "  [Destructor Sensor " << nombre << "] Liberando Lista Interna..." << std::endl;
+    ~SensorPresionCon() {
+        REGISTRO_DETALLE("  [Destructor Sensor " << nombre << "] Liberando Lista Interna...");
     }
     
+protected:
     /**
-     * @brief Agrega una lectura de presión
+     * @brief Guarda una lectura de presión
      * @param valor String con el valor entero
      * 
-     * RAZÓN de usar atoi():
-     * - atoi = ASCII to Integer
-     * - Convierte "1013" (char*) → 1013 (int)
+     * RAZÓN de usar convertirEntero():
+     * - Convierte "1013" (char*) → 1013 (int), como atoi
+     * - No depende del locale; un texto inválido se guarda como 0
      * 
      */
-    void agregarLectura(const char* valor) override {
+    void guardarLectura(const char* valor) override {
         // String a entero
-        int presion = atoi(valor); 
-        historial.insertarAlFinal(presion);
-        std::cout << "[SensorPresion " << nombre << "] Lectura agregada: " << presion << " hPa" << std::endl;
+        int presion = 0;
+        convertirEntero(Rebanada(valor, static_cast<int>(strlen(valor))), presion);
+        guardarLectura(presion);
+    }
+
+    /**
+     * @brief Guarda una lectura de presión ya convertida
+     * @param valor Presión en hPa
+     */
+    void guardarLectura(int valor) override {
+        long long marca = relojMonotonicoMs();
+        historial.insertarAlFinal(valor, marca);
+        ventanas.agregar(valor, marca);
+        REGISTRO_DETALLE("[SensorPresion " << nombre << "] Lectura agregada: " << valor << " hPa");
+    }
+
+    /**
+     * @brief Guarda una lectura decimal, truncada a entero como atoi
+     * @param valor Presión en hPa
+     */
+    void guardarLectura(double valor) override {
+        guardarLectura(static_cast<int>(valor));
+    }
+
+    /**
+     * @brief Guarda un lote de presiones con una sola inserción en bloque
+     * @param valores Presiones en hPa, en orden de llegada
+     * @param cantidad Lecturas del lote
+     */
+    void guardarLecturas(const int* valores, int cantidad) override {
+        long long marca = relojMonotonicoMs();
+        historial.insertarVarios(valores, cantidad, marca);
+        ventanas.agregarVarios(valores, cantidad, marca);
+        REGISTRO_DETALLE("[SensorPresion " << nombre << "] " << cantidad << " lectura(s) agregadas en lote");
+    }
+
+    /**
+     * @brief Guarda un lote decimal, truncando cada valor como guardarLectura(double)
+     */
+    void guardarLecturas(const double* valores, int cantidad) override {
+        long long marca = relojMonotonicoMs();
+        historial.insertarVarios(valores, cantidad, marca);
+        ventanas.agregarVarios(valores, cantidad, marca);
+        REGISTRO_DETALLE("[SensorPresion " << nombre << "] " << cantidad << " lectura(s) agregadas en lote");
+    }
+
+public:
+
+    /**
+     * @brief Agrega al final todas las lecturas de un lote, sin copiarlas
+     * @param lote Historial del mismo tipo; queda vacío
+     *
+     * USO: Un buffer de ingreso acumula lecturas fuera del cerrojo del
+     * sensor y las entrega de una vez (ver empalmarAlFinal del historial).
+     */
+    void adoptarLecturas(Historial& lote) {
+        int cantidad = lote.obtenerTamaño();
+        sumarAVentanas(lote);
+        historial.empalmarAlFinal(lote);
+        marcarCambio();
+        REGISTRO_DETALLE("[SensorPresion " << nombre << "] " << cantidad << " lectura(s) adoptadas");
+    }
+
+    /**
+     * @brief Agrega las lecturas de un lote ANTES de las que ya tiene
+     * @param lote ListaSensorBloques<int> más vieja que el historial
+     *        actual; queda vacía
+     *
+     * USO: Al hidratar desde disco (AlmacenSegmentos) las lecturas
+     * guardadas son anteriores a las que llegaron desde el arranque.
+     * El historial las antepone (Historial::anteponer): sin copiar si
+     * es por bloques, respetando capacidad y ventana si es acotado.
+     */
+    template <typename Lote>
+    void adoptarAnteriores(Lote& lote) {
+        int cantidad = lote.obtenerTamaño();
+        sumarAVentanas(lote);
+        historial.anteponer(lote);
+        marcarCambio();
+        REGISTRO_DETALLE("[SensorPresion " << nombre << "] " << cantidad << " lectura(s) anteriores adoptadas");
     }
     
+    /**
+     * @brief Resumen de la ventana desde las cubetas, en O(61) como máximo
+     * @param segundos Largo de la ventana
+     */
+    ResumenVentana consultarVentana(int segundos) const override {
+        return ventanas.resumir(segundos * 1000LL, relojMonotonicoMs());
+    }
+
     /**
      * @brief Procesa las lecturas calculando el promedio
      * 
@@ -87,30 +202,57 @@ public:
      * de procesamiento, pero se acceden de forma uniforme.
      */
     void procesarLectura() override {
-        std::cout << "\n-> Procesando Sensor " << nombre << "...";
+        salidaRegistro() << "\n-> Procesando Sensor " << nombre << "...";
         
         // Si no hay registros
         if (historial.estaVacia()) {
-            std::cout << "[SensorPresion] No hay lecturas para procesar." << std::endl;
+            salidaRegistro() << "[SensorPresion] No hay lecturas para procesar.\n";
             return;
         }
         
         int promedio = historial.calcularPromedio();
-        std::cout << "[Sensor Presion] Promedio calculado sobre " << historial.obtenerTamaño() 
-                  << " lectura(s): " << promedio << " hPa." << std::endl;
+        salidaRegistro() << "[Sensor Presion] Promedio calculado sobre " << historial.obtenerTamaño() 
+                  << " lectura(s): " << promedio << " hPa.\n";
     }
     
     /**
      * @brief Imprime información detallada del sensor
      */
     void imprimirInfo() const override {
-        std::cout << "\n=== Sensor de Presión ===" << std::endl;
-        std::cout << "ID: " << nombre << std::endl;
-        std::cout << "Tipo: Presión (int)" << std::endl;
-        std::cout << "Lecturas almacenadas: " << historial.obtenerTamaño() << std::endl;
-        historial.imprimir();
-        std::cout << "=========================" << std::endl;
+        EscritorInforme salida(salidaRegistro(), 4096);
+        escribirInforme(salida, OpcionesInforme());
+    }
+
+    /**
+     * @brief Mismo texto que imprimirInfo(), escrito en el buffer del informe
+     *
+     * Con opciones.soloResumen la lista se reemplaza por una línea con
+     * promedio, mínimo y máximo.
+     */
+    void escribirInforme(EscritorInforme& salida, const OpcionesInforme& opciones) const override {
+        salida << "\n=== Sensor de Presión ===\n";
+        salida << "ID: " << nombre << '\n';
+        salida << "Tipo: Presión (int)\n";
+        salida << "Lecturas almacenadas: " << historial.obtenerTamaño() << '\n';
+        if (!opciones.soloResumen) {
+            historial.escribir(salida, opciones.maximoLecturas);
+        } else if (historial.obtenerTamaño() > 0) {
+            const EstadisticasLista<int>& e = historial.obtenerEstadisticas();
+            salida << "Promedio: " << historial.calcularPromedio() << " hPa  Mín: "
+                   << e.obtenerMinimo() << " hPa  Máx: " << e.obtenerMaximo() << " hPa\n";
+        }
+        salida << "=========================\n";
     }
 };
 
+/**
+ * @brief Sensor de presión con historial sin límite (por bloques)
+ */
+typedef SensorPresionCon<ListaSensorBloques<int> > SensorPresion;
+
+/**
+ * @brief Sensor de presión con historial acotado (capacidad, ventana en s)
+ */
+typedef SensorPresionCon<HistorialCircular<int> > SensorPresionAcotado;
+
 #endif
\ No newline at end of file
@@ -8,12 +8,20 @@
 #define SENSOR_TEMPERATURA_H
 
 #include "SensorBase.h"
-#include "ListaSensor.h"
-#include <cstdlib>  // Para convertir string a float
+#include "ListaSensorBloques.h"
+#include "HistorialCircular.h"
+#include "ParserTramas.h"  // Para convertir string a float
+#include <utility>
 
 /**
- * @class SensorTemperatura
+ * @class SensorTemperaturaCon
  * @brief Sensor que maneja temperaturas en formato float
+ * @tparam Historial Contenedor de lecturas (ListaSensorBloques<float>,
+ *         HistorialCircular<float>, ...)
+ * 
+ * RAZÓN del parámetro Historial:
+ * Permite elegir por sensor entre un historial sin límite y uno acotado,
+ * sin duplicar la lógica de procesamiento. Ver los typedef al final.
  * 
  * Hereda:
  * - El atributo 'nombre'
@@ -24,27 +32,57 @@
  * - imprimirInfo()
  * - agregarLectura()
  * 
+ * RAZÓN del 'final':
+ * Nadie hereda de este sensor, y decirlo permite al compilador llamar
+ * directo (sin tabla virtual) a los métodos cuando conoce el tipo,
+ * por ejemplo desde GestorSensores::visitarSensor.
  */
 
-class SensorTemperatura : public SensorBase {
+template <typename Historial>
+class SensorTemperaturaCon final : public SensorBase {
 private:
     /**
      * @brief Lista enlazada que almacena las lecturas de temperatura
      * 
-     * RAZÓN de usar ListaSensor<float>:
+     * RAZÓN de usar float:
      * - Las temperaturas son decimales
      * - Necesitamos precisión decimal, por eso float
      * 
+     * RAZÓN de la versión por bloques:
+     * - Misma interfaz que ListaSensor, pero 64 valores contiguos por nodo
+     * - calcularPromedio y eliminarMinimo recorren memoria seguida
+     * 
      * RAZÓN de ser private:
      * - Solo esta clase debe manipular su lista interna
      * - Encapsulamiento
      */
-    ListaSensor<float> historial;
+    Historial historial;
+
+    /**
+     * @brief Cubetas de resumen por tiempo (último minuto, 5 min, hora)
+     */
+    VentanasTiempo<float> ventanas;
+
+    /**
+     * @brief Suma a las cubetas las lecturas de un lote que trae sus marcas
+     *
+     * NOTA: Solo la última hora puede caer en alguna cubeta.
+     */
+    template <typename Lote>
+    void sumarAVentanas(const Lote& lote) {
+        VentanasTiempo<float>& destino = ventanas;
+        lote.recorrerDesde(relojMonotonicoMs() - 3600000LL, [&destino](long long marca, float valor) {
+            destino.agregar(valor, marca);
+        });
+    }
     
 public:
     /**
      * @brief Constructor que inicializa el sensor
      * @param id Identificador del sensor
+     * @param args Parámetros opcionales para el historial
+     *        (ej: capacidad y ventana de un HistorialCircular), o un
+     *        historial ya lleno pasado con std::move (se adopta sin copiarlo)
      * 
      * SINTAXIS 'SensorBase(id)':
      * Esto se llama "lista de inicialización de constructor"
@@ -56,8 +94,12 @@ public:
      * 2. Se construye el historial
      * 3. Se ejecuta el cuerpo del constructor
      */
-    SensorTemperatura(const char* id) : SensorBase(id) {
-        std::cout << "[SensorTemp] Sensor de temperatura '" << nombre << "' inicializado." << std::endl;
+    template <typename... Args>
+    explicit SensorTemperaturaCon(const char* id, Args&&... args)
+        : SensorBase(id), historial(std::forward<Args>(args)...) {
+        // procesarLectura elimina mínimos seguido: mantenemos el índice
+        historial.activarIndiceMinimo();
+        REGISTRO_DETALLE("[SensorTemp] Sensor de temperatura '" << nombre << "' inicializado.");
     }
     
     /**
@@ -65,34 +107,103 @@ public:
      * 
      * PROCESO DE DESTRUCCIÓN:
      * 1. Se ejecuta este destructor
-     * 2. Se destruye "historial" -> llama a ~ListaSensor<float>()
+     * 2. Se destruye "historial" -> llama al destructor del Historial
      * 3. Se llama a ~SensorBase()
      * 
      * RAZÓN de imprimir logs:
      * - Para verificar que la memoria se libera correctamente
      * - Para que yo entienda mejor mi codigo :3
      */
-    ~SensorTemperatura() {
-        std::cout << "\t[Destructor Sensor " << nombre << "] Liberando Lista Interna..." << std::endl;
+    ~SensorTemperaturaCon() {
+        REGISTRO_DETALLE("\t[Destructor Sensor " << nombre << "] Liberando Lista Interna...");
     }
     
+protected:
     /**
-     * @brief Agrega una lectura de temperatura a la lista
+     * @brief Guarda una lectura de temperatura en la lista
      * @param valor String con el valor
      * 
-     * RAZÓN de usar atof():
-     * - atof = ASCII to Float
-     * - Convierte por ejemplo "23.5" (char*) -> 23.5 (float)
+     * RAZÓN de usar convertirDecimal() en lugar de atof():
+     * - Convierte por ejemplo "23.5" (char*) -> 23.5 sin depender del locale
+     * - Un texto inválido se guarda como 0, igual que con atof
      */
-
-    
-    void agregarLectura(const char* valor) override {
+    void guardarLectura(const char* valor) override {
         // Convertir string a float
-        float temp = atof(valor);  
-        historial.insertarAlFinal(temp);
-        std::cout << "[SensorTemp " << nombre << "] Lectura agregada: " << temp << "°C" << std::endl;
+        double temp = 0.0;
+        convertirDecimal(Rebanada(valor, static_cast<int>(strlen(valor))), temp);
+        guardarLectura(temp);
+    }
+
+    /**
+     * @brief Guarda una lectura de temperatura ya convertida
+     * @param valor Temperatura en °C
+     */
+    void guardarLectura(double valor) override {
+        float temp = static_cast<float>(valor);
+        long long marca = relojMonotonicoMs();
+        historial.insertarAlFinal(temp, marca);
+        ventanas.agregar(temp, marca);
+        REGISTRO_DETALLE("[SensorTemp " << nombre << "] Lectura agregada: " << temp << "°C");
+    }
+
+    /**
+     * @brief Guarda un lote de temperaturas con una sola inserción en bloque
+     * @param valores Temperaturas en °C, en orden de llegada
+     * @param cantidad Lecturas del lote
+     */
+    void guardarLecturas(const double* valores, int cantidad) override {
+        long long marca = relojMonotonicoMs();
+        historial.insertarVarios(valores, cantidad, marca);
+        ventanas.agregarVarios(valores, cantidad, marca);
+        REGISTRO_DETALLE("[SensorTemp " << nombre << "] " << cantidad << " lectura(s) agregadas en lote");
+    }
+
+public:
+
+    /**
+     * @brief Agrega al final todas las lecturas de un lote, sin copiarlas
+     * @param lote Historial del mismo tipo; queda vacío
+     *
+     * USO: Un buffer de ingreso acumula lecturas fuera del cerrojo del
+     * sensor y las entrega de una vez (ver empalmarAlFinal del historial).
+     */
+    void adoptarLecturas(Historial& lote) {
+        int cantidad = lote.obtenerTamaño();
+        sumarAVentanas(lote);
+        historial.empalmarAlFinal(lote);
+        marcarCambio();
+        REGISTRO_DETALLE("[SensorTemp " << nombre << "] " << cantidad << " lectura(s) adoptadas");
+    }
+
+    /**
+     * @brief Agrega las lecturas de un lote ANTES de las que ya tiene
+     * @param lote ListaSensorBloques<float> más vieja que el historial
+     *        actual; queda vacía
+     *
+     * USO: Al hidratar desde disco (AlmacenSegmentos) las lecturas
+     * guardadas son anteriores a las que llegaron desde el arranque.
+     * El historial las antepone (Historial::anteponer): sin copiar si
+     * es por bloques, respetando capacidad y ventana si es acotado.
+     */
+    template <typename Lote>
+    void adoptarAnteriores(Lote& lote) {
+        int cantidad = lote.obtenerTamaño();
+        sumarAVentanas(lote);
+        // El lote no trae el índice de mínimos que procesarLectura necesita
+        lote.activarIndiceMinimo();
+        historial.anteponer(lote);
+        marcarCambio();
+        REGISTRO_DETALLE("[SensorTemp " << nombre << "] " << cantidad << " lectura(s) anteriores adoptadas");
     }
     
+    /**
+     * @brief Resumen de la ventana desde las cubetas, en O(61) como máximo
+     * @param segundos Largo de la ventana
+     */
+    ResumenVentana consultarVentana(int segundos) const override {
+        return ventanas.resumir(segundos * 1000LL, relojMonotonicoMs());
+    }
+
     /**
      * @brief Procesa las lecturas: elimina mínimo y calcula promedio
      * 
@@ -106,24 +217,24 @@ public:
      * fallos del sensor, por eso las filtramos.
      */
     void procesarLectura() override {
-        std::cout << "\n-> Procesando Sensor " << nombre << "..." << std::endl;
+        salidaRegistro() << "\n-> Procesando Sensor " << nombre << "...\n";
         
         // Si no hay nada solo retornamos
         if (historial.estaVacia()) {
-            std::cout << "[SensorTemp] No hay lecturas para procesar." << std::endl;
+            salidaRegistro() << "[SensorTemp] No hay lecturas para procesar.\n";
             return;
         }
 
         // Si hay mas de de un registro se elimina al mas chiquito
         if (historial.obtenerTamaño() > 1) {
             float minimo = historial.eliminarMinimo();
-            std::cout << "[Sensor Temp] Lectura más baja (" << minimo << "°C) eliminada." << std::endl;
+            salidaRegistro() << "[Sensor Temp] Lectura más baja (" << minimo << "°C) eliminada.\n";
             return;
         }
         
         float promedio = historial.calcularPromedio();
-        std::cout << "[Sensor Temp] Promedio calculado sobre " 
-                  << historial.obtenerTamaño() << " lectura(s): "  << promedio << "°C." << std::endl;
+        salidaRegistro() << "[Sensor Temp] Promedio calculado sobre " 
+                  << historial.obtenerTamaño() << " lectura(s): "  << promedio << "°C.\n";
     }
     
     /**
@@ -134,13 +245,43 @@ public:
      * - Puede ser llamado en objetos const
      */
     void imprimirInfo() const override {
-        std::cout << "\n=== Sensor de Temperatura ===\n";
-        std::cout << "ID: " << nombre << std::endl;
-        std::cout << "Tipo: Temperatura (float)" << std::endl;
-        std::cout << "Lecturas almacenadas: " << historial.obtenerTamaño() << std::endl;
-        historial.imprimir();
-        std::cout << "============================\n";
+        EscritorInforme salida(salidaRegistro(), 4096);
+        escribirInforme(salida, OpcionesInforme());
+    }
+
+    /**
+     * @brief Mismo texto que imprimirInfo(), escrito en el buffer del informe
+     *
+     * Con opciones.soloResumen la lista se reemplaza por una línea con
+     * promedio, mínimo y máximo (O(1): salen de las estadísticas).
+     */
+    void escribirInforme(EscritorInforme& salida, const OpcionesInforme& opciones) const override {
+        salida << "\n=== Sensor de Temperatura ===\n";
+        salida << "ID: " << nombre << '\n';
+        salida << "Tipo: Temperatura (float)\n";
+        salida << "Lecturas almacenadas: " << historial.obtenerTamaño() << '\n';
+        if (!opciones.soloResumen) {
+            historial.escribir(salida, opciones.maximoLecturas);
+        } else if (historial.obtenerTamaño() > 0) {
+            const EstadisticasLista<float>& e = historial.obtenerEstadisticas();
+            salida << "Promedio: " << historial.calcularPromedio() << "°C  Mín: "
+                   << e.obtenerMinimo() << "°C  Máx: " << e.obtenerMaximo() << "°C\n";
+        }
+        salida << "============================\n";
     }
 };
 
+/**
+ * @brief Sensor de temperatura con historial sin límite (por bloques)
+ */
+typedef SensorTemperaturaCon<ListaSensorBloques<float> > SensorTemperatura;
+
+/**
+ * @brief Sensor de temperatura con historial acotado
+ * 
+ * Ejemplo: new SensorTemperaturaAcotado("T-001", 3600, 600)
+ * conserva como máximo 3600 lecturas de los últimos 10 minutos.
+ */
+typedef SensorTemperaturaCon<HistorialCircular<float> > SensorTemperaturaAcotado;
+
 #endif
\ No newline at end of file
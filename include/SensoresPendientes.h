@@ -0,0 +1,89 @@
+/**
+ * @file SensoresPendientes.h
+ * @brief Lista de sensores con lecturas nuevas desde la última pasada
+ * @details La llena cada sensor al cambiar (SensorBase::marcarCambio) y
+ *          la vacía GestorSensores::procesarTodos, que así recorre solo
+ *          los sensores que recibieron algo.
+ */
+
+#ifndef SENSORES_PENDIENTES_H
+#define SENSORES_PENDIENTES_H
+
+#include <mutex>
+
+/**
+ * @class SensoresPendientes
+ * @brief Posiciones de registro (sin repetir) de los sensores que cambiaron
+ *
+ * CONCEPTO - Lista de sucios:
+ * En vez de preguntarle a cada sensor "¿cambiaste?", el sensor avisa
+ * una sola vez, cuando pasa de limpio a sucio. La pasada de proceso
+ * cuesta O(cambiados), no O(registrados).
+ *
+ * RAZÓN del cerrojo: Con varios hilos de ingesta, dos sensores pueden
+ * ensuciarse a la vez. Se toma una vez por sensor y por pasada (no por
+ * lectura): las lecturas siguientes ven al sensor ya anotado y siguen.
+ *
+ * ORDEN DE CERROJOS: anotar() se llama con el cerrojo del sensor tomado;
+ * tomar() se llama sin ninguno. Nunca se espera un sensor con este
+ * cerrojo tomado, así que no hay ciclo.
+ */
+class SensoresPendientes {
+private:
+    std::mutex cerrojo;
+    int* posiciones;
+    int cantidad;
+    int capacidad;
+
+public:
+    SensoresPendientes() : posiciones(new int[16]), cantidad(0), capacidad(16) {}
+
+    ~SensoresPendientes() {
+        delete[] posiciones;
+    }
+
+    SensoresPendientes(const SensoresPendientes&) = delete;
+    SensoresPendientes& operator=(const SensoresPendientes&) = delete;
+
+    /**
+     * @brief Anota un sensor que pasó de limpio a sucio
+     * @param posicion Posición del sensor en el registro del gestor
+     */
+    void anotar(int posicion) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        if (cantidad == capacidad) {
+            int* mayor = new int[capacidad * 2];
+            for (int i = 0; i < cantidad; i++) {
+                mayor[i] = posiciones[i];
+            }
+            delete[] posiciones;
+            posiciones = mayor;
+            capacidad *= 2;
+        }
+        posiciones[cantidad++] = posicion;
+    }
+
+    /**
+     * @brief Se lleva todas las posiciones anotadas y deja la lista vacía
+     * @param destino Recibe un arreglo nuevo (liberar con delete[]), o nullptr si no había
+     * @return Cantidad de posiciones, en orden de anotación
+     *
+     * RAZÓN de entregar el arreglo: Quien procesa trabaja sin el
+     * cerrojo, y los sensores que se ensucien mientras tanto van a
+     * una lista nueva para la próxima pasada.
+     */
+    int tomar(int*& destino) {
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        int n = cantidad;
+        if (n == 0) {
+            destino = nullptr;
+            return 0;
+        }
+        destino = posiciones;
+        posiciones = new int[capacidad];
+        cantidad = 0;
+        return n;
+    }
+};
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * @file SumideroAsincrono.h
+ * @brief Salida con buffer que escribe en un descriptor desde otro hilo
+ * @details Reemplaza el buffer de std::cout: cada operator<< solo copia
+ *          texto a memoria y un hilo escritor hace los write() por lotes.
+ */
+
+#ifndef SUMIDERO_ASINCRONO_H
+#define SUMIDERO_ASINCRONO_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * @class SumideroAsincrono
+ * @brief streambuf que acumula texto y lo escribe en segundo plano
+ *
+ * CONCEPTO - Sumidero asíncrono:
+ * El hilo que registra una lectura no espera al sistema operativo.
+ * El texto se acumula en 'pendiente' y el hilo escritor lo envía con
+ * un único write() cada INTERVALO_MS, o antes si se juntan UMBRAL bytes.
+ *
+ * BUFFER POR HILO:
+ * Cada operator<< copia a un buffer propio del hilo (thread_local), sin
+ * cerrojo. Solo al completar una línea ('\n') o en flush() se pasa ese
+ * texto a 'pendiente', con una sola toma de 'cerrojoTexto'. Antes cada
+ * carácter o cadena tomaba el cerrojo.
+ *
+ * ORDEN:
+ * - Todo lo escrito en std::cout sale en el mismo orden en que se
+ *   escribió, línea por línea: las líneas de dos hilos nunca se mezclan
+ * - flush() (y std::endl) escribe de inmediato lo pendiente; como
+ *   std::cerr está atado a std::cout, los errores no se adelantan
+ *   a los mensajes anteriores
+ *
+ * NOTA: flush() hace el write() en el hilo que llama, igual que sin
+ * sumidero. Por eso las rutas por línea y por pasada terminan con '\n'
+ * y no con std::endl; el vaciado explícito queda para el cierre y los
+ * errores.
+ *
+ * USO (RAII):
+ *   int main() {
+ *       SumideroAsincrono sumidero;   // std::cout pasa por el sumidero
+ *       ...
+ *   }                                 // se vacía y se restaura std::cout
+ *
+ * NOTA: Si el proceso muere por una señal se pierde a lo sumo lo
+ * acumulado en el último intervalo. Un hilo que termina sin '\n' ni
+ * flush() pierde su línea a medias (REGISTRAR siempre cierra la línea).
+ */
+class SumideroAsincrono : public std::streambuf {
+public:
+    static const std::size_t UMBRAL = 64 * 1024;  ///< Bytes que despiertan al escritor
+    static const int INTERVALO_MS = 50;          ///< Espera máxima entre escrituras
+
+private:
+    int fd;                        ///< Descriptor de destino
+    std::streambuf* anterior;      ///< Buffer original de std::cout
+
+    std::mutex cerrojoTexto;       ///< Protege 'pendiente' y 'cerrando'
+    std::condition_variable hayTexto;
+    std::string pendiente;         ///< Texto aún no enviado
+    bool cerrando;
+
+    std::mutex cerrojoEscritura;   ///< Un solo write() a la vez, en orden
+    std::string enVuelo;           ///< Lote que se está escribiendo
+
+    std::thread escritor;
+
+    /**
+     * @brief Línea en curso de un hilo
+     *
+     * 'dueño' evita que texto dejado para un sumidero ya destruido se
+     * cuele en otro creado después.
+     */
+    struct BufferHilo {
+        const SumideroAsincrono* dueño;
+        std::string texto;
+    };
+
+    /**
+     * @brief Buffer del hilo que llama, vacío si era de otro sumidero
+     */
+    BufferHilo& bufferDelHilo() {
+        static thread_local BufferHilo buffer = {nullptr, std::string()};
+        if (buffer.dueño != this) {
+            buffer.dueño = this;
+            buffer.texto.clear();
+        }
+        return buffer;
+    }
+
+    /**
+     * @brief Envía al descriptor todo lo pendiente
+     *
+     * RAZÓN de dos cerrojos:
+     * El write() se hace sin 'cerrojoTexto', así los demás hilos siguen
+     * acumulando mientras el sistema operativo copia el lote anterior.
+     */
+    void vaciar() {
+        std::lock_guard<std::mutex> guardiaEscritura(cerrojoEscritura);
+        {
+            std::lock_guard<std::mutex> guardia(cerrojoTexto);
+            enVuelo.swap(pendiente);
+        }
+
+        const char* p = enVuelo.data();
+        std::size_t restante = enVuelo.size();
+        while (restante > 0) {
+            ssize_t n = write(fd, p, restante);
+            if (n <= 0) {
+                break;  // Destino cerrado: se descarta lo que quedaba
+            }
+            p += n;
+            restante -= static_cast<std::size_t>(n);
+        }
+        enVuelo.clear();
+    }
+
+    /**
+     * @brief Bucle del hilo escritor
+     */
+    void escribirEnSegundoPlano() {
+        const std::chrono::milliseconds espera(static_cast<long>(INTERVALO_MS));
+        std::unique_lock<std::mutex> guardia(cerrojoTexto);
+        while (!cerrando) {
+            hayTexto.wait_for(guardia, espera);
+            if (!pendiente.empty()) {
+                guardia.unlock();
+                vaciar();
+                guardia.lock();
+            }
+        }
+    }
+
+    /**
+     * @brief Agrega texto a lo pendiente y avisa si ya es mucho
+     */
+    void acumular(const char* texto, std::size_t largo) {
+        bool avisar;
+        {
+            std::lock_guard<std::mutex> guardia(cerrojoTexto);
+            pendiente.append(texto, largo);
+            avisar = pendiente.size() >= UMBRAL;
+        }
+        if (avisar) {
+            hayTexto.notify_one();
+        }
+    }
+
+    /**
+     * @brief Pasa a 'pendiente' el buffer del hilo hasta el último '\n'
+     * @param todo true para pasar también la línea a medias (flush)
+     */
+    void entregarDelHilo(BufferHilo& buffer, bool todo) {
+        // Sin '\n', rfind da npos y npos + 1 == 0: no hay línea completa
+        std::size_t largo = todo ? buffer.texto.size() : buffer.texto.rfind('\n') + 1;
+        if (largo == 0) {
+            return;
+        }
+        acumular(buffer.texto.data(), largo);
+        buffer.texto.erase(0, largo);
+    }
+
+protected:
+    /**
+     * @brief Caracteres sueltos (ej: << '\n')
+     *
+     * RAZÓN de no usar el área de escritura de streambuf:
+     * Hay una sola para todos los hilos que escriben en std::cout; el
+     * buffer por hilo cumple su papel sin carreras.
+     */
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            BufferHilo& buffer = bufferDelHilo();
+            char letra = traits_type::to_char_type(c);
+            buffer.texto.push_back(letra);
+            if (letra == '\n') {
+                entregarDelHilo(buffer, false);
+            }
+        }
+        return traits_type::not_eof(c);
+    }
+
+    /**
+     * @brief Cadenas completas (ej: << "texto")
+     */
+    std::streamsize xsputn(const char* texto, std::streamsize largo) override {
+        BufferHilo& buffer = bufferDelHilo();
+        buffer.texto.append(texto, static_cast<std::size_t>(largo));
+        if (memchr(texto, '\n', static_cast<std::size_t>(largo)) != nullptr) {
+            entregarDelHilo(buffer, false);
+        }
+        return largo;
+    }
+
+    /**
+     * @brief flush(): entrega la línea a medias del hilo y escribe ya lo pendiente
+     */
+    int sync() override {
+        entregarDelHilo(bufferDelHilo(), true);
+        vaciar();
+        return 0;
+    }
+
+public:
+    /**
+     * @brief Constructor: arranca el escritor y desvía std::cout
+     * @param descriptor Destino (por defecto la salida estándar)
+     */
+    explicit SumideroAsincrono(int descriptor = STDOUT_FILENO)
+        : fd(descriptor), anterior(nullptr), cerrando(false) {
+        std::cout.flush();
+        escritor = std::thread(&SumideroAsincrono::escribirEnSegundoPlano, this);
+        anterior = std::cout.rdbuf(this);
+    }
+
+    /**
+     * @brief Destructor: detiene al escritor, vacía el resto y restaura std::cout
+     */
+    ~SumideroAsincrono() {
+        {
+            std::lock_guard<std::mutex> guardia(cerrojoTexto);
+            cerrando = true;
+        }
+        hayTexto.notify_one();
+        escritor.join();
+
+        entregarDelHilo(bufferDelHilo(), true);
+        vaciar();
+        std::cout.rdbuf(anterior);
+    }
+
+    SumideroAsincrono(const SumideroAsincrono&) = delete;
+    SumideroAsincrono& operator=(const SumideroAsincrono&) = delete;
+};
+
+#endif
@@ -0,0 +1,284 @@
+/**
+ * @file TablaIdentificadores.h
+ * @brief Internado de IDs de sensor: cada texto distinto recibe un número denso
+ * @details El texto de un ID se compara una sola vez, al traducirlo; de ahí
+ *          en adelante el gestor, los lotes y la cola usan el identificador
+ *          (un unsigned int) y comparar dos IDs es comparar dos enteros.
+ */
+
+#ifndef TABLA_IDENTIFICADORES_H
+#define TABLA_IDENTIFICADORES_H
+
+#include "ArregloPublicado.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+/**
+ * @brief Valor de un identificador que todavía no se resolvió
+ *
+ * Quien lo recibe busca el ID por su texto (TablaIdentificadores::buscar).
+ */
+const unsigned int IDENTIFICADOR_DESCONOCIDO = 0xFFFFFFFFu;
+
+/**
+ * @class TablaIdentificadores
+ * @brief Traduce IDs de texto a identificadores 0, 1, 2, ... sin repetir
+ *
+ * CONCEPTO - Internado (interning):
+ * Cada texto distinto se guarda una sola vez y recibe el siguiente
+ * número libre. Dos sensores con el mismo nombre tienen el mismo
+ * identificador, y el texto se recupera con texto(id).
+ *
+ * MEMORIA:
+ * - Los textos viven en bloques de 4 KB que nunca se mueven ni se
+ *   liberan mientras exista la tabla: texto(id) es un puntero estable
+ *   que el sensor puede guardar en lugar de su propia copia
+ * - Por ID: una Entrada (16 bytes), su casilla (8 bytes, ocupación < 50%)
+ *   y su texto con '\0'
+ *
+ * CONCURRENCIA (igual que el índice de GestorSensores):
+ * - buscar() y texto() no toman cerrojos: leen el índice y las
+ *   entradas publicados con release/acquire
+ * - internar() se serializa con 'cerrojo'; para crecer, el índice se
+ *   copia a uno del doble y el viejo queda en la cadena 'retirado'
+ *
+ * USO:
+ *   unsigned int id = TablaIdentificadores::global().internar("T-001", 5);
+ *   TablaIdentificadores::global().buscar("T-001", 5);  // == id
+ *   TablaIdentificadores::global().texto(id);           // "T-001"
+ */
+class TablaIdentificadores {
+private:
+    static const int TAM_BLOQUE = 4096;
+
+    /**
+     * @brief Lo que se sabe de un ID, en la posición de su identificador
+     */
+    struct Entrada {
+        const char* texto;  ///< Dentro de un bloque; termina en '\0'
+        unsigned int hash;  ///< FNV-1a del texto, para reubicarlo al crecer el índice
+        int largo;          ///< Caracteres sin contar el '\0'
+    };
+
+    /**
+     * @brief Índice de direccionamiento abierto
+     *
+     * Cada casilla guarda (hash << 32) | (identificador + 1), o 0 si está
+     * vacía. RAZÓN: El sondeo descarta por hash sin leer la Entrada; un
+     * ID presente cuesta la casilla y su texto, nada más.
+     */
+    struct Indice {
+        std::atomic<unsigned long long>* casillas;
+        unsigned int capacidad;  ///< Potencia de 2
+        Indice* retirado;
+
+        explicit Indice(unsigned int cap)
+            : casillas(new std::atomic<unsigned long long>[cap]), capacidad(cap), retirado(nullptr) {
+            for (unsigned int i = 0; i < cap; i++) {
+                casillas[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        ~Indice() {
+            delete[] casillas;
+        }
+    };
+
+    /**
+     * @brief Bloque de textos, encadenado al anterior para liberarlos al final
+     */
+    struct BloqueTexto {
+        char* datos;
+        BloqueTexto* anterior;
+    };
+
+    ArregloPublicado<Entrada> entradas;
+    std::atomic<Indice*> indice;
+    std::mutex cerrojo;
+
+    BloqueTexto* bloque;  ///< Bloque donde se copian los textos nuevos
+    int usadosBloque;
+    int tamBloque;
+
+    /**
+     * @brief Copia un texto a los bloques y devuelve su dirección estable
+     *
+     * NOTA: Con 'cerrojo' tomado. Un ID más largo que un bloque recibe
+     * un bloque a su medida.
+     */
+    const char* guardarTexto(const char* id, int largo) {
+        if (bloque == nullptr || usadosBloque + largo + 1 > tamBloque) {
+            int tam = largo + 1 > TAM_BLOQUE ? largo + 1 : TAM_BLOQUE;
+            BloqueTexto* nuevo = new BloqueTexto;
+            nuevo->datos = new char[tam];
+            nuevo->anterior = bloque;
+            bloque = nuevo;
+            usadosBloque = 0;
+            tamBloque = tam;
+        }
+        char* destino = bloque->datos + usadosBloque;
+        memcpy(destino, id, largo);
+        destino[largo] = '\0';
+        usadosBloque += largo + 1;
+        return destino;
+    }
+
+    static void insertarEnIndice(Indice* tabla, unsigned int identificador, unsigned int h) {
+        unsigned int mascara = tabla->capacidad - 1;
+        unsigned int pos = h & mascara;
+        while (tabla->casillas[pos].load(std::memory_order_relaxed) != 0) {
+            pos = (pos + 1) & mascara;
+        }
+        unsigned long long valor = (static_cast<unsigned long long>(h) << 32) | (identificador + 1ULL);
+        tabla->casillas[pos].store(valor, std::memory_order_release);
+    }
+
+    /**
+     * @brief Busca en un índice concreto (vigente o, para internar, el mismo con cerrojo)
+     */
+    unsigned int buscarEn(const Indice* tabla, const char* id, int largo, unsigned int h) const {
+        unsigned int mascara = tabla->capacidad - 1;
+        unsigned int pos = h & mascara;
+        unsigned long long casilla;
+        while ((casilla = tabla->casillas[pos].load(std::memory_order_acquire)) != 0) {
+            if (static_cast<unsigned int>(casilla >> 32) == h) {
+                // La entrada se publicó antes que la casilla: ya es visible
+                unsigned int identificador = static_cast<unsigned int>(casilla) - 1;
+                const Entrada& e = entradas.datos()[identificador];
+                if (e.largo == largo && memcmp(e.texto, id, largo) == 0) {
+                    return identificador;
+                }
+            }
+            pos = (pos + 1) & mascara;
+        }
+        return IDENTIFICADOR_DESCONOCIDO;
+    }
+
+public:
+    TablaIdentificadores()
+        : entradas(64), indice(new Indice(128)), bloque(nullptr), usadosBloque(0), tamBloque(0) {}
+
+    /**
+     * @brief Libera el índice y los textos (nadie debe seguir usando texto())
+     */
+    ~TablaIdentificadores() {
+        Indice* tabla = indice.load(std::memory_order_relaxed);
+        while (tabla != nullptr) {
+            Indice* retirado = tabla->retirado;
+            delete tabla;
+            tabla = retirado;
+        }
+        while (bloque != nullptr) {
+            BloqueTexto* anterior = bloque->anterior;
+            delete[] bloque->datos;
+            delete bloque;
+            bloque = anterior;
+        }
+    }
+
+    TablaIdentificadores(const TablaIdentificadores&) = delete;
+    TablaIdentificadores& operator=(const TablaIdentificadores&) = delete;
+
+    /**
+     * @brief Tabla del proceso, compartida por todos los sensores y gestores
+     *
+     * RAZÓN de no destruirla: Un sensor guarda texto(id) como su nombre.
+     * Si la tabla se destruyera con los estáticos, un gestor estático
+     * (o uno que se libere más tarde) imprimiría nombres ya liberados.
+     */
+    static TablaIdentificadores& global() {
+        static TablaIdentificadores* instancia = new TablaIdentificadores();
+        return *instancia;
+    }
+
+    /**
+     * @brief Hash FNV-1a de un ID dado por puntero y largo
+     */
+    static unsigned int calcularHash(const char* id, int largo) {
+        unsigned int h = 2166136261u;
+        for (int i = 0; i < largo; i++) {
+            h ^= static_cast<unsigned char>(id[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    /**
+     * @brief Identificador de un ID ya internado
+     * @param id Primer carácter (no necesita terminar en '\0')
+     * @param largo Cantidad de caracteres
+     * @return El identificador, o IDENTIFICADOR_DESCONOCIDO si nunca se internó
+     *
+     * COMPLEJIDAD: O(1) en promedio, sin cerrojos. Es la única
+     * comparación de texto en la ruta de ingesta.
+     */
+    unsigned int buscar(const char* id, int largo) const {
+        return buscarEn(indice.load(std::memory_order_acquire), id, largo, calcularHash(id, largo));
+    }
+
+    /**
+     * @brief Identificador de un ID, asignándole uno nuevo si no lo tenía
+     * @param id Primer carácter (no necesita terminar en '\0')
+     * @param largo Cantidad de caracteres
+     * @return Identificador denso: el primer ID recibe 0, el siguiente 1, ...
+     */
+    unsigned int internar(const char* id, int largo) {
+        unsigned int h = calcularHash(id, largo);
+        unsigned int existente = buscarEn(indice.load(std::memory_order_acquire), id, largo, h);
+        if (existente != IDENTIFICADOR_DESCONOCIDO) {
+            return existente;
+        }
+
+        std::lock_guard<std::mutex> guardia(cerrojo);
+        Indice* tabla = indice.load(std::memory_order_relaxed);
+        // Otro hilo pudo internarlo entre la búsqueda y el cerrojo
+        existente = buscarEn(tabla, id, largo, h);
+        if (existente != IDENTIFICADOR_DESCONOCIDO) {
+            return existente;
+        }
+
+        unsigned int nuevo = static_cast<unsigned int>(entradas.tamaño());
+        Entrada entrada = {guardarTexto(id, largo), h, largo};
+        entradas.agregar(entrada);
+
+        // Ocupación por debajo del 50%, como en el índice del gestor
+        if ((nuevo + 1) * 2 > tabla->capacidad) {
+            Indice* mayor = new Indice(tabla->capacidad * 2);
+            const Entrada* e = entradas.datos();
+            for (unsigned int i = 0; i <= nuevo; i++) {
+                insertarEnIndice(mayor, i, e[i].hash);
+            }
+            mayor->retirado = tabla;
+            indice.store(mayor, std::memory_order_release);
+        } else {
+            insertarEnIndice(tabla, nuevo, h);
+        }
+        return nuevo;
+    }
+
+    /**
+     * @brief Texto de un identificador ya asignado
+     * @return Cadena terminada en '\0', válida mientras exista la tabla
+     */
+    const char* texto(unsigned int identificador) const {
+        return entradas.datos()[identificador].texto;
+    }
+
+    /**
+     * @brief Largo del texto de un identificador ya asignado
+     */
+    int largo(unsigned int identificador) const {
+        return entradas.datos()[identificador].largo;
+    }
+
+    /**
+     * @brief Cantidad de IDs internados (el próximo identificador libre)
+     */
+    int cantidad() const {
+        return entradas.tamaño();
+    }
+};
+
+#endif
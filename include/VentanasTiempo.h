@@ -0,0 +1,228 @@
+/**
+ * @file VentanasTiempo.h
+ * @brief Resúmenes por ventana de tiempo (último minuto, 5 minutos, hora)
+ * @details Cada lectura suma a una cubeta por resolución; una consulta
+ *          combina a lo sumo 61 cubetas, sin recorrer las lecturas.
+ */
+
+#ifndef VENTANAS_TIEMPO_H
+#define VENTANAS_TIEMPO_H
+
+#include <chrono>
+#include "EstadisticasLista.h"
+
+/**
+ * @brief Milisegundos del reloj monotónico
+ *
+ * RAZÓN de steady_clock: No retrocede si alguien cambia la hora del
+ * sistema, así las ventanas y las marcas de las lecturas siempre avanzan.
+ */
+inline long long relojMonotonicoMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Resultado de una consulta por ventana (independiente del tipo T)
+ */
+struct ResumenVentana {
+    int cantidad;   ///< Lecturas en la ventana (0 = sin datos)
+    double media;   ///< Promedio de la ventana
+    double minimo;  ///< Valor más bajo
+    double maximo;  ///< Valor más alto
+
+    ResumenVentana() : cantidad(0), media(0.0), minimo(0.0), maximo(0.0) {}
+};
+
+/**
+ * @class VentanasTiempo
+ * @brief Cubetas precalculadas de cantidad, suma, mínimo y máximo
+ * @tparam T Tipo de las lecturas
+ *
+ * CONCEPTO - Rollups por resolución:
+ *   Nivel 0: cubetas de 1 s   -> cubre el último minuto
+ *   Nivel 1: cubetas de 10 s  -> cubre los últimos 5 minutos
+ *   Nivel 2: cubetas de 1 min -> cubre la última hora
+ * Cada nivel es un arreglo circular: la cubeta de una marca es
+ * (marca / ancho) % cantidad. Si guarda un intervalo viejo, se
+ * reinicia antes de sumar; si guarda uno MÁS NUEVO que la marca, la
+ * lectura ya salió del alcance de ese nivel y no se suma en él.
+ * Insertar cuesta O(1) por nivel.
+ *
+ * RAZÓN de la cubeta extra por nivel (61, 31, 61): La cubeta actual
+ * está a medio llenar; con una más, la ventana completa sigue cubierta.
+ *
+ * PRECISIÓN: La cubeta del borde más viejo entra completa, así que
+ * una ventana puede incluir hasta un ancho de cubeta de más.
+ *
+ * MEMORIA: 153 cubetas, unos 5 KB por sensor, sin importar cuántas
+ * lecturas lleguen.
+ */
+template <typename T>
+class VentanasTiempo {
+public:
+    static const int NIVELES = 3;
+
+private:
+    typedef typename AcumuladorDe<T>::tipo Acumulador;
+
+    struct Cubeta {
+        long long inicio;  ///< Primer ms del intervalo (-1 = nunca usada)
+        int cantidad;
+        Acumulador suma;
+        T minimo;
+        T maximo;
+    };
+
+    static long long anchoDe(int nivel) {
+        static const long long anchos[NIVELES] = {1000, 10000, 60000};
+        return anchos[nivel];
+    }
+
+    static int cubetasDe(int nivel) {
+        static const int cantidades[NIVELES] = {61, 31, 61};
+        return cantidades[nivel];
+    }
+
+    static int desplazamientoDe(int nivel) {
+        static const int desplazamientos[NIVELES] = {0, 61, 92};
+        return desplazamientos[nivel];
+    }
+
+    static const int TOTAL_CUBETAS = 153;
+
+    Cubeta cubetas[TOTAL_CUBETAS];  ///< Los tres niveles seguidos
+
+    /**
+     * @brief Cubeta de un nivel para una marca, reiniciada si era de un intervalo anterior
+     * @return nullptr si la cubeta ya guarda un intervalo posterior a la marca
+     *
+     * RAZÓN: Al hidratar un sensor llegan lecturas de hasta una hora
+     * atrás (SensorTemperatura::sumarAVentanas). Reiniciar la cubeta por
+     * ellas borraría las lecturas recientes de los niveles de 1 s y 10 s.
+     */
+    Cubeta* cubetaPara(int nivel, long long marcaMs) {
+        long long ancho = anchoDe(nivel);
+        long long intervalo = marcaMs / ancho;
+        Cubeta& c = cubetas[desplazamientoDe(nivel) + static_cast<int>(intervalo % cubetasDe(nivel))];
+        if (c.inicio != intervalo * ancho) {
+            if (intervalo * ancho < c.inicio) {
+                return nullptr;
+            }
+            c.inicio = intervalo * ancho;
+            c.cantidad = 0;
+            c.suma = 0;
+        }
+        return &c;
+    }
+
+public:
+    /**
+     * @brief Constructor: todas las cubetas vacías
+     */
+    VentanasTiempo() {
+        for (int i = 0; i < TOTAL_CUBETAS; i++) {
+            cubetas[i].inicio = -1;
+            cubetas[i].cantidad = 0;
+            cubetas[i].suma = 0;
+        }
+    }
+
+    /**
+     * @brief Suma una lectura a su cubeta de cada nivel
+     * @param valor Lectura
+     * @param marcaMs Marca del reloj monotónico
+     */
+    void agregar(T valor, long long marcaMs) {
+        for (int nivel = 0; nivel < NIVELES; nivel++) {
+            Cubeta* c = cubetaPara(nivel, marcaMs);
+            if (c == nullptr) {
+                continue;
+            }
+            if (c->cantidad == 0 || valor < c->minimo) {
+                c->minimo = valor;
+            }
+            if (c->cantidad == 0 || c->maximo < valor) {
+                c->maximo = valor;
+            }
+            c->suma += valor;
+            c->cantidad++;
+        }
+    }
+
+    /**
+     * @brief Suma un lote de lecturas con la misma marca
+     * @tparam U Tipo de origen; se convierte a T como en insertarVarios
+     *
+     * RAZÓN: Todo el lote cae en la misma cubeta de cada nivel; se busca
+     * una vez por nivel y no una vez por lectura.
+     */
+    template <typename U>
+    void agregarVarios(const U* valores, int cantidad, long long marcaMs) {
+        if (cantidad <= 0) {
+            return;
+        }
+        for (int nivel = 0; nivel < NIVELES; nivel++) {
+            Cubeta* c = cubetaPara(nivel, marcaMs);
+            if (c == nullptr) {
+                continue;
+            }
+            for (int i = 0; i < cantidad; i++) {
+                T valor = static_cast<T>(valores[i]);
+                if (c->cantidad == 0 || valor < c->minimo) {
+                    c->minimo = valor;
+                }
+                if (c->cantidad == 0 || c->maximo < valor) {
+                    c->maximo = valor;
+                }
+                c->suma += valor;
+                c->cantidad++;
+            }
+        }
+    }
+
+    /**
+     * @brief Resume las lecturas de los últimos 'ventanaMs' milisegundos
+     * @param ventanaMs Largo de la ventana (ej: 60000 = último minuto)
+     * @param ahoraMs Marca actual del reloj monotónico
+     * @return Cantidad, media, mínimo y máximo de la ventana
+     *
+     * PROCESO:
+     * 1. Elegir el nivel más fino que cubre la ventana (más de una hora
+     *    se recorta a la hora que guarda el último nivel)
+     * 2. Combinar las cubetas vigentes cuyo intervalo toca la ventana
+     */
+    ResumenVentana resumir(long long ventanaMs, long long ahoraMs) const {
+        int nivel = 0;
+        while (nivel < NIVELES - 1 && anchoDe(nivel) * (cubetasDe(nivel) - 1) < ventanaMs) {
+            nivel++;
+        }
+        long long ancho = anchoDe(nivel);
+        long long desde = ahoraMs - ventanaMs;
+
+        ResumenVentana resumen;
+        Acumulador suma = 0;
+        const Cubeta* c = cubetas + desplazamientoDe(nivel);
+        for (int i = 0; i < cubetasDe(nivel); i++) {
+            if (c[i].cantidad == 0 || c[i].inicio + ancho <= desde || c[i].inicio > ahoraMs) {
+                continue;
+            }
+            double minimo = static_cast<double>(c[i].minimo);
+            double maximo = static_cast<double>(c[i].maximo);
+            if (resumen.cantidad == 0 || minimo < resumen.minimo) {
+                resumen.minimo = minimo;
+            }
+            if (resumen.cantidad == 0 || resumen.maximo < maximo) {
+                resumen.maximo = maximo;
+            }
+            resumen.cantidad += c[i].cantidad;
+            suma += c[i].suma;
+        }
+        if (resumen.cantidad > 0) {
+            resumen.media = static_cast<double>(suma) / resumen.cantidad;
+        }
+        return resumen;
+    }
+};
+
+#endif
@@ -0,0 +1,431 @@
+/**
+ * @file PruebasSistemaIoT.cpp
+ * @brief Pruebas de comportamiento de los formatos en disco y en el cable
+ * @details Ida y vuelta de CompresionSeries, recuperación de la bitácora
+ *          (cola rota, salto declarado), rechazo de tramas de
+ *          ProtocoloBinario, cubetas de VentanasTiempo y extremos de
+ *          HistorialCircular. Sin
+ *          dependencias: cada prueba es una función y COMPROBAR cuenta
+ *          los fallos.
+ *
+ * USO:
+ *   $ ctest --output-on-failure
+ *   $ ./bin/PruebasSistemaIoT
+ */
+
+#include "BitacoraEscritura.h"
+#include "CompresionSeries.h"
+#include "HistorialCircular.h"
+#include "ProtocoloBinario.h"
+#include "VentanasTiempo.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// ============================================================================
+// APOYO
+// ============================================================================
+
+static int fallos = 0;
+
+/**
+ * @brief Anota un fallo con su línea, sin cortar las pruebas que siguen
+ */
+#define COMPROBAR(condicion)                                                     \
+    do {                                                                         \
+        if (!(condicion)) {                                                      \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": falló " #condicion "\n"; \
+            fallos++;                                                            \
+        }                                                                        \
+    } while (0)
+
+/**
+ * @brief Directorio temporal vacío para una prueba de bitácora
+ */
+static void directorioTemporal(char* ruta, int largo) {
+    snprintf(ruta, largo, "/tmp/pruebas-iot-XXXXXX");
+    if (mkdtemp(ruta) == nullptr) {
+        perror("mkdtemp");
+        exit(2);
+    }
+}
+
+static void borrarDirectorio(const char* ruta) {
+    char orden[600];
+    snprintf(orden, sizeof(orden), "rm -rf '%s'", ruta);
+    if (system(orden) != 0) {
+        std::cerr << "No se pudo borrar " << ruta << "\n";
+    }
+}
+
+static void llenarLote(LecturaParseada* lecturas, int n, int desde) {
+    for (int i = 0; i < n; i++) {
+        lecturas[i].tipo = 'T';
+        copiarIdLectura(lecturas[i], "T-001", 5);
+        lecturas[i].decimal = desde + i;
+        completarValores('T', lecturas[i].decimal, lecturas[i].entero);
+    }
+}
+
+/**
+ * @brief Reproductor que solo cuenta y guarda el último valor recibido
+ */
+struct ContarReproducidas {
+    long long* cantidad;
+    double* ultimo;
+
+    void operator()(const LecturaParseada* lecturas, int n, long long) {
+        *cantidad += n;
+        if (n > 0) {
+            *ultimo = lecturas[n - 1].decimal;
+        }
+    }
+};
+
+// ============================================================================
+// CompresionSeries
+// ============================================================================
+
+static void pruebaDeltaDelta() {
+    static const long long valores[] = {
+        1700000000000LL, 1700000001000LL, 1700000002000LL, 1700000002999LL,
+        1700000010000LL, -5, 0, 9223372036854775807LL, -9223372036854775807LL - 1, 42};
+    const int n = sizeof(valores) / sizeof(valores[0]);
+
+    unsigned char datos[n * CodificadorDeltaDelta::MAXIMO_BITS / 8 + 1];
+    EscritorBits escritor(datos, sizeof(datos));
+    CodificadorDeltaDelta codificar;
+    for (int i = 0; i < n; i++) {
+        codificar.escribir(escritor, valores[i]);
+    }
+    COMPROBAR(!escritor.desbordado());
+
+    LectorBits lector(datos, escritor.bytesUsados());
+    CodificadorDeltaDelta decodificar;
+    for (int i = 0; i < n; i++) {
+        COMPROBAR(decodificar.leer(lector) == valores[i]);
+    }
+    COMPROBAR(!lector.agotado());
+
+    // Marcas a ritmo constante: un bit por valor después de los dos primeros
+    unsigned char regulares[64];
+    EscritorBits compacto(regulares, sizeof(regulares));
+    CodificadorDeltaDelta ritmo;
+    for (int i = 0; i < 100; i++) {
+        ritmo.escribir(compacto, 1700000000000LL + i * 1000LL);
+    }
+    COMPROBAR(!compacto.desbordado());
+    COMPROBAR(compacto.bytesUsados() < 32);
+}
+
+static void pruebaXor() {
+    static const float valores[] = {
+        23.4f, 23.4f, 23.5f, -0.0f, 0.0f, 1e-30f, 3.4e38f, -17.25f, 23.45f, 23.45f, 1013.0f};
+    const int n = sizeof(valores) / sizeof(valores[0]);
+
+    unsigned char datos[n * CodificadorXor::MAXIMO_BITS / 8 + 1];
+    EscritorBits escritor(datos, sizeof(datos));
+    CodificadorXor codificar;
+    for (int i = 0; i < n; i++) {
+        codificar.escribir(escritor, valores[i]);
+    }
+    COMPROBAR(!escritor.desbordado());
+
+    LectorBits lector(datos, escritor.bytesUsados());
+    CodificadorXor decodificar;
+    for (int i = 0; i < n; i++) {
+        float leido = decodificar.leer(lector);
+        COMPROBAR(memcmp(&leido, &valores[i], sizeof(float)) == 0);
+    }
+    COMPROBAR(!lector.agotado());
+
+    // Un bloque cortado no lee fuera de su memoria
+    LectorBits corto(datos, 2);
+    CodificadorXor incompleto;
+    for (int i = 0; i < n; i++) {
+        incompleto.leer(corto);
+    }
+    COMPROBAR(corto.agotado());
+}
+
+// ============================================================================
+// BitacoraEscritura
+// ============================================================================
+
+static void pruebaBitacoraColaRota() {
+    char dir[64];
+    directorioTemporal(dir, sizeof(dir));
+
+    LecturaParseada lote[10];
+    {
+        BitacoraEscritura bitacora;
+        long long previas = bitacora.abrir(dir, [](const LecturaParseada*, int, long long) {});
+        COMPROBAR(previas == 0);
+        for (int k = 0; k < 3; k++) {
+            llenarLote(lote, 10, k * 10);
+            bitacora.anotarLote(lote, 10);
+            bitacora.confirmar();
+        }
+    }
+
+    // Sin daño: vuelve todo, en orden
+    long long cantidad = 0;
+    double ultimo = -1.0;
+    {
+        BitacoraEscritura bitacora;
+        ContarReproducidas contar = {&cantidad, &ultimo};
+        COMPROBAR(bitacora.abrir(dir, contar) == 30);
+    }
+    COMPROBAR(cantidad == 30);
+    COMPROBAR(ultimo == 29.0);
+
+    // Romper un byte de la carga del tercer registro (cola a medio escribir)
+    const int largoRegistro = BitacoraEscritura::CABECERA_REGISTRO + 10 * (2 + 5 + 8);
+    char ruta[128];
+    snprintf(ruta, sizeof(ruta), "%s/bitacora-000001.wal", dir);
+    int fd = open(ruta, O_RDWR);
+    COMPROBAR(fd >= 0);
+    unsigned char basura = 0xFF;
+    off_t posicion = BitacoraEscritura::CABECERA_SEGMENTO + 2 * largoRegistro +
+                     BitacoraEscritura::CABECERA_REGISTRO + 3;
+    COMPROBAR(pwrite(fd, &basura, 1, posicion) == 1);
+    close(fd);
+
+    // La reproducción se detiene en el registro roto y no antes
+    cantidad = 0;
+    {
+        BitacoraEscritura bitacora;
+        ContarReproducidas contar = {&cantidad, &ultimo};
+        COMPROBAR(bitacora.abrir(dir, contar) == 20);
+    }
+    COMPROBAR(cantidad == 20);
+    COMPROBAR(ultimo == 19.0);
+
+    borrarDirectorio(dir);
+}
+
+static void pruebaBitacoraSalto() {
+    char dir[64];
+    directorioTemporal(dir, sizeof(dir));
+
+    LecturaParseada lote[256];
+    llenarLote(lote, 256, 0);
+    long long anotadas = 0;
+    long long perdidas = 0;
+    {
+        BitacoraEscritura bitacora;
+        bitacora.abrir(dir, [](const LecturaParseada*, int, long long) {});
+
+        // Un directorio con el nombre del segmento siguiente impide abrirlo
+        char bloqueo[128];
+        snprintf(bloqueo, sizeof(bloqueo), "%s/bitacora-000002.wal", dir);
+        COMPROBAR(mkdir(bloqueo, 0755) == 0);
+
+        // Llenar el primer segmento (4 MB) y seguir: esos lotes se pierden
+        for (int k = 0; k < 1200; k++) {
+            bitacora.anotarLote(lote, 256);
+            anotadas += 256;
+            bitacora.confirmar();
+        }
+        COMPROBAR(bitacora.obtenerLecturasPerdidas() > 0);
+
+        rmdir(bloqueo);
+        for (int k = 0; k < 10; k++) {
+            bitacora.anotarLote(lote, 256);
+            anotadas += 256;
+            bitacora.confirmar();
+        }
+        perdidas = bitacora.obtenerLecturasPerdidas();
+    }
+
+    // El segmento que siguió al hueco declara el salto y se reproduce
+    BitacoraEscritura bitacora;
+    COMPROBAR(bitacora.abrir(dir, [](const LecturaParseada*, int, long long) {}) == anotadas - perdidas);
+
+    borrarDirectorio(dir);
+}
+
+// ============================================================================
+// ProtocoloBinario
+// ============================================================================
+
+/**
+ * @brief Manejador de DecodificadorTramas que copia lo entregado
+ */
+struct GuardarLecturas {
+    LecturaParseada* destino;
+    int* cantidad;
+
+    void operator()(const LecturaParseada* lecturas, int n) {
+        for (int i = 0; i < n; i++) {
+            destino[(*cantidad)++] = lecturas[i];
+        }
+    }
+};
+
+/**
+ * @brief Escribe en 'fd' una trama de lecturas con un solo valor de 4 bytes
+ */
+static void enviarLectura(int fd, unsigned short secuencia, unsigned char indice, unsigned int bits,
+                          bool dañarCrc) {
+    unsigned char carga[BYTES_POR_LECTURA];
+    carga[0] = indice;
+    memcpy(carga + 1, &bits, 4);
+    unsigned char trama[CABECERA_TRAMA + BYTES_POR_LECTURA + COLA_TRAMA];
+    int n = armarTrama(trama, TRAMA_LECTURAS, secuencia, carga, BYTES_POR_LECTURA);
+    if (dañarCrc) {
+        trama[CABECERA_TRAMA + 1] ^= 0x01;
+    }
+    COMPROBAR(write(fd, trama, n) == n);
+}
+
+static void pruebaProtocolo() {
+    int tubo[2];
+    COMPROBAR(pipe(tubo) == 0);
+
+    unsigned char trama[CABECERA_TRAMA + LARGO_MAXIMO_CARGA + COLA_TRAMA];
+    unsigned char hola[1] = {VERSION_PROTOCOLO};
+    int n = armarTrama(trama, TRAMA_HOLA, 0, hola, 1);
+    COMPROBAR(write(tubo[1], trama, n) == n);
+
+    unsigned char tabla[] = {7, 'T', 5, 'T', '-', '0', '0', '1',
+                             9, 'P', 5, 'P', '-', '0', '0', '1'};
+    n = armarTrama(trama, TRAMA_TABLA, 1, tabla, sizeof(tabla));
+    COMPROBAR(write(tubo[1], trama, n) == n);
+
+    float temperatura = 21.5f;
+    unsigned int bits;
+    memcpy(&bits, &temperatura, 4);
+    enviarLectura(tubo[1], 2, 7, bits, false);
+    enviarLectura(tubo[1], 3, 9, static_cast<unsigned int>(-12), false);
+    enviarLectura(tubo[1], 4, 7, bits, true);   // CRC roto
+    float nan = std::nanf("");
+    memcpy(&bits, &nan, 4);
+    enviarLectura(tubo[1], 5, 7, bits, false);  // CRC bien, valor no finito
+    temperatura = 22.0f;
+    memcpy(&bits, &temperatura, 4);
+    enviarLectura(tubo[1], 6, 7, bits, false);
+
+    // Tablas que parsearTrama no aceptaría como texto: tipo 'X' e ID con salto de línea
+    unsigned char tipoMalo[] = {7, 'X', 5, 'T', '-', '0', '0', '1'};
+    n = armarTrama(trama, TRAMA_TABLA, 7, tipoMalo, sizeof(tipoMalo));
+    COMPROBAR(write(tubo[1], trama, n) == n);
+    unsigned char idMalo[] = {9, 'P', 5, 'a', '\n', '#', 'P', 'R'};
+    n = armarTrama(trama, TRAMA_TABLA, 8, idMalo, sizeof(idMalo));
+    COMPROBAR(write(tubo[1], trama, n) == n);
+    enviarLectura(tubo[1], 9, 9, 5, false);
+
+    DecodificadorTramas decodificador(tubo[0]);
+    COMPROBAR(decodificador.llenar() > 0);
+    LecturaParseada recibidas[16];
+    int cantidad = 0;
+    GuardarLecturas guardar = {recibidas, &cantidad};
+    decodificador.decodificar(guardar);
+
+    COMPROBAR(decodificador.obtenerVersion() == VERSION_PROTOCOLO);
+    COMPROBAR(cantidad == 4);
+    if (cantidad == 4) {
+        COMPROBAR(recibidas[0].tipo == 'T' && strcmp(recibidas[0].id, "T-001") == 0);
+        COMPROBAR(recibidas[0].decimal == 21.5);
+        COMPROBAR(recibidas[1].tipo == 'P' && strcmp(recibidas[1].id, "P-001") == 0);
+        COMPROBAR(recibidas[1].entero == -12);
+        COMPROBAR(recibidas[2].decimal == 22.0);
+        // Las tablas rechazadas no cambiaron el índice 9
+        COMPROBAR(recibidas[3].tipo == 'P' && strcmp(recibidas[3].id, "P-001") == 0);
+        COMPROBAR(recibidas[3].entero == 5);
+    }
+    COMPROBAR(decodificador.obtenerErroresCrc() > 0);
+    COMPROBAR(decodificador.obtenerTramasInvalidas() == 3);
+
+    close(tubo[0]);
+    close(tubo[1]);
+}
+
+// ============================================================================
+// VentanasTiempo
+// ============================================================================
+
+static void pruebaVentanasLecturaVieja() {
+    const long long ahora = 10LL * 3600000LL;
+    VentanasTiempo<float> ventanas;
+    ventanas.agregar(25.0f, ahora);
+
+    // Lecturas de hace casi una hora (como al hidratar) que caen en la
+    // misma cubeta circular: 3599 s = 59 vueltas de las 61 cubetas de
+    // 1 s, 3410 s = 11 vueltas de las 31 de 10 s. No deben reiniciarlas.
+    ventanas.agregar(10.0f, ahora - 3599000LL);
+    float lote[2] = {11.0f, 12.0f};
+    ventanas.agregarVarios(lote, 2, ahora - 3410000LL);
+
+    ResumenVentana reciente = ventanas.resumir(10000, ahora);
+    COMPROBAR(reciente.cantidad == 1);
+    COMPROBAR(reciente.maximo == 25.0);
+    COMPROBAR(ventanas.resumir(300000, ahora).cantidad == 1);
+
+    // El nivel de una hora sí las cuenta
+    COMPROBAR(ventanas.resumir(3600000, ahora).cantidad == 4);
+}
+
+// ============================================================================
+// HistorialCircular
+// ============================================================================
+
+/**
+ * @brief Mínimo y máximo incrementales contra un recorrido de las últimas 'capacidad'
+ *
+ * Valores de un rango chico (muchos repetidos) y tramos constantes, que
+ * es donde importa contar las copias de los extremos.
+ */
+static void pruebaHistorialExtremos() {
+    const int capacidad = 8;
+    const int total = 2000;
+    HistorialCircular<int> historial(capacidad);
+    int valores[total];
+    unsigned int semilla = 12345;
+    for (int i = 0; i < total; i++) {
+        semilla = semilla * 1103515245u + 12345u;
+        valores[i] = (i / 100) % 2 == 0 ? static_cast<int>((semilla >> 16) % 4) : 1013;
+        historial.insertarAlFinal(valores[i]);
+
+        int desde = i + 1 > capacidad ? i + 1 - capacidad : 0;
+        int minimo = valores[desde];
+        int maximo = valores[desde];
+        for (int j = desde; j <= i; j++) {
+            minimo = valores[j] < minimo ? valores[j] : minimo;
+            maximo = valores[j] > maximo ? valores[j] : maximo;
+        }
+        COMPROBAR(historial.obtenerEstadisticas().obtenerMinimo() == minimo);
+        COMPROBAR(historial.obtenerEstadisticas().obtenerMaximo() == maximo);
+    }
+
+    // eliminarMinimo recuenta las copias: las siguientes salidas siguen bien
+    historial.eliminarMinimo();
+    for (int k = 0; k < capacidad; k++) {
+        historial.insertarAlFinal(7);
+    }
+    COMPROBAR(historial.obtenerEstadisticas().obtenerMinimo() == 7);
+    COMPROBAR(historial.obtenerEstadisticas().obtenerMaximo() == 7);
+}
+
+int main() {
+    pruebaDeltaDelta();
+    pruebaXor();
+    pruebaBitacoraColaRota();
+    pruebaBitacoraSalto();
+    pruebaProtocolo();
+    pruebaVentanasLecturaVieja();
+    pruebaHistorialExtremos();
+
+    if (fallos > 0) {
+        std::cerr << fallos << " comprobación(es) fallaron\n";
+        return 1;
+    }
+    std::cout << "Todas las pruebas pasaron\n";
+    return 0;
+}
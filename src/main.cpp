@@ -31,6 +31,27 @@
 // Para conversiones y comparaciones
 #include <cstring>
 
+#include <cerrno>
+#include <cstdlib>
+#include <ctime>
+
+// Lectura de varios puertos con epoll y parser de tramas
+#include "ReactorSerial.h"
+#include "ParserTramas.h"
+
+// Tubería lector -> procesador
+#include "ColaSPSC.h"
+#include "SumideroAsincrono.h"
+
+// Del texto recibido al gestor, y de ahí a --datos (compartido con bench/)
+#include "IngestaSerial.h"
+// Contadores e histogramas del camino caliente, y su publicación
+#include "ExportadorMetricas.h"
+#include "GestorFragmentado.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 /**
  * @brief Configuración del puerto serial para ESP32
  * @return Descriptor de archivo del puerto, o -1 si falla
@@ -66,9 +87,21 @@ int configurarSerial(const char* puerto, int baudrate) {
         case 9600: 
             speed = B9600;  
         break;
+        case 19200: 
+            speed = B19200; 
+        break;
+        case 38400: 
+            speed = B38400; 
+        break;
+        case 57600: 
+            speed = B57600; 
+        break;
         case 115200: 
             speed = B115200; 
         break;
+        case 230400: 
+            speed = B230400; 
+        break;
         default:     
             speed = B9600;   
         break;
@@ -90,6 +123,8 @@ int configurarSerial(const char* puerto, int baudrate) {
     // Deshabilitar procesamiento de entrada
     opciones.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
     opciones.c_iflag &= ~(IXON | IXOFF | IXANY);
+    // Sin traducciones de bytes: las tramas binarias pueden traer 0x0D o 0xFF
+    opciones.c_iflag &= ~(ICRNL | INLCR | IGNCR | ISTRIP | BRKINT | PARMRK);
     opciones.c_oflag &= ~OPOST;
     
     // Aplicar configuración inmediatamente
@@ -101,148 +136,437 @@ int configurarSerial(const char* puerto, int baudrate) {
 }
 
 /**
- * @brief Lee una línea completa desde el puerto serial
- * @param fd Descriptor del puerto serial
- * @param buffer Buffer donde se almacenará la línea
- * @param maxLen Tamaño máximo del buffer
- * @return true si se leyó una línea completa, false en caso contrario
- * 
- * CONCEPTO - Lectura Serial:
- * Los datos llegan byte por byte. Debemos acumularlos hasta
- * encontrar un carácter de nueva línea ('\n').
- * 
- * FORMATO ESPERADO DEL ESP32:
- * "T,T-001,23.5\n"
- * "P,P-105,1013\n"
+ * @brief Lee los puertos y procesa las lecturas en dos hilos
+ * @param reactor Reactor con los puertos ya registrados
+ * @param gestor Referencia al gestor de sensores
+ * @param segundos Duración de la captura
+ * @param binario true si los puertos ya pasaron por activarBinario()
+ * @param persistencia Recibe cada lote del consumidor si se usó --datos
  * 
- * Donde:
- * - Primer campo: Tipo (T=Temperatura, P=Presión)
- * - Segundo campo: ID del sensor
- * - Tercer campo: Valor de la lectura
+ * CONCEPTO - Productor / Consumidor:
+ * - Hilo principal (productor): espera datos con epoll, parsea cada
+ *   línea y encola la LecturaParseada en una ColaSPSC.
+ * - Hilo procesador (consumidor): saca lotes de la cola y los entrega
+ *   al gestor con agregarLecturas. Es el ÚNICO hilo que toca el gestor.
  * 
- * PROCESO:
- * 1. Leer caracteres uno por uno
- * 2. Acumular en buffer
- * 3. Si encontramos '\n', terminamos
- * 4. Retornar true si la línea está completa
+ * RAZÓN: Si registrar o procesar se atrasa, el lector sigue vaciando
+ * el puerto y no se pierden bytes. Si la cola se llena, la lectura se
+ * descarta y se cuenta en 'rechazadas' para que se note el atraso.
  */
-bool leerLineaSerial(int fd, char* buffer, int maxLen) {
-    static char bufferInterno[256];
-    static int posicion = 0;
-    
-    char c;
-    // Leer 1 byte
-    int n = read(fd, &c, 1);
-    
-    if (n > 0) {
-        // Verificamos si es es fin de línea
-        if (c == '\n' || c == '\r') {
-            if (posicion > 0) {
-                // Terminar string
-                bufferInterno[posicion] = '\0';
-                strncpy(buffer, bufferInterno, maxLen);
-                posicion = 0;
-                return true;
+void capturarConHilos(ReactorSerial& reactor, GestorSensores& gestor, int segundos, bool binario,
+                      Persistencia& persistencia) {
+    // En memoria dinámica: 8192 lecturas no caben cómodas en la pila
+    ColaSPSC<LecturaParseada, 8192>* cola = new ColaSPSC<LecturaParseada, 8192>();
+    std::atomic<bool> terminado(false);
+
+    std::thread procesador([cola, &terminado, &gestor, &persistencia]() {
+        const int TAM_LOTE = 256;
+        LecturaParseada lote[TAM_LOTE];
+        while (true) {
+            // Leer 'terminado' antes de vaciar: así no queda nada pendiente al salir
+            bool ultimaVuelta = terminado.load(std::memory_order_acquire);
+            int n = cola->desencolarLote(lote, TAM_LOTE);
+            // Un lote completo por llamada: una búsqueda y un cerrojo por sensor
+            gestor.agregarLecturas(lote, n, crearSensorDeLectura);
+            persistencia.guardar(lote, n);
+            if (n == 0) {
+                if (ultimaVuelta) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
             }
-        } else if (posicion < 255) {
-            // Terminar string
-            bufferInterno[posicion++] = c;
         }
+    });
+
+    time_t inicio = time(nullptr);
+    while (time(nullptr) - inicio < segundos && reactor.puertosActivos() > 0) {
+        if (binario) {
+            reactor.atenderTramas(100, [cola](const LecturaParseada* lecturas, int cantidad) {
+                for (int i = 0; i < cantidad; i++) {
+                    cola->intentarEncolar(lecturas[i]);
+                }
+            });
+            continue;
+        }
+        reactor.atender(100, [cola](const char* linea, int largo) {
+            std::cout << "[Serial] Recibido: " << linea << "\n";
+            LecturaParseada lectura;
+            METRICA_CONTAR(CONTADOR_LINEAS, 1);
+            METRICA_INICIO(inicioParseo);
+            bool valida = interpretarLinea(linea, largo, lectura);
+            METRICA_FIN(ETAPA_PARSEO, inicioParseo);
+            if (!valida) {
+                METRICA_CONTAR(CONTADOR_MALFORMADAS, 1);
+                std::cout << "[Advertencia] Línea malformada recibida.\n";
+                return;
+            }
+            cola->intentarEncolar(lectura);
+        });
     }
-    
-    return false;
+
+    terminado.store(true, std::memory_order_release);
+    procesador.join();
+
+    std::cout << "[Cola] Encoladas: " << cola->obtenerEncoladas()
+              << " | Rechazadas (cola llena): " << cola->obtenerRechazadas()
+              << " | Ocupación máxima: " << cola->obtenerMaximaOcupacion()
+              << "/" << cola->obtenerCapacidad() << std::endl;
+
+    delete cola;
 }
 
 /**
- * @brief Procesa una línea recibida del ESP32
- * @param linea String con formato "TIPO,ID,VALOR"
- * @param gestor Referencia al gestor de sensores
- * 
- * FORMATO DE LÍNEA:
- * "T,T-001,23.5"  -> Temperatura, ID=T-001, Valor=23.5
- * "P,P-105,1013"  -> Presión, ID=P-105, Valor=1013
- * 
- * PROCESO DE PARSING:
- * 1. Dividir la línea en campos usando ',' como separador
- * 2. Campo 0: Tipo de sensor (T o P)
- * 3. Campo 1: ID del sensor
- * 4. Campo 2: Valor de la lectura
- * 5. Buscar el sensor en el gestor
- * 6. Si no existe, crearlo
- * 7. Agregar la lectura al sensor
+ * @brief Separa un argumento "ruta[:baudios]" en sus partes
+ * @param arg Argumento de línea de comandos (se modifica: ':' -> '\0')
+ * @param baudrate Recibe los baudios (115200 si no se indican)
+ * @return Ruta del puerto
  * 
- * TÉCNICA - strtok:
- * strtok divide un string usando delimitadores.
- * Primera llamada: strtok(linea, ",")
- * Siguientes: strtok(nullptr, ",")
+ * Ejemplo: "/dev/ttyUSB1:9600" -> ruta "/dev/ttyUSB1", 9600 baudios
  */
-void procesarLinea(char* linea, GestorSensores& gestor) {
-    // Dividir la línea
-    char* tipo = strtok(linea, ",");
-    char* id = strtok(nullptr, ",");
-    char* valor = strtok(nullptr, ",");
-    
-    if (tipo == nullptr || id == nullptr || valor == nullptr) {
-        std::cout << "[Advertencia] Línea malformada recibida." << std::endl;
+const char* separarPuerto(char* arg, int& baudrate) {
+    baudrate = 115200;
+    char* dosPuntos = strrchr(arg, ':');
+    if (dosPuntos != nullptr) {
+        *dosPuntos = '\0';
+        baudrate = atoi(dosPuntos + 1);
+    }
+    return arg;
+}
+
+/**
+ * @brief Abre (vaciándolo) el archivo de --informe-salida
+ * @return Descriptor, o -1 si no se indicó archivo o no se pudo abrir
+ */
+int abrirInforme(const char* archivoInforme) {
+    if (archivoInforme == nullptr) {
+        return -1;
+    }
+    int fd = open(archivoInforme, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cout << "[Informe] No se pudo abrir " << archivoInforme << ": "
+                  << strerror(errno) << ". Se lista en pantalla.\n";
+    }
+    return fd;
+}
+
+/**
+ * @brief Lista los sensores en pantalla o, con --informe-salida, en el archivo
+ * @param gestor GestorSensores o GestorFragmentado cuyos sensores se listan
+ * @param opciones Lo elegido con --informe
+ * @param fdInforme Descriptor del archivo de informe, o -1 para std::cout
+ */
+template <typename Gestor>
+void listarSensores(Gestor& gestor, const OpcionesInforme& opciones, int fdInforme) {
+    if (fdInforme < 0) {
+        EscritorInforme salida(std::cout);
+        gestor.listarSensores(salida, opciones);
         return;
     }
-    
-    // Buscar o crear el sensor
-    SensorBase* sensor = gestor.buscarSensor(id);
-    
-    if (sensor == nullptr) {
-        // Sensor no existe, crear uno nuevo
-        if (tipo[0] == 'T') {
-            sensor = new SensorTemperatura(id);
-            std::cout << "[Serial] Nuevo sensor de temperatura: " << id << "\n";
-        } else if (tipo[0] == 'P') {
-            sensor = new SensorPresion(id);
-            std::cout << "[Serial] Nuevo sensor de presión: " << id << "\n";
-        } else {
-            std::cout << "[Error] Tipo de sensor desconocido: " << tipo << "\n";
-            return;
+
+    EscritorInforme salida(fdInforme);
+    gestor.listarSensores(salida, opciones);
+    salida.vaciar();
+    std::cout << "[Informe] " << salida.obtenerBytesEntregados() << " bytes en "
+              << salida.obtenerEntregas() << " escritura(s) al archivo\n";
+}
+
+/**
+ * @brief Captura, proceso y listados con los sensores repartidos en fragmentos
+ * @param reactor Reactor con los puertos ya registrados (sin puertos: demo)
+ * @param fragmentado Frente con los fragmentos ya lanzados o conectados
+ * @param binario true si se usó --binario
+ * @param opciones Lo elegido con --informe
+ * @param archivoInforme Archivo de --informe-salida, o nullptr
+ *
+ * Mismo flujo que main() con un solo gestor; cada lectura viaja al
+ * fragmento dueño de su ID y los pasos de proceso y listado se piden a
+ * todos los fragmentos a la vez.
+ */
+void ejecutarFragmentado(ReactorSerial& reactor, GestorFragmentado& fragmentado, bool binario,
+                         const OpcionesInforme& opciones, const char* archivoInforme) {
+    bool modoDemo = reactor.puertosActivos() == 0;
+    if (modoDemo) {
+        std::cout << "\n[Modo Demo] Ejecutando sin ESP32 en " << fragmentado.obtenerCantidad() << " fragmento(s)...\n";
+        const char* lineas[] = {"T,T-001,45.3", "T,T-001,42.1", "T,T-001,47.8",
+                                "P,P-105,1013", "P,P-105,1015", "P,P-105,1012"};
+        for (int i = 0; i < 6; i++) {
+            fragmentado.enrutarLinea(lineas[i], static_cast<int>(strlen(lineas[i])));
         }
-        gestor.agregarSensor(sensor);
+    } else {
+        std::cout << "\n[Modo Serial] Esperando datos de " << reactor.puertosActivos() << " ESP32 para "
+                  << fragmentado.obtenerCantidad() << " fragmento(s)...\n";
+        if (binario) {
+            reactor.activarBinario();
+        }
+        time_t inicio = time(nullptr);
+        while (time(nullptr) - inicio < 30 && reactor.puertosActivos() > 0) {
+            if (binario) {
+                reactor.atenderTramas(100, [&fragmentado](const LecturaParseada* lecturas, int cantidad) {
+                    fragmentado.enrutarLecturas(lecturas, cantidad);
+                });
+            } else {
+                reactor.atender(100, [&fragmentado](const char* linea, int largo) {
+                    if (!fragmentado.enrutarLinea(linea, largo)) {
+                        std::cout << "[Advertencia] Línea malformada recibida.\n";
+                    }
+                });
+            }
+        }
+        reactor.informarTramas();
+    }
+    fragmentado.informar();
+    if (!modoDemo) {
+        fragmentado.imprimirVentanas();
+    }
+
+    int fdInforme = abrirInforme(archivoInforme);
+    std::cout << "\n";
+    listarSensores(fragmentado, opciones, fdInforme);
+
+    std::cout << "\n\n[Usuario] Ejecutar procesamiento polimórfico...\n";
+    fragmentado.procesarTodos();
+
+    std::cout << "\n";
+    listarSensores(fragmentado, opciones, fdInforme);
+    if (fdInforme >= 0) {
+        close(fdInforme);
     }
-    
-    // Agregar lectura al sensor (polimorfismo)
-    sensor->agregarLectura(valor);
 }
 
 /**
  * @brief Función principal del programa
+ * @param argc Cantidad de argumentos
+ * @param argv Puertos a escuchar, cada uno como "ruta[:baudios]".
+ *        Sin puertos se usa /dev/ttyUSB0 a 115200 baudios.
+ *        La opción --hilos separa lectura y procesamiento (capturarConHilos).
+ *        La opción --trabajadores N procesa los sensores en N hilos (0 = uno por núcleo).
+ *        La opción --binario pide a cada ESP32 el protocolo de tramas (ProtocoloBinario.h).
+ *        La opción --datos DIR guarda las lecturas en DIR y restaura lo guardado (AlmacenSegmentos.h);
+ *        antes pasan por una bitácora que se reproduce si el proceso se cae (BitacoraEscritura.h).
+ *        La opción --metricas N imprime un resumen de Metricas.h cada N segundos y al cerrar.
+ *        La opción --metricas-puerto P sirve GET /metrics (Prometheus) en 127.0.0.1:P.
+ *        La opción --informe completo|resumen|N elige qué muestra el listado de sensores:
+ *        todas las lecturas, solo promedio/mínimo/máximo, o las últimas N.
+ *        La opción --informe-salida ARCHIVO escribe los listados en ARCHIVO en vez de la pantalla.
+ *        La opción --retencion N[:S] crea los sensores con historial acotado: las últimas N
+ *        lecturas y, con S, solo las de los últimos S segundos (HistorialCircular.h).
+ *        La opción --fragmentos N reparte los sensores entre N procesos locales, y
+ *        --fragmento-remoto HOST:PUERTO (repetible) suma un nodo lanzado con --nodo PUERTO;
+ *        cada ID va a un único fragmento, elegido por hashing consistente (GestorFragmentado.h).
+ * 
+ * Ejemplo con varias placas ESP32:
+ *   $ ./SistemaIoT /dev/ttyUSB0 /dev/ttyUSB1:115200 /dev/ttyACM0:9600
+ *   $ ./SistemaIoT --hilos /dev/ttyUSB0 /dev/ttyUSB1
+ *   $ ./SistemaIoT --trabajadores 8 /dev/ttyUSB0
+ *   $ ./SistemaIoT --binario /dev/ttyUSB0
+ *   $ ./SistemaIoT --datos /var/lib/sistemaiot /dev/ttyUSB0
+ *   $ ./SistemaIoT --metricas 10 --metricas-puerto 9464 /dev/ttyUSB0
+ *   $ ./SistemaIoT --informe 20 --informe-salida sensores.txt /dev/ttyUSB0
+ *   $ ./SistemaIoT --retencion 3600:600 --datos /var/lib/sistemaiot /dev/ttyUSB0
+ *   $ ./SistemaIoT --fragmentos 4 /dev/ttyUSB0
+ *   $ ./SistemaIoT --nodo 7000                       # en otra máquina
+ *   $ ./SistemaIoT --fragmentos 2 --fragmento-remoto 10.0.0.7:7000 /dev/ttyUSB0
  * 
  * FLUJO:
- * 1. Crear el gestor de sensores
- * 2. Configurar puerto serial
+ * 1. Configurar los puertos seriales y registrarlos en el reactor
+ * 2. Crear el gestor de sensores (con --fragmentos, los fragmentos)
  * 3. Bucle principal:
- *    - Leer datos del ESP32
+ *    - Esperar datos de cualquier ESP32 (un solo epoll)
  *    - Crear sensores dinámicamente
  *    - Acumular lecturas
  * 4. Procesar todos los sensores
  * 5. Limpiar memoria (automático por destructores)
  */
-int main() {
+int main(int argc, char* argv[]) {
+    // Toda la salida pasa por un buffer; los write() los hace otro hilo
+    SumideroAsincrono sumidero;
+
+    // Proceso hijo de --fragmentos: solo atiende a su frente (lanzarLocal)
+    if (argc == 5 && strcmp(argv[1], "--fragmento-fd") == 0) {
+        int hilosFragmento = atoi(argv[3]);
+        leerRetencion(argv[4], retencionSensores());  // "0:0" = sin límite
+        GestorSensores gestorFragmento;
+        PoolHilos* pool = hilosFragmento >= 0 ? new PoolHilos(hilosFragmento) : nullptr;
+        servirFragmento(atoi(argv[2]), gestorFragmento, pool);
+        delete pool;
+        return 0;
+    }
+
     std::cout << "=================================================" << std::endl;
     std::cout << "  Sistema IoT de Monitoreo Polimórfico v1.0" << std::endl;
     std::cout << "=================================================" << std::endl << std::endl;
     
-    // Crear gestor de sensores
-    GestorSensores gestor;
-    
-    // Configurar puerto serial
-    const char* puerto = "/dev/ttyUSB0";
-    int serialFd = configurarSerial(puerto, 115200);
+    // Configurar puertos seriales: todos alimentan al mismo gestor
+    ReactorSerial reactor;
+    char puertoPorDefecto[] = "/dev/ttyUSB0";
+    bool usarHilos = false;
+    bool binario = false;
+    int trabajadores = -1;  // -1 = procesar en el hilo principal
+    const char* directorioDatos = nullptr;
+    int segundosMetricas = 0;
+    int puertoMetricas = 0;
+    OpcionesInforme opcionesInforme;
+    const char* archivoInforme = nullptr;
+    GestorFragmentado fragmentado;
+    int fragmentosLocales = 0;
+    int puertoNodo = 0;
+    int puertosIndicados = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hilos") == 0) {
+            usarHilos = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--binario") == 0) {
+            binario = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--trabajadores") == 0 && i + 1 < argc) {
+            trabajadores = atoi(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--datos") == 0 && i + 1 < argc) {
+            directorioDatos = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--metricas") == 0 && i + 1 < argc) {
+            segundosMetricas = atoi(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--metricas-puerto") == 0 && i + 1 < argc) {
+            puertoMetricas = atoi(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--informe") == 0 && i + 1 < argc) {
+            const char* modo = argv[++i];
+            if (strcmp(modo, "resumen") == 0) {
+                opcionesInforme.soloResumen = true;
+            } else if (strcmp(modo, "completo") != 0) {
+                char* fin;
+                long maximo = strtol(modo, &fin, 10);
+                if (fin == modo || *fin != '\0' || maximo <= 0 || maximo > 2147483647L) {
+                    std::cout << "[Sistema] --informe espera completo, resumen o un número positivo; se lista todo\n";
+                } else {
+                    opcionesInforme.maximoLecturas = static_cast<int>(maximo);
+                }
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--retencion") == 0 && i + 1 < argc) {
+            if (!leerRetencion(argv[++i], retencionSensores())) {
+                std::cout << "[Sistema] --retencion espera LECTURAS[:SEGUNDOS] (enteros, LECTURAS > 0); se guarda todo\n";
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--informe-salida") == 0 && i + 1 < argc) {
+            archivoInforme = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--fragmentos") == 0 && i + 1 < argc) {
+            fragmentosLocales = atoi(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--fragmento-remoto") == 0 && i + 1 < argc) {
+            fragmentado.conectarRemoto(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--nodo") == 0 && i + 1 < argc) {
+            puertoNodo = atoi(argv[++i]);
+            continue;
+        }
+        int baudrate;
+        const char* puerto = separarPuerto(argv[i], baudrate);
+        int serialFd = configurarSerial(puerto, baudrate);
+        if (serialFd != -1) {
+            reactor.agregarPuerto(serialFd, puerto);
+        }
+        puertosIndicados++;
+    }
+
+    // Fragmento en otra máquina: no lee puertos, atiende al frente que se conecte
+    if (puertoNodo > 0) {
+        return servirNodo(puertoNodo, trabajadores);
+    }
+    for (int k = 0; k < fragmentosLocales; k++) {
+        fragmentado.lanzarLocal(trabajadores);
+    }
+
+    if (puertosIndicados == 0) {
+        int serialFd = configurarSerial(puertoPorDefecto, 115200);
+        if (serialFd != -1) {
+            reactor.agregarPuerto(serialFd, puertoPorDefecto);
+        }
+    }
     
-    if (serialFd == -1) {
+    // Antes de abrir --datos: la reproducción de la bitácora también se mide
+    ExportadorMetricas exportador;
+    bool conMetricas = segundosMetricas > 0 || puertoMetricas > 0;
+    if (conMetricas) {
+        exportador.iniciar(segundosMetricas, puertoMetricas);
+    }
+
+    // Con fragmentos este proceso es solo el frente: no guarda sensores
+    if (fragmentado.obtenerCantidad() > 0) {
+        if (usarHilos || directorioDatos != nullptr) {
+            std::cout << "[Fragmentos] --hilos y --datos no se usan con fragmentos "
+                      << "(cada fragmento guarda sus sensores en memoria)\n";
+        }
+        ejecutarFragmentado(reactor, fragmentado, binario, opcionesInforme, archivoInforme);
+        if (conMetricas) {
+            std::cout << "\n";
+            exportador.imprimirResumen();
+        }
+        std::cout << "\n[Sistema] Cerrando programa...\n";
+        return 0;
+    }
+
+    // Crear gestor de sensores (solo en un proceso; con fragmentos no se usa)
+    GestorSensores gestor;
+
+    // Arranque: se mapean los segmentos y se registran sus sensores, sin decodificar
+    Persistencia persistencia;
+    AlmacenSegmentos& almacen = persistencia.almacen;
+    if (directorioDatos != nullptr) {
+        long long inicioMs = relojMonotonicoMs();
+        int segmentos = almacen.abrir(directorioDatos);
+        if (segmentos >= 0) {
+            // Cada historial se decodifica recién cuando el gestor lo usa
+            gestor.usarFuenteHistorial(&almacen);
+            int restaurados = almacen.restaurar(gestor, crearSensorRestaurado);
+            std::cout << "[Almacen] " << segmentos << " segmento(s) abiertos, " << restaurados
+                      << " sensor(es) restaurados en " << (relojMonotonicoMs() - inicioMs) << " ms\n";
+
+            // Lo que la bitácora confirmó pero no llegó a los segmentos
+            LecturaParseada* nuevas = new LecturaParseada[BitacoraEscritura::LECTURAS_POR_REGISTRO];
+            ReproducirEnGestor reproducir = {gestor, almacen, nuevas};
+            persistencia.bitacora.marcaMinima(almacen.marcaMaxima());
+            long long reproducidas = persistencia.bitacora.abrir(directorioDatos, reproducir);
+            delete[] nuevas;
+
+            // Lo reproducido ya está en los segmentos: la bitácora vuelve a empezar
+            persistencia.puntoDeControl();
+            if (reproducidas > 0) {
+                std::cout << "[Bitacora] " << reproducidas << " lectura(s) reproducidas tras una caída\n";
+            }
+        }
+    }
+
+    bool modoDemo = reactor.puertosActivos() == 0;
+    if (modoDemo) {
         std::cout << "\n[Modo Demo] Ejecutando sin ESP32...\n";
         
-        // Crear sensores manualmente para demostración
-        SensorTemperatura* tempSensor = new SensorTemperatura("T-001");
-        SensorPresion* presSensor = new SensorPresion("P-105");
-        
-        gestor.agregarSensor(tempSensor);
-        gestor.agregarSensor(presSensor);
+        // Crear sensores manualmente para demostración (si --datos ya
+        // los restauró, las lecturas de ejemplo van a esos mismos)
+        SensorBase* tempSensor = gestor.buscarSensor("T-001");
+        if (tempSensor == nullptr) {
+            tempSensor = crearSensorDeTipo('T', "T-001");
+            gestor.agregarSensor(tempSensor);
+        }
+        SensorBase* presSensor = gestor.buscarSensor("P-105");
+        if (presSensor == nullptr) {
+            presSensor = crearSensorDeTipo('P', "P-105");
+            gestor.agregarSensor(presSensor);
+        }
         
         // Agregar lecturas de ejemplo
         tempSensor->agregarLectura("45.3");
@@ -253,35 +577,75 @@ int main() {
         presSensor->agregarLectura("1015");
         presSensor->agregarLectura("1012");
     } else {
-        std::cout << "\n[Modo Serial] Esperando datos del ESP32...\n";
+        std::cout << "\n[Modo Serial] Esperando datos de " << reactor.puertosActivos() << " ESP32...\n";
         std::cout << "Presiona Ctrl+C después de 30 segundos para procesar.\n\n";
+        if (binario) {
+            reactor.activarBinario();
+        }
         
-        char buffer[256];
-        time_t inicio = time(nullptr);
-        
-        // Leer durante 30 segundos
-        while (time(nullptr) - inicio < 30) {
-            if (leerLineaSerial(serialFd, buffer, 256)) {
-                std::cout << "[Serial] Recibido: " << buffer << "\n";
-                procesarLinea(buffer, gestor);
+        if (usarHilos) {
+            capturarConHilos(reactor, gestor, 30, binario, persistencia);
+        } else if (binario) {
+            time_t inicio = time(nullptr);
+
+            // Cada trama ya trae varias lecturas: van en lote al gestor
+            while (time(nullptr) - inicio < 30 && reactor.puertosActivos() > 0) {
+                reactor.atenderTramas(100, [&gestor, &persistencia](const LecturaParseada* lecturas, int cantidad) {
+                    gestor.agregarLecturas(lecturas, cantidad, crearSensorDeLectura);
+                    persistencia.guardar(lecturas, cantidad);
+                });
+            }
+        } else {
+            time_t inicio = time(nullptr);
+            
+            // Leer durante 30 segundos; epoll despierta en cuanto llegan datos
+            while (time(nullptr) - inicio < 30 && reactor.puertosActivos() > 0) {
+                reactor.atender(100, [&gestor, &persistencia](const char* linea, int largo) {
+                    std::cout << "[Serial] Recibido: " << linea << "\n";
+                    procesarLinea(linea, largo, gestor, persistencia);
+                });
             }
-            usleep(10000);  // Esperar 10ms entre lecturas
         }
-        
-        close(serialFd);
+        reactor.informarTramas();
+    }
+
+    if (almacen.activo()) {
+        persistencia.puntoDeControl();
+        persistencia.bitacora.informar();
+    }
+    if (!modoDemo) {
+        gestor.imprimirVentanas();
     }
     
+    // Los dos listados van al mismo archivo, uno detrás del otro
+    int fdInforme = abrirInforme(archivoInforme);
+
     // Mostrar todos los sensores registrados
     std::cout << "\n";
-    gestor.listarSensores();
+    listarSensores(gestor, opcionesInforme, fdInforme);
     
     // Ejecutar procesamiento polimórfico
     std::cout << "\n\n[Usuario] Ejecutar procesamiento polimórfico...\n";
-    gestor.procesarTodos();
+    if (trabajadores >= 0) {
+        PoolHilos pool(trabajadores);
+        gestor.procesarTodos(pool);
+    } else {
+        gestor.procesarTodos();
+    }
     
     // Mostrar estado final
     std::cout << "\n";
-    gestor.listarSensores();
+    listarSensores(gestor, opcionesInforme, fdInforme);
+    if (fdInforme >= 0) {
+        close(fdInforme);
+    }
+    // Cuánto del historial guardado hizo falta traer
+    almacen.informar();
+
+    if (conMetricas) {
+        std::cout << "\n";
+        exportador.imprimirResumen();
+    }
     
     std::cout << "\n[Sistema] Cerrando programa...\n";
     // El destructor de 'gestor' se llama automáticamente aquí